@@ -36,6 +36,7 @@ endif
 COMMON_SRC_FILES := \
 	Common/CPUID.cpp \
 	Common/Configurator.cpp \
+	Common/Convert.cpp \
 	Common/DebugAndroid.cpp \
 	Common/GrallocAndroid.cpp \
 	Common/Half.cpp \
@@ -44,7 +45,8 @@ COMMON_SRC_FILES := \
 	Common/Resource.cpp \
 	Common/Socket.cpp \
 	Common/Thread.cpp \
-	Common/Timer.cpp
+	Common/Timer.cpp \
+	Common/WorkerPool.cpp
 
 COMMON_SRC_FILES += \
 	Main/Config.cpp \
@@ -79,6 +81,7 @@ COMMON_SRC_FILES += \
 	Renderer/Renderer.cpp \
 	Renderer/Sampler.cpp \
 	Renderer/SetupProcessor.cpp \
+	Renderer/ShaderSpecialization.cpp \
 	Renderer/Surface.cpp \
 	Renderer/TextureStage.cpp \
 	Renderer/Vector.cpp \
@@ -36,6 +36,7 @@ namespace sw
 	bool CPUID::SSE3 = detectSSE3();
 	bool CPUID::SSSE3 = detectSSSE3();
 	bool CPUID::SSE4_1 = detectSSE4_1();
+	bool CPUID::F16C = detectF16C();
 	int CPUID::cores = detectCoreCount();
 	int CPUID::affinity = detectAffinity();
 
@@ -46,6 +47,7 @@ namespace sw
 	bool CPUID::enableSSE3 = true;
 	bool CPUID::enableSSSE3 = true;
 	bool CPUID::enableSSE4_1 = true;
+	bool CPUID::enableF16C = true;
 
 	void CPUID::setEnableMMX(bool enable)
 	{
@@ -58,6 +60,7 @@ namespace sw
 			enableSSE3 = false;
 			enableSSSE3 = false;
 			enableSSE4_1 = false;
+			enableF16C = false;
 		}
 	}
 
@@ -72,6 +75,7 @@ namespace sw
 			enableSSE3 = false;
 			enableSSSE3 = false;
 			enableSSE4_1 = false;
+			enableF16C = false;
 		}
 	}
 
@@ -90,6 +94,7 @@ namespace sw
 			enableSSE3 = false;
 			enableSSSE3 = false;
 			enableSSE4_1 = false;
+			enableF16C = false;
 		}
 	}
 
@@ -108,6 +113,7 @@ namespace sw
 			enableSSE3 = false;
 			enableSSSE3 = false;
 			enableSSE4_1 = false;
+			enableF16C = false;
 		}
 	}
 
@@ -162,6 +168,19 @@ namespace sw
 		}
 	}
 
+	void CPUID::setEnableF16C(bool enable)
+	{
+		enableF16C = enable;
+
+		if(enableF16C)
+		{
+			enableMMX = true;
+			enableCMOV = true;
+			enableSSE = true;
+			enableSSE2 = true;
+		}
+	}
+
 	static void cpuid(int registers[4], int info)
 	{
 		#if defined(__i386__) || defined(__x86_64__)
@@ -178,6 +197,21 @@ namespace sw
 		#endif
 	}
 
+	static unsigned long long xgetbv()   // Extended control register 0, requires OSXSAVE
+	{
+		#if defined(__i386__) || defined(__x86_64__)
+			#if defined(_WIN32)
+				return _xgetbv(0);
+			#else
+				unsigned int eax, edx;
+				__asm volatile("xgetbv": "=a" (eax), "=d" (edx): "c" (0));
+				return ((unsigned long long)edx << 32) | eax;
+			#endif
+		#else
+			return 0;
+		#endif
+	}
+
 	bool CPUID::detectMMX()
 	{
 		int registers[4];
@@ -227,6 +261,18 @@ namespace sw
 		return SSE4_1 = (registers[2] & 0x00080000) != 0;
 	}
 
+	bool CPUID::detectF16C()
+	{
+		int registers[4];
+		cpuid(registers, 1);
+
+		bool OSXSAVE = (registers[2] & 0x08000000) != 0;
+		bool AVX = (registers[2] & 0x10000000) != 0;
+
+		// The VEX encoded instructions also need the OS to save the YMM state
+		return F16C = (registers[2] & 0x20000000) != 0 && AVX && OSXSAVE && (xgetbv() & 0x6) == 0x6;
+	}
+
 	int CPUID::detectCoreCount()
 	{
 		int cores = 0;
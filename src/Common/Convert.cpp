@@ -0,0 +1,311 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Convert.hpp"
+
+#include "CPUID.hpp"
+
+#include <string.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+	#include <emmintrin.h>
+#endif
+
+namespace
+{
+	#if defined(__i386__) || defined(__x86_64__)
+		// Scales 16-bit lanes of 5-bit values to the nearest 8-bit value, like c * 255 / 31 rounded
+		inline __m128i expand5(__m128i c)
+		{
+			return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c, _mm_set1_epi16(2106)), _mm_set1_epi16(0x80)), 8);
+		}
+
+		inline __m128i replicate5(__m128i c)
+		{
+			return _mm_or_si128(_mm_slli_epi16(c, 3), _mm_srli_epi16(c, 2));
+		}
+
+		inline __m128i expand4(__m128i c)
+		{
+			return _mm_or_si128(_mm_slli_epi16(c, 4), c);
+		}
+
+		inline __m128i field(__m128i x, int shift, int mask)
+		{
+			return _mm_and_si128(_mm_srli_epi16(x, shift), _mm_set1_epi16(mask));
+		}
+	#endif
+
+	// Each format provides the scalar conversion of a pixel, and the SSE2 one
+	// of eight pixels to 16-bit lanes of their 8-bit channels
+	struct X1R5G5B5
+	{
+		static unsigned int unpack(unsigned int xrgb)
+		{
+			unsigned int r = (((xrgb & 0x7C00) * 134771 + 0x800000) >> 8) & 0x00FF0000;
+			unsigned int g = (((xrgb & 0x03E0) * 16846 + 0x8000) >> 8) & 0x0000FF00;
+			unsigned int b = (((xrgb & 0x001F) * 2106  + 0x80) >> 8);
+
+			return 0xFF000000 | r | g | b;
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			static void unpack(__m128i x, __m128i &b, __m128i &g, __m128i &r, __m128i &a)
+			{
+				b = expand5(field(x, 0, 0x1F));
+				g = expand5(field(x, 5, 0x1F));
+				r = expand5(field(x, 10, 0x1F));
+				a = _mm_set1_epi16(0xFF);
+			}
+		#endif
+	};
+
+	struct A1R5G5B5
+	{
+		static unsigned int unpack(unsigned int argb)
+		{
+			unsigned int a =   (argb & 0x8000) * 130560;
+			unsigned int r = (((argb & 0x7C00) * 134771 + 0x800000) >> 8) & 0x00FF0000;
+			unsigned int g = (((argb & 0x03E0) * 16846  + 0x8000) >> 8) & 0x0000FF00;
+			unsigned int b = (((argb & 0x001F) * 2106   + 0x80) >> 8);
+
+			return a | r | g | b;
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			static void unpack(__m128i x, __m128i &b, __m128i &g, __m128i &r, __m128i &a)
+			{
+				b = expand5(field(x, 0, 0x1F));
+				g = expand5(field(x, 5, 0x1F));
+				r = expand5(field(x, 10, 0x1F));
+				a = _mm_and_si128(_mm_srai_epi16(x, 15), _mm_set1_epi16(0xFF));
+			}
+		#endif
+	};
+
+	struct X4R4G4B4
+	{
+		static unsigned int unpack(unsigned int xrgb)
+		{
+			unsigned int r = ((xrgb & 0x0F00) * 0x00001100) & 0x00FF0000;
+			unsigned int g = ((xrgb & 0x00F0) * 0x00000110) & 0x0000FF00;
+			unsigned int b =  (xrgb & 0x000F) * 0x00000011;
+
+			return 0xFF000000 | r | g | b;
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			static void unpack(__m128i x, __m128i &b, __m128i &g, __m128i &r, __m128i &a)
+			{
+				b = expand4(field(x, 0, 0xF));
+				g = expand4(field(x, 4, 0xF));
+				r = expand4(field(x, 8, 0xF));
+				a = _mm_set1_epi16(0xFF);
+			}
+		#endif
+	};
+
+	struct A4R4G4B4
+	{
+		static unsigned int unpack(unsigned int argb)
+		{
+			unsigned int a = ((argb & 0xF000) * 0x00011000) & 0xFF000000;
+			unsigned int r = ((argb & 0x0F00) * 0x00001100) & 0x00FF0000;
+			unsigned int g = ((argb & 0x00F0) * 0x00000110) & 0x0000FF00;
+			unsigned int b =  (argb & 0x000F) * 0x00000011;
+
+			return a | r | g | b;
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			static void unpack(__m128i x, __m128i &b, __m128i &g, __m128i &r, __m128i &a)
+			{
+				b = expand4(field(x, 0, 0xF));
+				g = expand4(field(x, 4, 0xF));
+				r = expand4(field(x, 8, 0xF));
+				a = expand4(_mm_srli_epi16(x, 12));
+			}
+		#endif
+	};
+
+	struct R4G4B4A4
+	{
+		static unsigned int unpack(unsigned int rgba)
+		{
+			return A4R4G4B4::unpack(((rgba >> 4) | (rgba << 12)) & 0xFFFF);
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			static void unpack(__m128i x, __m128i &b, __m128i &g, __m128i &r, __m128i &a)
+			{
+				a = expand4(field(x, 0, 0xF));
+				b = expand4(field(x, 4, 0xF));
+				g = expand4(field(x, 8, 0xF));
+				r = expand4(_mm_srli_epi16(x, 12));
+			}
+		#endif
+	};
+
+	struct R5G5B5A1
+	{
+		static unsigned int unpack(unsigned int rgba)
+		{
+			unsigned int r = ((rgba & 0xF800) >> 8) | ((rgba & 0xF800) >> 13);
+			unsigned int g = ((rgba & 0x07C0) >> 3) | ((rgba & 0x07C0) >> 8);
+			unsigned int b = ((rgba & 0x003E) << 2) | ((rgba & 0x003E) >> 3);
+			unsigned int a = (rgba & 0x0001) ? 0xFF : 0;
+
+			return (a << 24) | (r << 16) | (g << 8) | b;
+		}
+
+		#if defined(__i386__) || defined(__x86_64__)
+			static void unpack(__m128i x, __m128i &b, __m128i &g, __m128i &r, __m128i &a)
+			{
+				b = replicate5(field(x, 1, 0x1F));
+				g = replicate5(field(x, 6, 0x1F));
+				r = replicate5(_mm_srli_epi16(x, 11));
+				a = _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(x, _mm_set1_epi16(1))), _mm_set1_epi16(0xFF));
+			}
+		#endif
+	};
+
+	template<class Format>
+	void unpack16(void *destination, const void *source, size_t count)
+	{
+		const unsigned short *s = (const unsigned short*)source;
+		unsigned int *d = (unsigned int*)destination;
+		size_t i = 0;
+
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				for(; i + 8 <= count; i += 8)
+				{
+					__m128i b, g, r, a;
+					Format::unpack(_mm_loadu_si128((const __m128i*)(s + i)), b, g, r, a);
+
+					__m128i gb = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+					__m128i ar = _mm_or_si128(r, _mm_slli_epi16(a, 8));
+
+					_mm_storeu_si128((__m128i*)(d + i + 0), _mm_unpacklo_epi16(gb, ar));
+					_mm_storeu_si128((__m128i*)(d + i + 4), _mm_unpackhi_epi16(gb, ar));
+				}
+			}
+		#endif
+
+		for(; i < count; i++)
+		{
+			d[i] = Format::unpack(s[i]);
+		}
+	}
+}
+
+namespace sw
+{
+	void unpackR8G8B8(void *destination, const void *source, size_t count)
+	{
+		const unsigned char *s = (const unsigned char*)source;
+		unsigned int *d = (unsigned int*)destination;
+		size_t i = 0;
+
+		// Four pixels from three 32-bit words
+		for(; i + 4 <= count; i += 4)
+		{
+			unsigned int w[3];
+			memcpy(w, s + 3 * i, sizeof(w));
+
+			d[i + 0] = 0xFF000000 | w[0];
+			d[i + 1] = 0xFF000000 | (w[0] >> 24) | (w[1] << 8);
+			d[i + 2] = 0xFF000000 | (w[1] >> 16) | (w[2] << 16);
+			d[i + 3] = 0xFF000000 | (w[2] >> 8);
+		}
+
+		for(; i < count; i++)
+		{
+			unsigned int b = s[3 * i + 0];
+			unsigned int g = s[3 * i + 1];
+			unsigned int r = s[3 * i + 2];
+
+			d[i] = 0xFF000000 | (r << 16) | (g << 8) | (b << 0);
+		}
+	}
+
+	void unpackX1R5G5B5(void *destination, const void *source, size_t count)
+	{
+		unpack16<X1R5G5B5>(destination, source, count);
+	}
+
+	void unpackA1R5G5B5(void *destination, const void *source, size_t count)
+	{
+		unpack16<A1R5G5B5>(destination, source, count);
+	}
+
+	void unpackX4R4G4B4(void *destination, const void *source, size_t count)
+	{
+		unpack16<X4R4G4B4>(destination, source, count);
+	}
+
+	void unpackA4R4G4B4(void *destination, const void *source, size_t count)
+	{
+		unpack16<A4R4G4B4>(destination, source, count);
+	}
+
+	void unpackR4G4B4A4(void *destination, const void *source, size_t count)
+	{
+		unpack16<R4G4B4A4>(destination, source, count);
+	}
+
+	void unpackR5G5B5A1(void *destination, const void *source, size_t count)
+	{
+		unpack16<R5G5B5A1>(destination, source, count);
+	}
+
+	void unpackP8(void *destination, const void *source, const unsigned int *palette, size_t count)
+	{
+		const unsigned char *s = (const unsigned char*)source;
+		unsigned int *d = (unsigned int*)destination;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			d[i] = palette[s[i]];
+		}
+	}
+
+	void expandRGB16(void *destination, const void *source, unsigned short alpha, size_t count)
+	{
+		const unsigned char *s = (const unsigned char*)source;
+		unsigned int *d = (unsigned int*)destination;
+		unsigned int a = (unsigned int)alpha << 16;
+		size_t i = 0;
+
+		// Two pixels from three 32-bit words
+		for(; i + 2 <= count; i += 2)
+		{
+			unsigned int w[3];
+			memcpy(w, s + 6 * i, sizeof(w));
+
+			d[2 * i + 0] = w[0];
+			d[2 * i + 1] = (w[1] & 0xFFFF) | a;
+			d[2 * i + 2] = (w[1] >> 16) | (w[2] << 16);
+			d[2 * i + 3] = (w[2] >> 16) | a;
+		}
+
+		if(i < count)
+		{
+			unsigned short *d16 = (unsigned short*)(d + 2 * i);
+			memcpy(d16, s + 6 * i, 6);
+			d16[3] = alpha;
+		}
+	}
+}
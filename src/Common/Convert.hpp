@@ -0,0 +1,38 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Convert_hpp
+#define sw_Convert_hpp
+
+#include <stddef.h>
+
+namespace sw
+{
+	// Conversions of a row of count pixels in a packed format to A8R8G8B8, using SSE2 when supported.
+	// The D3D style 5-bit formats round to the nearest 8-bit value, while OpenGL's
+	// UNSIGNED_SHORT_5_5_5_1 replicates the high bits into the low ones.
+	void unpackR8G8B8(void *destination, const void *source, size_t count);
+	void unpackX1R5G5B5(void *destination, const void *source, size_t count);
+	void unpackA1R5G5B5(void *destination, const void *source, size_t count);
+	void unpackX4R4G4B4(void *destination, const void *source, size_t count);
+	void unpackA4R4G4B4(void *destination, const void *source, size_t count);
+	void unpackR4G4B4A4(void *destination, const void *source, size_t count);   // OpenGL's UNSIGNED_SHORT_4_4_4_4
+	void unpackR5G5B5A1(void *destination, const void *source, size_t count);   // OpenGL's UNSIGNED_SHORT_5_5_5_1
+	void unpackP8(void *destination, const void *source, const unsigned int *palette, size_t count);   // Palette already in A8R8G8B8
+
+	// Expands three 16-bit channels per pixel to four, with the given fourth channel
+	void expandRGB16(void *destination, const void *source, unsigned short alpha, size_t count);
+}
+
+#endif   // sw_Convert_hpp
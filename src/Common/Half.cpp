@@ -14,75 +14,93 @@
 
 #include "Half.hpp"
 
+#include "CPUID.hpp"
+
+#include <string.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+	#include <immintrin.h>
+
+	#if defined(_MSC_VER)
+		#define F16C_TARGET
+	#else
+		#define F16C_TARGET __attribute__((target("f16c")))
+	#endif
+#endif
+
 namespace sw
 {
-	half::half(float fp32)
+	static inline unsigned short toHalf(float fp32)
 	{
-		unsigned int fp32i = *(unsigned int*)&fp32;
+		unsigned int fp32i;
+		memcpy(&fp32i, &fp32, sizeof(fp32i));
 		unsigned int sign = (fp32i & 0x80000000) >> 16;
 		unsigned int abs = fp32i & 0x7FFFFFFF;
 
-		if(abs > 0x47FFEFFF)   // Infinity
+		if(abs > 0x477FFFFF)   // Infinity, NaN, or too large
 		{
-			fp16i = sign | 0x7FFF;
+			// NaNs stay quiet NaNs with the upper mantissa bits, like F16C does
+			unsigned int nan = (abs > 0x7F800000) ? 0x0200 | ((abs >> 13) & 0x03FF) : 0;
+
+			return sign | 0x7C00 | nan;
 		}
 		else if(abs < 0x38800000)   // Denormal
 		{
-			unsigned int mantissa = (abs & 0x007FFFFF) | 0x00800000;
-			int e = 113 - (abs >> 23);
+			// Adding 0.5 aligns the mantissa's LSB with 2^-24, so the addition rounds it to nearest even
+			float f;
+			memcpy(&f, &abs, sizeof(f));
+			f += 0.5f;
 
-			if(e < 24)
-			{
-				abs = mantissa >> e;
-			}
-			else
-			{
-				abs = 0;
-			}
+			unsigned int fi;
+			memcpy(&fi, &f, sizeof(fi));
 
-			fp16i = sign | (abs + 0x00000FFF + ((abs >> 13) & 1)) >> 13;
+			return sign | (fi - 0x3F000000);
 		}
 		else
 		{
-			fp16i = sign | (abs + 0xC8000000 + 0x00000FFF + ((abs >> 13) & 1)) >> 13;
+			return sign | (abs + 0xC8000000 + 0x00000FFF + ((abs >> 13) & 1)) >> 13;
 		}
 	}
 
-	half::operator float() const
+	static inline float toFloat(unsigned short fp16i)
 	{
+		unsigned int sign = (fp16i & 0x8000) << 16;
+		unsigned int abs = fp16i & 0x7FFF;
 		unsigned int fp32i;
 
-		int s = (fp16i >> 15) & 0x00000001;
-		int e = (fp16i >> 10) & 0x0000001F;
-		int m =  fp16i        & 0x000003FF;
+		if(abs > 0x7BFF)   // Infinity or NaN, which gets quieted
+		{
+			unsigned int nan = (abs > 0x7C00) ? 0x00400000 : 0;
 
-		if(e == 0)
+			fp32i = 0x7F800000 | nan | ((abs & 0x03FF) << 13);
+		}
+		else if(abs < 0x0400)   // Denormal, normalized by the float conversion
 		{
-			if(m == 0)
-			{
-				fp32i = s << 31;
+			float f = (float)(int)abs * (1.0f / 16777216.0f);
 
-				return (float&)fp32i;
-			}
-			else
-			{
-				while(!(m & 0x00000400))
-				{
-					m <<= 1;
-					e -=  1;
-				}
-
-				e += 1;
-				m &= ~0x00000400;
-			}
+			memcpy(&fp32i, &f, sizeof(fp32i));
+		}
+		else
+		{
+			fp32i = (abs << 13) + 0x38000000;
 		}
 
-		e = e + (127 - 15);
-		m = m << 13;
+		fp32i |= sign;
+
+		float fp32;
+		memcpy(&fp32, &fp32i, sizeof(fp32));
+
+		return fp32;
+	}
 
-		fp32i = (s << 31) | (e << 23) | m;
+	half::half(float fp32)
+	{
+		fp16i = toHalf(fp32);
+	}
 
-		return (float&)fp32i;
+	half::operator float() const
+	{
+		return toFloat(fp16i);
 	}
 
 	half &half::operator=(half h)
@@ -99,4 +117,149 @@ namespace sw
 
 		return *this;
 	}
+
+	#if defined(__i386__) || defined(__x86_64__)
+		// Same arithmetic as toFloat(), on four halves zero-extended to 32-bit
+		static inline __m128 toFloat4(__m128i h)
+		{
+			__m128i abs = _mm_and_si128(h, _mm_set1_epi32(0x7FFF));
+			__m128i sign = _mm_slli_epi32(_mm_xor_si128(h, abs), 16);
+
+			__m128i infNaN = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x7BFF));
+			__m128i nan = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x7C00));
+			__m128i normal = _mm_add_epi32(_mm_slli_epi32(abs, 13), _mm_set1_epi32(0x38000000));
+			normal = _mm_or_si128(normal, _mm_and_si128(infNaN, _mm_set1_epi32(0x7F800000)));
+			normal = _mm_or_si128(normal, _mm_and_si128(nan, _mm_set1_epi32(0x00400000)));
+
+			__m128i denormal = _mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(abs), _mm_set1_ps(1.0f / 16777216.0f)));
+			__m128i isDenormal = _mm_cmplt_epi32(abs, _mm_set1_epi32(0x0400));
+			__m128i fp32i = _mm_or_si128(_mm_and_si128(isDenormal, denormal), _mm_andnot_si128(isDenormal, normal));
+
+			return _mm_castsi128_ps(_mm_or_si128(fp32i, sign));
+		}
+
+		// Same arithmetic as toHalf(), producing four halves zero-extended to 32-bit
+		static inline __m128i toHalf4(__m128 f)
+		{
+			__m128i fp32i = _mm_castps_si128(f);
+			__m128i abs = _mm_and_si128(fp32i, _mm_set1_epi32(0x7FFFFFFF));
+			__m128i sign = _mm_srli_epi32(_mm_xor_si128(fp32i, abs), 16);
+
+			__m128i odd = _mm_and_si128(_mm_srli_epi32(abs, 13), _mm_set1_epi32(1));
+			__m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(abs, _mm_set1_epi32(0xC8000FFF)), odd), 13);
+
+			__m128i denormal = _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(abs), _mm_set1_ps(0.5f)));
+			denormal = _mm_sub_epi32(denormal, _mm_set1_epi32(0x3F000000));
+			__m128i isDenormal = _mm_cmplt_epi32(abs, _mm_set1_epi32(0x38800000));
+			__m128i fp16i = _mm_or_si128(_mm_and_si128(isDenormal, denormal), _mm_andnot_si128(isDenormal, normal));
+
+			__m128i infNaN = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x477FFFFF));
+			__m128i nan = _mm_cmpgt_epi32(abs, _mm_set1_epi32(0x7F800000));
+			__m128i special = _mm_and_si128(nan, _mm_or_si128(_mm_set1_epi32(0x0200), _mm_and_si128(_mm_srli_epi32(abs, 13), _mm_set1_epi32(0x03FF))));
+			special = _mm_or_si128(special, _mm_set1_epi32(0x7C00));
+			fp16i = _mm_or_si128(_mm_and_si128(infNaN, special), _mm_andnot_si128(infNaN, fp16i));
+
+			return _mm_or_si128(fp16i, sign);
+		}
+
+		static size_t halfToFloatSSE2(float *destination, const unsigned short *source, size_t count)
+		{
+			size_t i = 0;
+
+			for(; i + 8 <= count; i += 8)
+			{
+				__m128i h = _mm_loadu_si128((const __m128i*)(source + i));
+
+				_mm_storeu_ps(destination + i + 0, toFloat4(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+				_mm_storeu_ps(destination + i + 4, toFloat4(_mm_unpackhi_epi16(h, _mm_setzero_si128())));
+			}
+
+			return i;
+		}
+
+		static size_t floatToHalfSSE2(unsigned short *destination, const float *source, size_t count)
+		{
+			size_t i = 0;
+
+			for(; i + 8 <= count; i += 8)
+			{
+				__m128i h0 = toHalf4(_mm_loadu_ps(source + i + 0));
+				__m128i h1 = toHalf4(_mm_loadu_ps(source + i + 4));
+
+				// Sign-extend so the saturating pack leaves the 16-bit values intact
+				h0 = _mm_srai_epi32(_mm_slli_epi32(h0, 16), 16);
+				h1 = _mm_srai_epi32(_mm_slli_epi32(h1, 16), 16);
+
+				_mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(h0, h1));
+			}
+
+			return i;
+		}
+
+		F16C_TARGET static size_t halfToFloatF16C(float *destination, const unsigned short *source, size_t count)
+		{
+			size_t i = 0;
+
+			for(; i + 8 <= count; i += 8)
+			{
+				_mm256_storeu_ps(destination + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(source + i))));
+			}
+
+			return i;
+		}
+
+		F16C_TARGET static size_t floatToHalfF16C(unsigned short *destination, const float *source, size_t count)
+		{
+			size_t i = 0;
+
+			for(; i + 8 <= count; i += 8)
+			{
+				_mm_storeu_si128((__m128i*)(destination + i), _mm256_cvtps_ph(_mm256_loadu_ps(source + i), 0));   // Round to nearest even
+			}
+
+			return i;
+		}
+	#endif
+
+	void halfToFloat(float *destination, const unsigned short *source, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(__i386__) || defined(__x86_64__)
+			if(CPUID::supportsF16C())
+			{
+				i = halfToFloatF16C(destination, source, count);
+			}
+			else if(CPUID::supportsSSE2())
+			{
+				i = halfToFloatSSE2(destination, source, count);
+			}
+		#endif
+
+		for(; i < count; i++)
+		{
+			destination[i] = toFloat(source[i]);
+		}
+	}
+
+	void floatToHalf(unsigned short *destination, const float *source, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(__i386__) || defined(__x86_64__)
+			if(CPUID::supportsF16C())
+			{
+				i = floatToHalfF16C(destination, source, count);
+			}
+			else if(CPUID::supportsSSE2())
+			{
+				i = floatToHalfSSE2(destination, source, count);
+			}
+		#endif
+
+		for(; i < count; i++)
+		{
+			destination[i] = toHalf(source[i]);
+		}
+	}
 }
@@ -15,8 +15,11 @@
 #ifndef sw_Half_hpp
 #define sw_Half_hpp
 
+#include <stddef.h>
+
 namespace sw
 {
+	// IEEE 754 half-precision float, with round-to-nearest-even conversion from float
 	class half
 	{
 	public:
@@ -30,6 +33,10 @@ namespace sw
 	private:
 		unsigned short fp16i;
 	};
+
+	// Convert arrays of half-precision floats, with the same results as sw::half but using F16C or SSE2 when supported
+	void halfToFloat(float *destination, const unsigned short *source, size_t count);
+	void floatToHalf(unsigned short *destination, const float *source, size_t count);
 }
 
 #endif   // sw_Half_hpp
@@ -159,4 +159,55 @@ void clear(uint32_t *memory, uint32_t element, size_t count)
 		}
 	#endif
 }
+
+template<size_t size>
+static void copy(uint8_t *destination, const uint8_t *source, size_t stride, size_t count)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		memcpy(destination, source, size);   // Constant size, compiles to a few moves
+		destination += size;
+		source += stride;
+	}
+}
+
+void copy(void *destination, const void *source, size_t size, size_t stride, size_t count)
+{
+	uint8_t *dst = static_cast<uint8_t*>(destination);
+	const uint8_t *src = static_cast<const uint8_t*>(source);
+
+	if(stride == size)
+	{
+		memcpy(dst, src, size * count);
+		return;
+	}
+
+	switch(size)
+	{
+	case 1:  copy<1>(dst, src, stride, count);  break;
+	case 2:  copy<2>(dst, src, stride, count);  break;
+	case 3:  copy<3>(dst, src, stride, count);  break;
+	case 4:  copy<4>(dst, src, stride, count);  break;
+	case 6:  copy<6>(dst, src, stride, count);  break;
+	case 8:  copy<8>(dst, src, stride, count);  break;
+	case 12: copy<12>(dst, src, stride, count); break;
+	case 16: copy<16>(dst, src, stride, count); break;
+	default:
+		for(size_t i = 0; i < count; i++)
+		{
+			memcpy(dst, src, size);
+			dst += size;
+			src += stride;
+		}
+	}
+}
+
+void storeFence()
+{
+	#if defined(_MSC_VER) && defined(__x86__)
+		_mm_sfence();
+	#elif defined(__GNUC__) && defined(__x86__)
+		__asm__ __volatile__("sfence" : : : "memory");
+	#endif
+}
 }
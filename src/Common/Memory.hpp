@@ -31,6 +31,9 @@ void deallocateExecutable(void *memory, size_t bytes);
 
 void clear(uint16_t *memory, uint16_t element, size_t count);
 void clear(uint32_t *memory, uint32_t element, size_t count);
+void copy(void *destination, const void *source, size_t size, size_t stride, size_t count);   // Packs count elements of size bytes, stride bytes apart
+
+void storeFence();   // Orders preceding non-temporal stores before any later stores
 }
 
 #endif   // Memory_hpp
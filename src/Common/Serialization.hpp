@@ -0,0 +1,139 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Serialization_hpp
+#define sw_Serialization_hpp
+
+#include <string>
+#include <vector>
+#include <string.h>
+
+namespace sw
+{
+	// Appends plain data to a byte array. Only meant for data read back by the same build.
+	class Serializer
+	{
+	public:
+		explicit Serializer(std::vector<unsigned char> &buffer) : buffer(buffer)
+		{
+		}
+
+		template<class T>
+		void write(const T &value)   // T must be trivially copyable
+		{
+			write(&value, sizeof(T));
+		}
+
+		void write(const std::string &string)
+		{
+			write(static_cast<unsigned int>(string.size()));
+			write(string.data(), string.size());
+		}
+
+		void write(const void *data, size_t size)
+		{
+			const unsigned char *bytes = static_cast<const unsigned char*>(data);
+			buffer.insert(buffer.end(), bytes, bytes + size);
+		}
+
+	private:
+		std::vector<unsigned char> &buffer;
+	};
+
+	// Reads back data written by a Serializer. Reading past the end zero-fills
+	// the output and flags the stream as failed.
+	class Deserializer
+	{
+	public:
+		Deserializer(const void *data, size_t size) : data(static_cast<const unsigned char*>(data)), size(size), position(0), error(false)
+		{
+		}
+
+		template<class T>
+		bool read(T &value)
+		{
+			return read(&value, sizeof(T));
+		}
+
+		bool read(bool &value)   // Anything but 0 or 1 is not a bool written by a Serializer
+		{
+			unsigned char byte = 0;
+
+			if(!read(&byte, sizeof(byte)) || byte > 1)
+			{
+				value = false;
+				error = true;
+				return false;
+			}
+
+			value = (byte != 0);
+
+			return true;
+		}
+
+		bool read(std::string &string)
+		{
+			unsigned int length = 0;
+
+			if(!read(length) || length > remaining())
+			{
+				error = true;
+				return false;
+			}
+
+			string.assign(reinterpret_cast<const char*>(data + position), length);
+			position += length;
+
+			return true;
+		}
+
+		bool read(void *output, size_t bytes)
+		{
+			if(error || bytes > remaining())
+			{
+				memset(output, 0, bytes);
+				error = true;
+				return false;
+			}
+
+			memcpy(output, data + position, bytes);
+			position += bytes;
+
+			return true;
+		}
+
+		size_t remaining() const
+		{
+			return size - position;
+		}
+
+		bool failed() const
+		{
+			return error;
+		}
+
+		void fail()
+		{
+			error = true;
+		}
+
+	private:
+		const unsigned char *const data;
+		const size_t size;
+		size_t position;
+		bool error;
+	};
+}
+
+#endif   // sw_Serialization_hpp
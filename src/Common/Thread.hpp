@@ -210,6 +210,15 @@ namespace sw
 			return ret;
 		#endif
 	}
+
+	inline int64_t atomicAdd(volatile int64_t *target, int64_t value)
+	{
+		#if defined(_WIN32)
+			return InterlockedExchangeAdd64(target, value) + value;
+		#else
+			return __sync_add_and_fetch(target, value);
+		#endif
+	}
 	#endif
 
 	inline int atomicExchange(volatile int *target, int value)
@@ -30,6 +30,7 @@
 	#include <intrin.h>
 #else
 	#include <sys/time.h>
+	#include <time.h>
 	#if defined(__i386__) || defined(__x86_64__)
 		#include <x86intrin.h>
 	#endif
@@ -76,9 +77,9 @@ namespace sw
 			QueryPerformanceCounter((LARGE_INTEGER*)&counter);
 			return counter;
 		#else
-			timeval t;
-			gettimeofday(&t, 0);
-			return t.tv_sec * 1000000 + t.tv_usec;
+			timespec t;
+			clock_gettime(CLOCK_MONOTONIC, &t);
+			return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
 		#endif
 	}
 
@@ -89,7 +90,7 @@ namespace sw
 			QueryPerformanceFrequency((LARGE_INTEGER*)&frequency);
 			return frequency;
 		#else
-			return 1000000;   // gettimeofday uses microsecond resolution
+			return 1000000000;   // clock_gettime uses nanosecond resolution
 		#endif
 	}
 }
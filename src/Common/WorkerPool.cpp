@@ -0,0 +1,158 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "WorkerPool.hpp"
+
+#include "CPUID.hpp"
+
+#include <algorithm>
+
+namespace sw
+{
+	Task::Task(const std::function<void()> &function) : function(function), state(PENDING)
+	{
+	}
+
+	void Task::wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if(state == PENDING)
+		{
+			execute(lock);
+		}
+
+		done.wait(lock, [this]() { return state == DONE; });
+	}
+
+	bool Task::isDone()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		return state == DONE;
+	}
+
+	void Task::execute(std::unique_lock<std::mutex> &lock)
+	{
+		state = RUNNING;
+		lock.unlock();
+
+		function();
+		function = nullptr;   // Release captured state
+
+		lock.lock();
+		state = DONE;
+		done.notify_all();
+	}
+
+	WorkerPool::WorkerPool() : maxThreadCount(getDefaultThreadCount()), exit(false)
+	{
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			exit = true;
+			queued.notify_all();
+		}
+
+		for(Thread *worker : workers)
+		{
+			worker->join();
+			delete worker;
+		}
+	}
+
+	std::shared_ptr<Task> WorkerPool::enqueue(const std::function<void()> &function)
+	{
+		std::shared_ptr<Task> task = std::make_shared<Task>(function);
+
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if(maxThreadCount == 0)
+		{
+			lock.unlock();
+			task->wait();
+
+			return task;
+		}
+
+		// Threads are only started once there's work for them
+		while(workers.size() < maxThreadCount)
+		{
+			workers.push_back(new Thread(threadFunction, this));
+		}
+
+		queue.push_back(task);
+		queued.notify_one();
+
+		return task;
+	}
+
+	void WorkerPool::setMaxThreadCount(unsigned int count)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		maxThreadCount = std::min(count, getDefaultThreadCount());
+	}
+
+	unsigned int WorkerPool::getMaxThreadCount()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		return maxThreadCount;
+	}
+
+	unsigned int WorkerPool::getDefaultThreadCount()
+	{
+		return std::max(CPUID::processAffinity(), 1);
+	}
+
+	void WorkerPool::threadFunction(void *parameters)
+	{
+		static_cast<WorkerPool*>(parameters)->workerLoop();
+	}
+
+	void WorkerPool::workerLoop()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		while(true)
+		{
+			queued.wait(lock, [this]() { return exit || !queue.empty(); });
+
+			if(queue.empty())
+			{
+				return;   // Exit only once all queued tasks are completed
+			}
+
+			std::shared_ptr<Task> task = queue.front();
+			queue.pop_front();
+			lock.unlock();
+
+			std::unique_lock<std::mutex> taskLock(task->mutex);
+
+			if(task->state == Task::PENDING)   // Not already run by a waiting thread
+			{
+				task->execute(taskLock);
+			}
+
+			taskLock.unlock();
+			task.reset();
+
+			lock.lock();
+		}
+	}
+}
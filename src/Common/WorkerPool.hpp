@@ -0,0 +1,92 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_WorkerPool_hpp
+#define sw_WorkerPool_hpp
+
+#include "Thread.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sw
+{
+	// Runs work such as shader compilation, program linking and texture decoding
+	// on a set of background threads, and returns a Task to wait on it.
+	class Task
+	{
+	public:
+		explicit Task(const std::function<void()> &function);
+
+		// Returns once the task has completed. Runs it on the calling thread
+		// if no worker has picked it up yet, so waiting never depends on a
+		// free worker.
+		void wait();
+
+		bool isDone();
+
+	private:
+		friend class WorkerPool;
+
+		void execute(std::unique_lock<std::mutex> &lock);
+
+		enum State
+		{
+			PENDING,
+			RUNNING,
+			DONE
+		};
+
+		std::function<void()> function;
+
+		std::mutex mutex;
+		std::condition_variable done;
+		State state;
+	};
+
+	class WorkerPool
+	{
+	public:
+		WorkerPool();
+
+		~WorkerPool();   // Completes all queued tasks
+
+		std::shared_ptr<Task> enqueue(const std::function<void()> &function);
+
+		// Zero makes tasks run synchronously. Counts are capped at one thread per
+		// core. Threads are not stopped when lowering the count.
+		void setMaxThreadCount(unsigned int count);
+		unsigned int getMaxThreadCount();
+
+	private:
+		static unsigned int getDefaultThreadCount();
+
+		static void threadFunction(void *parameters);
+		void workerLoop();
+
+		std::vector<Thread*> workers;
+
+		std::mutex mutex;
+		std::condition_variable queued;
+		std::deque<std::shared_ptr<Task>> queue;
+		unsigned int maxThreadCount;
+		bool exit;
+	};
+}
+
+#endif   // sw_WorkerPool_hpp
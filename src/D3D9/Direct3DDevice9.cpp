@@ -568,7 +568,7 @@ namespace D3D9
 
 		*surface = 0;
 
-		if(width == 0 || height == 0 || d3d9->CheckDeviceFormat(adapter, deviceType, D3DFMT_X8R8G8B8, D3DUSAGE_DEPTHSTENCIL, D3DRTYPE_SURFACE, format) != D3D_OK || height > sw::OUTLINE_RESOLUTION)
+		if(width == 0 || height == 0 || d3d9->CheckDeviceFormat(adapter, deviceType, D3DFMT_X8R8G8B8, D3DUSAGE_DEPTHSTENCIL, D3DRTYPE_SURFACE, format) != D3D_OK)
 		{
 			return INVALIDCALL();
 		}
@@ -782,7 +782,7 @@ namespace D3D9
 
 		*surface = 0;
 
-		if(width == 0 || height == 0 || d3d9->CheckDeviceFormat(adapter, deviceType, D3DFMT_X8R8G8B8, D3DUSAGE_RENDERTARGET, D3DRTYPE_SURFACE, format) != D3D_OK || height > sw::OUTLINE_RESOLUTION)
+		if(width == 0 || height == 0 || d3d9->CheckDeviceFormat(adapter, deviceType, D3DFMT_X8R8G8B8, D3DUSAGE_RENDERTARGET, D3DRTYPE_SURFACE, format) != D3D_OK)
 		{
 			return INVALIDCALL();
 		}
@@ -1841,6 +1841,7 @@ namespace D3D9
 			update.stride = dest->getExternalPitchB();
 			update.cursorHeight = 0;
 			update.cursorWidth = 0;
+			update.streaming = false;
 
 			if(memcmp(&blitState, &update, sizeof(sw::BlitState)) != 0)
 			{
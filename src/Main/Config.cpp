@@ -49,6 +49,29 @@ namespace sw
 			compressedTex = 0;
 			compressedTexTotal = 0;
 			compressedTexFrame = 0;
+
+			vertexIndices = 0;
+			vertexIndicesTotal = 0;
+			vertexIndicesFrame = 0;
+
+			vertexInvocations = 0;
+			vertexInvocationsTotal = 0;
+			vertexInvocationsFrame = 0;
+
+			vertexLanes = 0;
+			vertexLanesTotal = 0;
+			vertexLanesFrame = 0;
+
+			textureDescriptors = 0;
+			textureDescriptorsTotal = 0;
+			textureDescriptorsFrame = 0;
+
+			for(int i = 0; i < REJECT_REASONS; i++)
+			{
+				rejectedTriangles[i] = 0;
+				rejectedTrianglesTotal[i] = 0;
+				rejectedTrianglesFrame[i] = 0;
+			}
 		#endif
 	};
 
@@ -58,10 +81,24 @@ namespace sw
 			ropOperationsFrame = sw::atomicExchange(&ropOperations, 0);
 			texOperationsFrame = sw::atomicExchange(&texOperations, 0);
 			compressedTexFrame = sw::atomicExchange(&compressedTex, 0);
+			vertexIndicesFrame = sw::atomicExchange(&vertexIndices, 0);
+			vertexInvocationsFrame = sw::atomicExchange(&vertexInvocations, 0);
+			vertexLanesFrame = sw::atomicExchange(&vertexLanes, 0);
+			textureDescriptorsFrame = sw::atomicExchange(&textureDescriptors, 0);
 
 			ropOperationsTotal += ropOperationsFrame;
 			texOperationsTotal += texOperationsFrame;
 			compressedTexTotal += compressedTexFrame;
+			vertexIndicesTotal += vertexIndicesFrame;
+			vertexInvocationsTotal += vertexInvocationsFrame;
+			vertexLanesTotal += vertexLanesFrame;
+			textureDescriptorsTotal += textureDescriptorsFrame;
+
+			for(int i = 0; i < REJECT_REASONS; i++)
+			{
+				rejectedTrianglesFrame[i] = sw::atomicExchange(&rejectedTriangles[i], 0);
+				rejectedTrianglesTotal[i] += rejectedTrianglesFrame[i];
+			}
 		#endif
 
 		static double fpsTime = sw::Timer::seconds();
@@ -47,6 +47,16 @@ namespace sw
 		PERF_TIMERS
 	};
 
+	enum
+	{
+		REJECT_OUTSIDE,      // Outside of the view volume or scissor rectangle
+		REJECT_DEGENERATE,   // Zero area
+		REJECT_CULLED,       // Facing away, according to the cull mode
+		REJECT_SUBPIXEL,     // Not covering any pixel or sample center
+
+		REJECT_REASONS
+	};
+
 	struct Profiler
 	{
 		Profiler();
@@ -72,6 +82,26 @@ namespace sw
 		int64_t compressedTex;
 		int64_t compressedTexTotal;
 		int64_t compressedTexFrame;
+
+		int64_t vertexIndices;
+		int64_t vertexIndicesTotal;
+		int64_t vertexIndicesFrame;
+
+		int64_t vertexInvocations;   // Vertices shaded, one per cache miss
+		int64_t vertexInvocationsTotal;
+		int64_t vertexInvocationsFrame;
+
+		int64_t vertexLanes;   // SIMD lanes the vertices got shaded with
+		int64_t vertexLanesTotal;
+		int64_t vertexLanesFrame;
+
+		int64_t textureDescriptors;   // Texture descriptors drawn with after they changed
+		int64_t textureDescriptorsTotal;
+		int64_t textureDescriptorsFrame;
+
+		int64_t rejectedTriangles[REJECT_REASONS];   // Triangles rejected before setup
+		int64_t rejectedTrianglesTotal[REJECT_REASONS];
+		int64_t rejectedTrianglesFrame[REJECT_REASONS];
 		#endif
 	};
 
@@ -79,7 +109,11 @@ namespace sw
 
 	enum
 	{
-		OUTLINE_RESOLUTION = 8192,   // Maximum vertical resolution of the render target
+		GUARD_BAND_EXTENT = 8192,    // Distance in pixels from the viewport center within which triangles are scissored instead of clipped
+		HIERARCHICAL_DEPTH_TILE_WIDTH = 16,   // Width in pixels of the depth culling tiles, which are one row pair high. Power of two.
+		VERTEX_CACHE_WAYS = 4,       // Associativity of the post-transform vertex cache. Power of two.
+		MAX_BATCH_SIZE = 256,        // Maximum number of primitives processed by a thread at once
+		NON_TEMPORAL_THRESHOLD = 0x400000,   // Minimum size in bytes of clears and copies which bypass the caches
 		MIPMAP_LEVELS = 14,
 		TEXTURE_IMAGE_UNITS = 16,
 		VERTEX_TEXTURE_IMAGE_UNITS = 16,
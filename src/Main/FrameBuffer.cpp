@@ -64,6 +64,7 @@ namespace sw
 		blitState.sourceFormat = FORMAT_X8R8G8B8;
 		blitState.cursorWidth = 0;
 		blitState.cursorHeight = 0;
+		blitState.streaming = false;
 
 		if(ASYNCHRONOUS_BLIT)
 		{
@@ -181,6 +182,8 @@ namespace sw
 		update.stride = stride;
 		update.cursorWidth = cursor.width;
 		update.cursorHeight = cursor.height;
+		update.streaming = (size_t)locked % 16 == 0 && stride % 16 == 0 &&
+		                   width * height * Surface::bytes(destFormat) >= NON_TEMPORAL_THRESHOLD;
 
 		if(memcmp(&blitState, &update, sizeof(BlitState)) != 0)
 		{
@@ -230,7 +233,7 @@ namespace sw
 						case FORMAT_A8R8G8B8:
 							For(, x < width - 3, x += 4)
 							{
-								*Pointer<Int4>(d, 1) = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
+								store(state, d, *Pointer<Int4>(s, sStride % 16 ? 1 : 16));
 
 								s += 4 * sBytes;
 								d += 4 * dBytes;
@@ -242,9 +245,9 @@ namespace sw
 							{
 								Int4 bgra = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
 
-								*Pointer<Int4>(d, 1) = ((bgra & Int4(0x00FF0000)) >> 16) |
-								                       ((bgra & Int4(0x000000FF)) << 16) |
-								                       (bgra & Int4(0xFF00FF00));
+								store(state, d, ((bgra & Int4(0x00FF0000)) >> 16) |
+								                ((bgra & Int4(0x000000FF)) << 16) |
+								                (bgra & Int4(0xFF00FF00)));
 
 								s += 4 * sBytes;
 								d += 4 * dBytes;
@@ -338,7 +341,7 @@ namespace sw
 						case FORMAT_A8B8G8R8:
 							For(, x < width - 3, x += 4)
 							{
-								*Pointer<Int4>(d, 1) = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
+								store(state, d, *Pointer<Int4>(s, sStride % 16 ? 1 : 16));
 
 								s += 4 * sBytes;
 								d += 4 * dBytes;
@@ -350,9 +353,9 @@ namespace sw
 							{
 								Int4 bgra = *Pointer<Int4>(s, sStride % 16 ? 1 : 16);
 
-								*Pointer<Int4>(d, 1) = ((bgra & Int4(0x00FF0000)) >> 16) |
-								                       ((bgra & Int4(0x000000FF)) << 16) |
-								                       (bgra & Int4(0xFF00FF00));
+								store(state, d, ((bgra & Int4(0x00FF0000)) >> 16) |
+								                ((bgra & Int4(0x000000FF)) << 16) |
+								                (bgra & Int4(0xFF00FF00)));
 
 								s += 4 * sBytes;
 								d += 4 * dBytes;
@@ -530,6 +533,11 @@ namespace sw
 				}
 			}
 
+			if(state.streaming)
+			{
+				StoreFence();
+			}
+
 			if(state.cursorWidth > 0 && state.cursorHeight > 0)
 			{
 				Int x0 = *Pointer<Int>(cursor + OFFSET(Cursor,x));
@@ -566,6 +574,18 @@ namespace sw
 		return function(L"FrameBuffer");
 	}
 
+	void FrameBuffer::store(const BlitState &state, const Pointer<Byte> &d, RValue<Int4> pixels)
+	{
+		if(state.streaming)
+		{
+			NonTemporalStore(pixels, d);
+		}
+		else
+		{
+			*Pointer<Int4>(d, 1) = pixels;
+		}
+	}
+
 	void FrameBuffer::blend(const BlitState &state, const Pointer<Byte> &d, const Pointer<Byte> &s, const Pointer<Byte> &c)
 	{
 		Short4 c1;
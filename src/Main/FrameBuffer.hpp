@@ -32,6 +32,7 @@ namespace sw
 		int stride;
 		int cursorWidth;
 		int cursorHeight;
+		bool streaming;   // Large aligned destination, written around the caches
 	};
 
 	class [[clang::lto_visibility_public]] FrameBuffer
@@ -95,6 +96,7 @@ namespace sw
 		BlitState blitState;
 
 		static void blend(const BlitState &state, const Pointer<Byte> &d, const Pointer<Byte> &s, const Pointer<Byte> &c);
+		static void store(const BlitState &state, const Pointer<Byte> &d, RValue<Int4> pixels);
 
 		Thread *blitThread;
 		Event syncEvent;
@@ -334,7 +334,12 @@ namespace sw
 		html += "</select></td>\n";
 		html += "</tr>\n";
 		html += "<tr><td>Vertex cache size:</td><td><select name='vertexCacheSize' title='The number of processed vertices being cached for reuse. Lower numbers save memory but require more vertices to be reprocessed.'>\n";
+		html += "<option value='16'"   + (config.vertexCacheSize == 16   ? selected : empty) + ">16</option>\n";
+		html += "<option value='32'"   + (config.vertexCacheSize == 32   ? selected : empty) + ">32</option>\n";
 		html += "<option value='64'"   + (config.vertexCacheSize == 64   ? selected : empty) + ">64 (default)</option>\n";
+		html += "<option value='128'"  + (config.vertexCacheSize == 128  ? selected : empty) + ">128</option>\n";
+		html += "<option value='256'"  + (config.vertexCacheSize == 256  ? selected : empty) + ">256</option>\n";
+		html += "<option value='512'"  + (config.vertexCacheSize == 512  ? selected : empty) + ">512</option>\n";
 		html += "</select></td>\n";
 		html += "</tr>\n";
 		html += "</table>\n";
@@ -438,6 +443,8 @@ namespace sw
 		html += "<option value='3'" + (config.shadowMapping == 3 ? selected : empty) + ">Fetch4 & DST (default)</option>\n";
 		html += "</select></td>\n";
 		html += "<tr><td>Force clearing registers that have no default value:</td><td><input name = 'forceClearRegisters' type='checkbox'" + (config.forceClearRegisters == true ? checked : empty) + " title='Initializes shader register values to 0 even if they have no default.'></td></tr>";
+		html += "<tr><td>Specialize shaders on uniform values:</td><td><input name = 'uniformSpecialization' type='checkbox'" + (config.uniformSpecialization == true ? checked : empty) + " title='Compiles the values of rarely changing uniforms which control branches and loops into the shader routines.'></td></tr>";
+		html += "<tr><td>Tiled texture layout:</td><td><input name = 'textureTiling' type='checkbox'" + (config.textureTiling == true ? checked : empty) + " title='Samples 2D textures from a copy stored in 4x4 texel tiles, which keeps neighboring rows in the same cache lines.'></td></tr>";
 		html += "</table>\n";
 	#ifndef NDEBUG
 		html += "<h2><em>Debugging</em></h2>\n";
@@ -491,6 +498,9 @@ namespace sw
 			html += "<p>Raster operations (million): " + ftoa(profiler.ropOperationsFrame / 1.0e6f) + " (current), " + ftoa(averageRopOperations) + " (average)</p>\n";
 			html += "<p>Texture operations (million): " + ftoa(profiler.texOperationsFrame / 1.0e6f) + " (current), " + ftoa(averageTexOperations) + " (average)</p>\n";
 			html += "<p>Compressed texture operations (million): " + ftoa(profiler.compressedTexFrame / 1.0e6f) + " (current), " + ftoa(averageCompressedTex) + " (average)</p>\n";
+			html += "<p>Vertex shader invocations per index: " + ftoa((double)profiler.vertexInvocationsFrame / std::max(profiler.vertexIndicesFrame, (int64_t)1)) + " (current), " + ftoa((double)profiler.vertexInvocationsTotal / std::max(profiler.vertexIndicesTotal, (int64_t)1)) + " (average)</p>\n";
+			html += "<p>Vertex shader SIMD lane utilization: " + ftoa((double)profiler.vertexInvocationsFrame / std::max(profiler.vertexLanesFrame, (int64_t)1)) + " (current), " + ftoa((double)profiler.vertexInvocationsTotal / std::max(profiler.vertexLanesTotal, (int64_t)1)) + " (average)</p>\n";
+			html += "<p>Texture descriptor rebuilds: " + itoa((int)profiler.textureDescriptorsFrame) + " (current), " + ftoa((double)profiler.textureDescriptorsTotal / std::max(profiler.framesTotal, 1)) + " (average)</p>\n";
 			html += "<div id='profile' style='position:relative; width:1010px; height:50px; background-color:silver;'>";
 			html += "<div style='position:relative; width:1000px; height:40px; background-color:white; left:5px; top:5px;'>";
 			html += "<div style='position:relative; float:left; width:" + itoa(rastTime)   + "px; height:40px; border-style:none; text-align:center; line-height:40px; background-color:#FFFF7F; overflow:hidden;'>" + ftoa(rastTimeF)   + "% rast</div>\n";
@@ -547,6 +557,8 @@ namespace sw
 		config.disable10BitMode = false;
 		config.precache = false;
 		config.forceClearRegisters = false;
+		config.uniformSpecialization = false;
+		config.textureTiling = false;
 
 		while(*post != 0)
 		{
@@ -689,6 +701,14 @@ namespace sw
 			{
 				config.forceClearRegisters = true;
 			}
+			else if(strstr(post, "uniformSpecialization=on"))
+			{
+				config.uniformSpecialization = true;
+			}
+			else if(strstr(post, "textureTiling=on"))
+			{
+				config.textureTiling = true;
+			}
 		#ifndef NDEBUG
 			else if(sscanf(post, "minPrimitives=%d", &integer))
 			{
@@ -752,6 +772,8 @@ namespace sw
 		config.precache = ini.getBoolean("Testing", "Precache", false);
 		config.shadowMapping = ini.getInteger("Testing", "ShadowMapping", 3);
 		config.forceClearRegisters = ini.getBoolean("Testing", "ForceClearRegisters", false);
+		config.uniformSpecialization = ini.getBoolean("Testing", "UniformSpecialization", false);
+		config.textureTiling = ini.getBoolean("Testing", "TextureTiling", false);
 
 	#ifndef NDEBUG
 		config.minPrimitives = 1;
@@ -810,6 +832,8 @@ namespace sw
 		ini.addValue("Testing", "Precache", itoa(config.precache));
 		ini.addValue("Testing", "ShadowMapping", itoa(config.shadowMapping));
 		ini.addValue("Testing", "ForceClearRegisters", itoa(config.forceClearRegisters));
+		ini.addValue("Testing", "UniformSpecialization", itoa(config.uniformSpecialization));
+		ini.addValue("Testing", "TextureTiling", itoa(config.textureTiling));
 		ini.addValue("LastModified", "Time", itoa((int)time(0)));
 
 		ini.writeFile("SwiftShader Configuration File\n"
@@ -62,6 +62,8 @@ namespace sw
 			bool precache;
 			int shadowMapping;
 			bool forceClearRegisters;
+			bool uniformSpecialization;
+			bool textureTiling;
 		#ifndef NDEBUG
 			unsigned int minPrimitives;
 			unsigned int maxPrimitives;
@@ -21,16 +21,20 @@
 #include "Object.hpp"
 #include "debug.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 namespace gl
 {
 
+// Objects are stored in a table indexed by name, which grows with the number
+// of objects. Names too large for the table are kept in a map instead.
 template<class ObjectType, GLuint baseName = 1>
 class NameSpace
 {
 public:
-	NameSpace() : freeName(baseName)
+	NameSpace() : denseCount(0), firstHint(~0u), lastHint(0), freeName(baseName)
 	{
 	}
 
@@ -41,17 +45,37 @@ public:
 
 	bool empty()
 	{
-		return map.empty();
+		return denseCount == 0 && map.empty();
 	}
 
 	GLuint firstName()
 	{
-		return map.begin()->first;
+		if(denseCount == 0)
+		{
+			return map.begin()->first;
+		}
+
+		while(!reserved[firstHint])
+		{
+			firstHint++;
+		}
+
+		return firstHint;
 	}
 
 	GLuint lastName()
 	{
-		return map.rbegin()->first;
+		if(!map.empty())
+		{
+			return map.rbegin()->first;
+		}
+
+		while(!reserved[lastHint])
+		{
+			lastHint--;
+		}
+
+		return lastHint;
 	}
 
 	GLuint allocate(ObjectType *object = nullptr)
@@ -63,7 +87,7 @@ public:
 			name++;
 		}
 
-		map.insert({name, object});
+		insert(name, object);
 		freeName = name + 1;
 
 		return name;
@@ -71,12 +95,32 @@ public:
 
 	bool isReserved(GLuint name) const
 	{
-		return map.find(name) != map.end();
+		if(name < reserved.size())
+		{
+			return reserved[name];
+		}
+
+		return !map.empty() && map.find(name) != map.end();
 	}
 
 	void insert(GLuint name, ObjectType *object)
 	{
-		map[name] = object;
+		if(fitsTable(name))
+		{
+			if(!reserved[name])
+			{
+				reserved[name] = true;
+				denseCount++;
+				firstHint = std::min(firstHint, name);
+				lastHint = std::max(lastHint, name);
+			}
+
+			objects[name] = object;
+		}
+		else
+		{
+			map[name] = object;
+		}
 
 		if(name == freeName)
 		{
@@ -86,26 +130,53 @@ public:
 
 	ObjectType *remove(GLuint name)
 	{
-		auto element = map.find(name);
+		ObjectType *object = nullptr;
 
-		if(element != map.end())
+		if(name < reserved.size())
 		{
-			ObjectType *object = element->second;
-			map.erase(element);
+			if(!reserved[name])
+			{
+				return nullptr;
+			}
+
+			object = objects[name];
+			objects[name] = nullptr;
+			reserved[name] = false;
+			denseCount--;
+		}
+		else
+		{
+			auto element = map.find(name);
 
-			if(name < freeName)
+			if(element == map.end())
 			{
-				freeName = name;
+				return nullptr;
 			}
 
-			return object;
+			object = element->second;
+			map.erase(element);
+		}
+
+		if(name < freeName)
+		{
+			freeName = name;
 		}
 
-		return nullptr;
+		return object;
 	}
 
 	ObjectType *find(GLuint name) const
 	{
+		if(name < objects.size())
+		{
+			return objects[name];
+		}
+
+		if(map.empty())
+		{
+			return nullptr;
+		}
+
 		auto element = map.find(name);
 
 		if(element == map.end())
@@ -117,8 +188,51 @@ public:
 	}
 
 private:
+	// Grows the table to hold the name, unless that would make it much larger than the number of objects
+	bool fitsTable(GLuint name)
+	{
+		if(name < objects.size())
+		{
+			return true;
+		}
+
+		size_t objectCount = denseCount + map.size();
+
+		if(name >= 4 * (objectCount + 16))
+		{
+			return false;
+		}
+
+		size_t size = std::max<size_t>(static_cast<size_t>(name) + 1, 2 * objects.size());
+		objects.resize(size, nullptr);
+		reserved.resize(size, false);
+
+		// Move the names which now fit from the map into the table
+		while(!map.empty() && map.begin()->first < size)
+		{
+			GLuint mapName = map.begin()->first;
+
+			objects[mapName] = map.begin()->second;
+			reserved[mapName] = true;
+			denseCount++;
+			firstHint = std::min(firstHint, mapName);
+			lastHint = std::max(lastHint, mapName);
+
+			map.erase(map.begin());
+		}
+
+		return true;
+	}
+
+	std::vector<ObjectType*> objects;   // Indexed by name
+	std::vector<bool> reserved;         // Names in the table which are in use, possibly without an object
+	size_t denseCount;                  // Number of reserved names in the table
+
+	GLuint firstHint;   // No reserved name in the table is lower
+	GLuint lastHint;    // No reserved name in the table is higher
+
 	typedef std::map<GLuint, ObjectType*> Map;
-	Map map;
+	Map map;   // Names beyond the table
 
 	GLuint freeName;   // Lowest known potentially free name
 };
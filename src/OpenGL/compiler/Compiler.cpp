@@ -21,6 +21,11 @@
 #include "ParseHelper.h"
 #include "ValidateLimitations.h"
 
+#include "Common/MutexLock.hpp"
+
+#include <memory>
+#include <vector>
+
 namespace
 {
 class TScopedPoolAllocator {
@@ -41,6 +46,96 @@ private:
 	TPoolAllocator* mAllocator;
 	bool mPushPopAllocator;
 };
+
+// Built-in symbols only depend on the shader type and the resources, so they
+// are generated once per combination and shared by all compilers. They live in
+// their own pool, which is released along with the other compiler globals.
+struct TBuiltInSymbolTable
+{
+	TBuiltInSymbolTable(GLenum shaderType, const ShBuiltInResources &resources);
+	~TBuiltInSymbolTable();
+
+	GLenum shaderType;
+	ShBuiltInResources resources;
+
+	TPoolAllocator allocator;
+	TSymbolTable symbolTable;
+};
+
+TBuiltInSymbolTable::TBuiltInSymbolTable(GLenum shaderType, const ShBuiltInResources &resources)
+	: shaderType(shaderType), resources(resources)
+{
+	TPoolAllocator *previousAllocator = GetGlobalPoolAllocator();
+	allocator.push();
+	SetGlobalPoolAllocator(&allocator);
+
+	symbolTable.push();   // COMMON_BUILTINS
+	symbolTable.push();   // ESSL1_BUILTINS
+	symbolTable.push();   // ESSL3_BUILTINS
+
+	TPublicType integer;
+	integer.type = EbtInt;
+	integer.primarySize = 1;
+	integer.secondarySize = 1;
+	integer.array = false;
+
+	TPublicType floatingPoint;
+	floatingPoint.type = EbtFloat;
+	floatingPoint.primarySize = 1;
+	floatingPoint.secondarySize = 1;
+	floatingPoint.array = false;
+
+	switch(shaderType)
+	{
+	case GL_FRAGMENT_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpMedium);
+		break;
+	case GL_VERTEX_SHADER:
+		symbolTable.setDefaultPrecision(integer, EbpHigh);
+		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
+		break;
+	default: assert(false && "Language not supported");
+	}
+
+	InsertBuiltInFunctions(shaderType, resources, symbolTable);
+
+	IdentifyBuiltIns(shaderType, resources, symbolTable);
+
+	SetGlobalPoolAllocator(previousAllocator);
+}
+
+TBuiltInSymbolTable::~TBuiltInSymbolTable()
+{
+	allocator.popAll();
+}
+
+sw::MutexLock builtInSymbolTablesMutex;
+std::vector<std::unique_ptr<TBuiltInSymbolTable>> builtInSymbolTables;
+
+const TSymbolTable &GetBuiltInSymbolTable(GLenum shaderType, const ShBuiltInResources &resources)
+{
+	LockGuard lock(builtInSymbolTablesMutex);
+
+	for(const auto &builtIns : builtInSymbolTables)
+	{
+		// ShBuiltInResources only holds integers, so it has no padding to compare
+		if(builtIns->shaderType == shaderType && memcmp(&builtIns->resources, &resources, sizeof(ShBuiltInResources)) == 0)
+		{
+			return builtIns->symbolTable;
+		}
+	}
+
+	builtInSymbolTables.emplace_back(new TBuiltInSymbolTable(shaderType, resources));
+
+	return builtInSymbolTables.back()->symbolTable;
+}
+
+void FreeBuiltInSymbolTables()
+{
+	LockGuard lock(builtInSymbolTablesMutex);
+
+	builtInSymbolTables.clear();
+}
 }  // namespace
 
 //
@@ -66,6 +161,7 @@ ShBuiltInResources::ShBuiltInResources()
 	OES_standard_derivatives = 0;
 	OES_fragment_precision_high = 0;
 	OES_EGL_image_external = 0;
+	EXT_draw_buffers = 0;
 
 	MaxCallStackDepth = UINT_MAX;
 }
@@ -164,37 +260,7 @@ bool TCompiler::compile(const char* const shaderStrings[],
 bool TCompiler::InitBuiltInSymbolTable(const ShBuiltInResources &resources)
 {
 	assert(symbolTable.isEmpty());
-	symbolTable.push();   // COMMON_BUILTINS
-	symbolTable.push();   // ESSL1_BUILTINS
-	symbolTable.push();   // ESSL3_BUILTINS
-
-	TPublicType integer;
-	integer.type = EbtInt;
-	integer.primarySize = 1;
-	integer.secondarySize = 1;
-	integer.array = false;
-
-	TPublicType floatingPoint;
-	floatingPoint.type = EbtFloat;
-	floatingPoint.primarySize = 1;
-	floatingPoint.secondarySize = 1;
-	floatingPoint.array = false;
-
-	switch(shaderType)
-	{
-	case GL_FRAGMENT_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpMedium);
-		break;
-	case GL_VERTEX_SHADER:
-		symbolTable.setDefaultPrecision(integer, EbpHigh);
-		symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
-		break;
-	default: assert(false && "Language not supported");
-	}
-
-	InsertBuiltInFunctions(shaderType, resources, symbolTable);
-
-	IdentifyBuiltIns(shaderType, resources, symbolTable);
+	symbolTable.shareBuiltIns(GetBuiltInSymbolTable(shaderType, resources));
 
 	return true;
 }
@@ -264,6 +330,7 @@ bool InitCompilerGlobals()
 
 void FreeCompilerGlobals()
 {
+	FreeBuiltInSymbolTables();
 	FreeParseContextIndex();
 	FreePoolIndex();
 }
@@ -108,7 +108,8 @@ private:
 	unsigned int maxCallStackDepth;
 
 	// Built-in symbol table for the given language, spec, and resources.
-	// It is preserved from compile-to-compile.
+	// It is preserved from compile-to-compile. The built-in levels are
+	// shared with all other compilers using the same type and resources.
 	TSymbolTable symbolTable;
 	// Built-in extensions with default behavior.
 	TExtensionBehavior extensionBehavior;
@@ -432,6 +432,10 @@ void InsertBuiltInFunctions(GLenum type, const ShBuiltInResources &resources, TS
 	depthRange->setQualifier(EvqUniform);
 	symbolTable.insert(COMMON_BUILTINS, *depthRange);
 
+	// Built-ins are shared by concurrent compilers, so evaluate lazily computed properties now
+	depthRangeStruct->mangledName();
+	depthRangeStruct->objectSize();
+
 	//
 	// Implementation dependent built-in constants.
 	//
@@ -202,6 +202,7 @@ namespace glsl
 	{
 		type = GL_NONE;
 		arraySize = 0;
+		location = -1;
 		registerIndex = 0;
 	}
 
@@ -31,7 +31,7 @@
 #define snprintf _snprintf
 #endif
 
-int TSymbolTableLevel::uniqueId = 0;
+std::atomic<int> TSymbolTableLevel::uniqueId(0);
 
 TType::TType(const TPublicType &p) :
 	type(p.type), precision(p.precision), qualifier(p.qualifier), invariant(p.invariant), layoutQualifier(p.layoutQualifier),
@@ -46,6 +46,7 @@
 
 #include "InfoSink.h"
 #include "intermediate.h"
+#include <atomic>
 #include <set>
 
 //
@@ -235,7 +236,7 @@ public:
 
 protected:
 	tLevel level;
-	static int uniqueId;     // for unique identification in code generation
+	static std::atomic<int> uniqueId;     // for unique identification in code generation, shared by concurrent compilers
 };
 
 enum ESymbolLevel
@@ -332,6 +333,16 @@ public:
 		}
 	}
 
+	// Adopts the built-in levels of another table without copying them. The
+	// built-ins are treated as read-only and must outlive this table.
+	void shareBuiltIns(const TSymbolTable &builtIns)
+	{
+		assert(isEmpty() && builtIns.currentLevel() == LAST_BUILTIN_LEVEL);
+		table = builtIns.table;
+		precisionStack = builtIns.precisionStack;
+		mUnmangledBuiltinNames = builtIns.mUnmangledBuiltinNames;
+	}
+
 	bool isEmpty() { return table.empty(); }
 	bool atBuiltInLevel() { return currentLevel() <= LAST_BUILTIN_LEVEL; }
 	bool atGlobalLevel() { return currentLevel() <= GLOBAL_LEVEL; }
@@ -22,6 +22,7 @@
 #include <GLES/gl.h>
 
 namespace gl { class Surface; }
+namespace sw { struct Fence; }
 
 namespace egl
 {
@@ -38,6 +39,8 @@ public:
 	virtual EGLint getClientVersion() const = 0;
 	virtual EGLint getConfigID() const = 0;
 	virtual void finish() = 0;
+	virtual void synchronize() = 0;   // Waits for commands recorded for deferred execution
+	virtual void addFence(sw::Fence *fence) = 0;   // Signaled once all earlier commands have completed
 	virtual void blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface *dest, const sw::SliceRect &dRect) = 0;
 
 	Display *getDisplay() const { return display; }
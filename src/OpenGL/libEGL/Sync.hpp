@@ -18,6 +18,7 @@
 #define LIBEGL_SYNC_H_
 
 #include "Context.hpp"
+#include "Renderer/Fence.hpp"
 
 #include <EGL/eglext.h>
 
@@ -29,22 +30,25 @@ class FenceSync
 public:
 	explicit FenceSync(Context *context) : context(context)
 	{
-		status = EGL_UNSIGNALED_KHR;
+		fence = new sw::Fence();
+
 		context->addRef();
+		context->addFence(fence);
 	}
 
 	~FenceSync()
 	{
+		fence->release();   // Deleted once the draw calls before it have completed
+
 		context->release();
 		context = nullptr;
 	}
 
-	void wait() { context->finish(); signal(); }
-	void signal() { status = EGL_SIGNALED_KHR; }
-	bool isSignaled() const { return status == EGL_SIGNALED_KHR; }
+	bool wait(EGLTimeKHR timeout) { return fence->wait(timeout); }
+	bool isSignaled() const { return fence->isSignaled(); }
 
 private:
-	EGLint status;
+	sw::Fence *fence;
 	Context *context;
 };
 
@@ -810,6 +810,13 @@ EGLBoolean MakeCurrent(EGLDisplay dpy, EGLSurface draw, EGLSurface read, EGLCont
 		UNIMPLEMENTED();   // FIXME
 	}
 
+	egl::Context *previousContext = egl::getCurrentContext();
+
+	if(previousContext)
+	{
+		previousContext->synchronize();   // Another thread may make it current next
+	}
+
 	egl::setCurrentDrawSurface(drawSurface);
 	egl::setCurrentReadSurface(readSurface);
 	egl::setCurrentContext(context);
@@ -941,6 +948,13 @@ EGLBoolean SwapBuffers(EGLDisplay dpy, EGLSurface surface)
 		return error(EGL_BAD_SURFACE, EGL_FALSE);
 	}
 
+	egl::Context *context = egl::getCurrentContext();
+
+	if(context)
+	{
+		context->synchronize();   // Draws to the back buffer may still be recorded
+	}
+
 	eglSurface->swap();
 
 	return success(EGL_TRUE);
@@ -1192,12 +1206,11 @@ EGLint ClientWaitSyncKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint flags, EGLTimeK
 		return error(EGL_BAD_PARAMETER, EGL_FALSE);
 	}
 
-	(void)flags;
-	(void)timeout;
+	(void)flags;   // Draw calls start executing when they're issued, so EGL_SYNC_FLUSH_COMMANDS_BIT_KHR needs no flush
 
-	if(!eglSync->isSignaled())
+	if(!eglSync->wait(timeout))
 	{
-		eglSync->wait();
+		return success(EGL_TIMEOUT_EXPIRED_KHR);
 	}
 
 	return success(EGL_CONDITION_SATISFIED_KHR);
@@ -1226,7 +1239,6 @@ EGLBoolean GetSyncAttribKHR(EGLDisplay dpy, EGLSyncKHR sync, EGLint attribute, E
 		*value = EGL_SYNC_FENCE_KHR;
 		return success(EGL_TRUE);
 	case EGL_SYNC_STATUS_KHR:
-		eglSync->wait();   // TODO: Don't block. Just poll based on sw::Query.
 		*value = eglSync->isSignaled() ? EGL_SIGNALED_KHR : EGL_UNSIGNALED_KHR;
 		return success(EGL_TRUE);
 	case EGL_SYNC_CONDITION_KHR:
@@ -254,12 +254,6 @@ namespace gl
 
 	Image *Device::createDepthStencilSurface(unsigned int width, unsigned int height, sw::Format format, int multiSampleDepth, bool discard)
 	{
-		if(height > OUTLINE_RESOLUTION)
-		{
-			ERR("Invalid parameters: %dx%d", width, height);
-			return 0;
-		}
-
 		bool lockable = true;
 
 		switch(format)
@@ -298,12 +292,6 @@ namespace gl
 
 	Image *Device::createRenderTarget(unsigned int width, unsigned int height, sw::Format format, int multiSampleDepth, bool lockable)
 	{
-		if(height > OUTLINE_RESOLUTION)
-		{
-			ERR("Invalid parameters: %dx%d", width, height);
-			return 0;
-		}
-
 		Image *surface = new Image(0, width, height, format, multiSampleDepth, lockable, true);
 
 		if(!surface)
@@ -32,7 +32,10 @@ Query::Query(GLuint name, GLenum type) : NamedObject(name)
 
 Query::~Query()
 {
-	delete mQuery;
+	if(mQuery)
+	{
+		mQuery->release();   // Deleted once the draw calls it was issued to have completed
+	}
 }
 
 void Query::begin()
@@ -114,7 +117,7 @@ GLboolean Query::testQuery()
 {
 	if(mQuery && mStatus != GL_TRUE)
 	{
-		if(!mQuery->building && mQuery->reference == 0)
+		if(!mQuery->building && mQuery->isSignaled())
 		{
 			unsigned int numPixels = mQuery->data;
 			mStatus = GL_TRUE;
@@ -22,6 +22,8 @@
 #include "IndexDataManager.h"
 #include "common/debug.h"
 
+#include "Common/Memory.hpp"
+
 namespace
 {
 	enum {INITIAL_STREAM_BUFFER_SIZE = 1024 * 1024};
@@ -92,19 +94,7 @@ unsigned int VertexDataManager::writeAttributeData(StreamingVertexBuffer *vertex
 
 	input += inputStride * start;
 
-	if(inputStride == elementSize)
-	{
-		memcpy(output, input, count * inputStride);
-	}
-	else
-	{
-		for(int i = 0; i < count; i++)
-		{
-			memcpy(output, input, elementSize);
-			output += elementSize;
-			input += inputStride;
-		}
-	}
+	sw::copy(output, input, elementSize, inputStride, count);
 
 	vertexBuffer->unmap();
 
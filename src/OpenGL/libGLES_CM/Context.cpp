@@ -2860,6 +2860,16 @@ void Context::finish()
 	device->finish();
 }
 
+void Context::synchronize()
+{
+	// Commands are executed immediately
+}
+
+void Context::addFence(sw::Fence *fence)
+{
+	device->addFence(fence);
+}
+
 void Context::flush()
 {
 	// We don't queue anything without processing it as fast as possible
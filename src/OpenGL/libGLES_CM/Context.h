@@ -302,6 +302,8 @@ public:
 	EGLint getConfigID() const override;
 
 	void finish() override;
+	void synchronize() override;
+	void addFence(sw::Fence *fence) override;
 
 	void markAllStateDirty();
 
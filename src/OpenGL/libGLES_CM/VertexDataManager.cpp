@@ -21,6 +21,8 @@
 #include "IndexDataManager.h"
 #include "common/debug.h"
 
+#include "Common/Memory.hpp"
+
 #include <algorithm>
 
 namespace
@@ -93,19 +95,7 @@ unsigned int VertexDataManager::writeAttributeData(StreamingVertexBuffer *vertex
 
 	input += inputStride * start;
 
-	if(inputStride == elementSize)
-	{
-		memcpy(output, input, count * inputStride);
-	}
-	else
-	{
-		for(int i = 0; i < count; i++)
-		{
-			memcpy(output, input, elementSize);
-			output += elementSize;
-			input += inputStride;
-		}
-	}
+	sw::copy(output, input, elementSize, inputStride, count);
 
 	vertexBuffer->unmap();
 
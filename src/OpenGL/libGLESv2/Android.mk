@@ -27,6 +27,7 @@ endif
 
 COMMON_SRC_FILES := \
 	Buffer.cpp \
+	CommandQueue.cpp \
 	Context.cpp \
 	Device.cpp \
 	Fence.cpp \
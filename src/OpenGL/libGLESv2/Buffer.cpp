@@ -38,6 +38,8 @@ Buffer::Buffer(GLuint name) : NamedObject(name)
 
 Buffer::~Buffer()
 {
+	clearOptimizedIndices();
+
 	if(mContents)
 	{
 		mContents->destruct();
@@ -46,6 +48,8 @@ Buffer::~Buffer()
 
 void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 {
+	clearOptimizedIndices();
+
 	if(mContents)
 	{
 		mContents->destruct();
@@ -57,7 +61,6 @@ void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 
 	if(size > 0)
 	{
-		const int padding = 1024;   // For SIMD processing of vertices
 		mContents = new sw::Resource(size + padding);
 
 		if(!mContents)
@@ -75,6 +78,8 @@ void Buffer::bufferData(const void *data, GLsizeiptr size, GLenum usage)
 
 void Buffer::bufferSubData(const void *data, GLsizeiptr size, GLintptr offset)
 {
+	clearOptimizedIndices();
+
 	if(mContents && data)
 	{
 		char *buffer = (char*)mContents->lock(sw::PUBLIC);
@@ -85,21 +90,66 @@ void Buffer::bufferSubData(const void *data, GLsizeiptr size, GLintptr offset)
 
 void* Buffer::mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access)
 {
-	if(mContents)
+	if(!mContents)
 	{
-		char* buffer = (char*)mContents->lock(sw::PUBLIC);
-		mIsMapped = true;
-		mOffset = offset;
-		mLength = length;
-		mAccess = access;
-		return buffer + offset;
+		return nullptr;
 	}
-	return nullptr;
+
+	if(offset == 0 && (size_t)length == mSize && (access & GL_MAP_INVALIDATE_RANGE_BIT))
+	{
+		access |= GL_MAP_INVALIDATE_BUFFER_BIT;
+	}
+
+	if(access & GL_MAP_INVALIDATE_BUFFER_BIT)
+	{
+		clearOptimizedIndices();
+	}
+	else if((access & GL_MAP_WRITE_BIT) && !(access & GL_MAP_FLUSH_EXPLICIT_BIT))
+	{
+		clearOptimizedIndices(offset, length);
+	}
+
+	char *buffer = nullptr;
+
+	if(access & GL_MAP_UNSYNCHRONIZED_BIT)
+	{
+		// The application guarantees it doesn't modify data still in use by draw calls
+		buffer = (char*)mContents->data();
+	}
+	else if(access & GL_MAP_INVALIDATE_BUFFER_BIT)
+	{
+		buffer = (char*)mContents->tryLock(sw::PUBLIC);
+
+		if(!buffer)   // Still in use by draw calls, so orphan it instead of waiting
+		{
+			sw::Resource *contents = new sw::Resource(mSize + padding);
+
+			if(!contents)
+			{
+				return error(GL_OUT_OF_MEMORY, nullptr);
+			}
+
+			mContents->destruct();
+			mContents = contents;
+			buffer = (char*)mContents->lock(sw::PUBLIC);
+		}
+	}
+	else
+	{
+		buffer = (char*)mContents->lock(sw::PUBLIC);
+	}
+
+	mIsMapped = true;
+	mOffset = offset;
+	mLength = length;
+	mAccess = access;
+
+	return buffer + offset;
 }
 
 bool Buffer::unmap()
 {
-	if(mContents)
+	if(mContents && !(mAccess & GL_MAP_UNSYNCHRONIZED_BIT))
 	{
 		mContents->unlock();
 	}
@@ -110,9 +160,83 @@ bool Buffer::unmap()
 	return true;
 }
 
+void Buffer::flushMappedRange(GLintptr offset, GLsizeiptr length)
+{
+	// The mapping is the buffer's storage itself, so there's nothing to copy
+	clearOptimizedIndices(mOffset + offset, length);
+}
+
 sw::Resource *Buffer::getResource()
 {
 	return mContents;
 }
 
+sw::Resource *Buffer::getOptimizedIndices(GLenum type, GLintptr offset, GLsizei count, GLuint maxIndex)
+{
+	if(!mContents)
+	{
+		return nullptr;
+	}
+
+	for(size_t i = 0; i < mOptimizedIndices.size(); i++)
+	{
+		const OptimizedIndices &optimized = mOptimizedIndices[i];
+
+		if(optimized.type == type && optimized.offset == offset && optimized.count == count)
+		{
+			return optimized.indices;
+		}
+	}
+
+	const int maxOptimizedRanges = 8;
+
+	if(mOptimizedIndices.size() >= maxOptimizedRanges)
+	{
+		mOptimizedIndices.front().indices->destruct();
+		mOptimizedIndices.erase(mOptimizedIndices.begin());
+	}
+
+	size_t bytes = IndexDataManager::typeSize(type) * count;
+	sw::Resource *indices = new sw::Resource(bytes + 16);
+
+	// Locking waits for draw calls which write to the buffer through transform feedback
+	const void *source = static_cast<const GLubyte*>(mContents->lock(sw::PUBLIC)) + offset;
+	IndexDataManager::optimizeTriangleOrder(type, source, count, maxIndex, const_cast<void*>(indices->data()));
+	mContents->unlock();
+
+	OptimizedIndices optimized = {type, offset, count, indices};
+	mOptimizedIndices.push_back(optimized);
+
+	return indices;
+}
+
+void Buffer::clearOptimizedIndices()
+{
+	for(size_t i = 0; i < mOptimizedIndices.size(); i++)
+	{
+		mOptimizedIndices[i].indices->destruct();
+	}
+
+	mOptimizedIndices.clear();
+}
+
+void Buffer::clearOptimizedIndices(GLintptr offset, GLsizeiptr length)
+{
+	for(size_t i = 0; i < mOptimizedIndices.size();)
+	{
+		const OptimizedIndices &optimized = mOptimizedIndices[i];
+		GLintptr end = optimized.offset + IndexDataManager::typeSize(optimized.type) * optimized.count;
+
+		if(optimized.offset < offset + length && offset < end)   // Overlaps the modified range
+		{
+			optimized.indices->destruct();
+			mOptimizedIndices.erase(mOptimizedIndices.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
 }
@@ -49,11 +49,28 @@ public:
 
 	void* mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access);
 	bool unmap();
-	void flushMappedRange(GLintptr offset, GLsizeiptr length) {}
+	void flushMappedRange(GLintptr offset, GLsizeiptr length);   // Relative to the mapped range
 
 	sw::Resource *getResource();
+	sw::Resource *getOptimizedIndices(GLenum type, GLintptr offset, GLsizei count, GLuint maxIndex);
+
+	// Also needed when draw calls or pixel packing write to the buffer
+	void clearOptimizedIndices();
+	void clearOptimizedIndices(GLintptr offset, GLsizeiptr length);   // Only the ones overlapping the range
 
 private:
+	static const int padding = 1024;   // For SIMD processing of vertices
+
+	struct OptimizedIndices   // Triangle list reordered for vertex cache locality
+	{
+		GLenum type;
+		GLintptr offset;
+		GLsizei count;
+		sw::Resource *indices;
+	};
+
+	std::vector<OptimizedIndices> mOptimizedIndices;
+
 	sw::Resource *mContents;
 	size_t mSize;
 	GLenum mUsage;
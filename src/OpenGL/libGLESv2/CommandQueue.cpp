@@ -0,0 +1,225 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CommandQueue.cpp: Implements the CommandQueue class.
+
+#include "CommandQueue.h"
+
+#include "Context.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+	// Number of times to poll the other thread before going to sleep
+	const int spinCount = 64;
+
+	sw::Thread::LocalStorageKey serverContextKey()
+	{
+		static sw::Thread::LocalStorageKey key = sw::Thread::allocateLocalStorageKey();
+
+		return key;
+	}
+}
+
+namespace es2
+{
+	CommandQueue::CommandQueue(Context *context) : context(context), recorded(0), executed(0), serverWaiting(false), clientWaiting(false), exit(false)
+	{
+		ring = new Command[SIZE];
+		clientStateValid = false;
+		elementArrayBuffer = false;
+		clientArrays = 0;
+		enabledArrays = 0;
+
+		serverThread = new sw::Thread(threadFunction, this);
+	}
+
+	CommandQueue::~CommandQueue()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			exit = true;
+			commandRecorded.notify_one();
+		}
+
+		serverThread->join();
+		delete serverThread;
+
+		delete[] ring;
+	}
+
+	void CommandQueue::synchronize()
+	{
+		clientStateValid = false;   // The caller may change the state directly
+
+		unsigned int count = recorded.load(std::memory_order_relaxed);
+
+		if(executed.load(std::memory_order_acquire) != count)
+		{
+			waitForExecution(count);
+		}
+	}
+
+	bool CommandQueue::canRecordDraw(bool indexed)
+	{
+		updateClientState();
+
+		return (clientArrays & enabledArrays) == 0 && (elementArrayBuffer || !indexed);
+	}
+
+	void CommandQueue::bindElementArrayBuffer(GLuint buffer)
+	{
+		updateClientState();
+
+		elementArrayBuffer = (buffer != 0);
+	}
+
+	void CommandQueue::enableVertexAttribArray(GLuint index, bool enable)
+	{
+		updateClientState();
+
+		if(index < MAX_VERTEX_ATTRIBS)
+		{
+			enabledArrays = enable ? (enabledArrays | (1 << index)) : (enabledArrays & ~(1 << index));
+		}
+	}
+
+	Context *CommandQueue::getServerContext()
+	{
+		return static_cast<Context*>(sw::Thread::getLocalStorage(serverContextKey()));
+	}
+
+	bool CommandQueue::isEnabled()
+	{
+		const char *threaded = getenv("SWIFTSHADER_THREADED_GL");
+
+		return threaded && strcmp(threaded, "1") == 0;
+	}
+
+	CommandQueue::Command &CommandQueue::acquire()
+	{
+		updateClientState();   // Before the state can change under us
+
+		unsigned int next = recorded.load(std::memory_order_relaxed);
+
+		if(next - executed.load(std::memory_order_acquire) == SIZE)
+		{
+			waitForExecution(next - SIZE + 1);
+		}
+
+		return ring[next % SIZE];
+	}
+
+	void CommandQueue::publish()
+	{
+		recorded.store(recorded.load(std::memory_order_relaxed) + 1);
+
+		// Sequentially consistent with the server's check of the count before sleeping
+		if(serverWaiting.load())
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			commandRecorded.notify_one();
+		}
+	}
+
+	void CommandQueue::waitForExecution(unsigned int count)
+	{
+		auto done = [this, count]() { return static_cast<int>(executed.load() - count) >= 0; };
+
+		for(int i = 0; i < spinCount; i++)
+		{
+			if(done())
+			{
+				return;
+			}
+
+			sw::Thread::yield();
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		clientWaiting = true;
+		commandExecuted.wait(lock, done);
+		clientWaiting = false;
+	}
+
+	bool CommandQueue::waitForCommands(unsigned int next)
+	{
+		for(int i = 0; i < spinCount; i++)
+		{
+			if(recorded.load(std::memory_order_acquire) != next)
+			{
+				return true;
+			}
+
+			sw::Thread::yield();
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		serverWaiting = true;
+		commandRecorded.wait(lock, [this, next]() { return recorded.load() != next || exit; });
+		serverWaiting = false;
+
+		return recorded.load() != next;   // Exit only once all commands are executed
+	}
+
+	void CommandQueue::updateClientState()
+	{
+		if(clientStateValid)
+		{
+			return;
+		}
+
+		// Only invalid after synchronizing, and nothing was recorded since, so the server is idle
+		const VertexAttributeArray &attributes = context->getVertexArrayAttributes();
+
+		clientArrays = 0;
+		enabledArrays = 0;
+
+		for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+		{
+			clientArrays |= attributes[i].mBoundBuffer ? 0 : (1 << i);
+			enabledArrays |= attributes[i].mArrayEnabled ? (1 << i) : 0;
+		}
+
+		elementArrayBuffer = (context->getElementArrayBufferName() != 0);
+		clientStateValid = true;
+	}
+
+	void CommandQueue::threadFunction(void *parameters)
+	{
+		static_cast<CommandQueue*>(parameters)->serverLoop();
+	}
+
+	void CommandQueue::serverLoop()
+	{
+		sw::Thread::setLocalStorage(serverContextKey(), context);
+
+		for(unsigned int next = 0; waitForCommands(next); next++)
+		{
+			Command &command = ring[next % SIZE];
+			command.execute(&command);
+
+			executed.store(next + 1);
+
+			// Sequentially consistent with the client's check of the count before sleeping
+			if(clientWaiting.load())
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				commandExecuted.notify_one();
+			}
+		}
+	}
+}
@@ -0,0 +1,130 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// CommandQueue.h: Defines the CommandQueue class, which records GL commands on
+// the application thread and executes them in order on a server thread.
+
+#ifndef LIBGLESV2_COMMANDQUEUE_H_
+#define LIBGLESV2_COMMANDQUEUE_H_
+
+#include "Common/Thread.hpp"
+
+#include <GLES2/gl2.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+
+namespace es2
+{
+	class Context;
+
+	// Single producer, single consumer ring of commands. The thread the context
+	// is current on records, and the server thread executes. Any other access
+	// to the context's state has to synchronize() first.
+	class CommandQueue
+	{
+	public:
+		explicit CommandQueue(Context *context);
+
+		~CommandQueue();   // Executes all recorded commands
+
+		// Queues a copy of the function object, to be called on the server thread
+		template<class Function>
+		void record(const Function &function);
+
+		// Returns once all recorded commands have executed
+		void synchronize();
+
+		// Draws read client-side vertex and index arrays, so they must execute
+		// before returning to the application when any are in use.
+		bool canRecordDraw(bool indexed);
+		void bindElementArrayBuffer(GLuint buffer);
+		void enableVertexAttribArray(GLuint index, bool enable);
+
+		// Returns the context whose commands the calling thread executes, if it's a server thread
+		static Context *getServerContext();
+
+		// Threaded dispatch is enabled by setting SWIFTSHADER_THREADED_GL=1 before creating contexts
+		static bool isEnabled();
+
+	private:
+		struct Command
+		{
+			void (*execute)(Command *command);
+			alignas(8) unsigned char arguments[120];
+		};
+
+		template<class Function>
+		static void execute(Command *command);
+
+		Command &acquire();
+		void publish();
+		void waitForExecution(unsigned int count);
+		bool waitForCommands(unsigned int next);
+		void updateClientState();
+
+		static void threadFunction(void *parameters);
+		void serverLoop();
+
+		enum { SIZE = 1024 };   // Power of two, so the counters can wrap
+
+		Context *const context;
+		Command *ring;
+
+		// Counts of recorded and executed commands, on separate cache lines
+		std::atomic<unsigned int> recorded;
+		unsigned char padding[64];
+		std::atomic<unsigned int> executed;
+
+		// Only taken when either thread goes to sleep
+		std::mutex mutex;
+		std::condition_variable commandRecorded;
+		std::condition_variable commandExecuted;
+		std::atomic<bool> serverWaiting;
+		std::atomic<bool> clientWaiting;
+		bool exit;
+
+		// Application thread's copy of the state which decides whether draws can be recorded
+		bool clientStateValid;
+		bool elementArrayBuffer;
+		unsigned int clientArrays;
+		unsigned int enabledArrays;
+
+		sw::Thread *serverThread;
+	};
+
+	template<class Function>
+	void CommandQueue::record(const Function &function)
+	{
+		static_assert(sizeof(Function) <= sizeof(Command::arguments), "Command arguments exceed a queue entry");
+
+		Command &command = acquire();
+		new (command.arguments) Function(function);
+		command.execute = execute<Function>;
+		publish();
+	}
+
+	template<class Function>
+	void CommandQueue::execute(Command *command)
+	{
+		Function *function = reinterpret_cast<Function*>(command->arguments);
+
+		(*function)();
+		function->~Function();
+	}
+}
+
+#endif   // LIBGLESV2_COMMANDQUEUE_H_
@@ -20,6 +20,7 @@
 #include "main.h"
 #include "mathutil.h"
 #include "utilities.h"
+#include "CommandQueue.h"
 #include "ResourceManager.h"
 #include "Buffer.h"
 #include "Fence.h"
@@ -41,7 +42,11 @@
 #include <EGL/eglext.h>
 
 #include <algorithm>
+#include <iterator>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
+#include <vector>
 
 namespace es2
 {
@@ -183,10 +188,21 @@ Context::Context(egl::Display *display, const Context *shareContext, EGLint clie
 	mHasBeenCurrent = false;
 
 	markAllStateDirty();
+
+	commandQueue = CommandQueue::isEnabled() ? new CommandQueue(this) : nullptr;
+
+	const char *reorder = getenv("SWIFTSHADER_REORDER_OPAQUE_TRIANGLES");
+	reorderOpaqueTriangles = reorder && strcmp(reorder, "1") == 0;
+
+	// Embedders which restrict high resolution timers, like web browsers, can hide the timer queries
+	const char *disableTimerQueries = getenv("SWIFTSHADER_DISABLE_TIMER_QUERIES");
+	timerQueries = !disableTimerQueries || strcmp(disableTimerQueries, "1") != 0;
 }
 
 Context::~Context()
 {
+	delete commandQueue;   // Executes all pending commands
+
 	if(mState.currentProgram != 0)
 	{
 		Program *programObject = mResourceManager->getProgram(mState.currentProgram);
@@ -273,6 +289,8 @@ Context::~Context()
 
 void Context::makeCurrent(gl::Surface *surface)
 {
+	synchronize();
+
 	if(!mHasBeenCurrent)
 	{
 		mVertexDataManager = new VertexDataManager(this);
@@ -321,6 +339,22 @@ void Context::makeCurrent(gl::Surface *surface)
 	markAllStateDirty();
 }
 
+void Context::synchronize()
+{
+	// Commands executing on the server thread already observe all earlier ones
+	if(commandQueue && CommandQueue::getServerContext() != this)
+	{
+		commandQueue->synchronize();
+	}
+}
+
+void Context::addFence(sw::Fence *fence)
+{
+	synchronize();
+
+	device->addFence(fence);
+}
+
 EGLint Context::getClientVersion() const
 {
 	return clientVersion;
@@ -769,6 +803,11 @@ void Context::setFramebufferDrawBuffers(GLsizei n, const GLenum *bufs)
 	}
 }
 
+void Context::setMaxShaderCompilerThreads(GLuint count)
+{
+	mResourceManager->getWorkerPool()->setMaxThreadCount(count);
+}
+
 GLuint Context::getReadFramebufferColorIndex() const
 {
 	GLenum buf = getReadFramebuffer()->getReadBuffer();
@@ -809,6 +848,11 @@ GLuint Context::getActiveQuery(GLenum target) const
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		queryObject = mState.activeQuery[QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN];
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		queryObject = mState.activeQuery[QUERY_TIME_ELAPSED];
+		break;
+	case GL_TIMESTAMP_EXT:   // Never active
+		break;
 	default:
 		ASSERT(false);
 	}
@@ -1109,9 +1153,9 @@ Shader *Context::getShader(GLuint handle) const
 	return mResourceManager->getShader(handle);
 }
 
-Program *Context::getProgram(GLuint handle) const
+Program *Context::getProgram(GLuint handle, bool waitForLink) const
 {
-	return mResourceManager->getProgram(handle);
+	return mResourceManager->getProgram(handle, waitForLink);
 }
 
 Texture *Context::getTexture(GLuint handle) const
@@ -1346,21 +1390,6 @@ void Context::beginQuery(GLenum target, GLuint query)
 	// active query object name for any query type, the error INVALID_OPERATION is
 	// generated.
 
-	// Ensure no other queries are active
-	// NOTE: If other queries than occlusion are supported, we will need to check
-	// separately that:
-	//    a) The query ID passed is not the current active query for any target/type
-	//    b) There are no active queries for the requested target (and in the case
-	//       of GL_ANY_SAMPLES_PASSED_EXT and GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT,
-	//       no query may be active for either if glBeginQuery targets either.
-	for(int i = 0; i < QUERY_TYPE_COUNT; i++)
-	{
-		if(mState.activeQuery[i])
-		{
-			return error(GL_INVALID_OPERATION);
-		}
-	}
-
 	QueryType qType;
 	switch(target)
 	{
@@ -1373,11 +1402,34 @@ void Context::beginQuery(GLenum target, GLuint query)
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		qType = QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN;
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		qType = QUERY_TIME_ELAPSED;
+		break;
 	default:
 		UNREACHABLE(target);
 		return error(GL_INVALID_ENUM);
 	}
 
+	// Ensure no other queries are active, except that a time elapsed query can
+	// measure the others. The query ID also can't be active for another target.
+	// NOTE: Occlusion and transform feedback queries could be active at the same
+	// time as well, as long as their targets differ (where GL_ANY_SAMPLES_PASSED_EXT
+	// and GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT count as the same).
+	for(int i = 0; i < QUERY_TYPE_COUNT; i++)
+	{
+		Query *activeQuery = mState.activeQuery[i];
+
+		if(activeQuery)
+		{
+			bool timer = (i == QUERY_TIME_ELAPSED) != (qType == QUERY_TIME_ELAPSED);
+
+			if(!timer || activeQuery->name == query)
+			{
+				return error(GL_INVALID_OPERATION);
+			}
+		}
+	}
+
 	Query *queryObject = createQuery(query, target);
 
 	// Check that name was obtained with glGenQueries
@@ -1408,6 +1460,7 @@ void Context::endQuery(GLenum target)
 	case GL_ANY_SAMPLES_PASSED_EXT:                qType = QUERY_ANY_SAMPLES_PASSED;                    break;
 	case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:   qType = QUERY_ANY_SAMPLES_PASSED_CONSERVATIVE;       break;
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN: qType = QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN; break;
+	case GL_TIME_ELAPSED_EXT:                      qType = QUERY_TIME_ELAPSED;                          break;
 	default: UNREACHABLE(target); return;
 	}
 
@@ -1423,6 +1476,27 @@ void Context::endQuery(GLenum target)
 	mState.activeQuery[qType] = nullptr;
 }
 
+void Context::queryCounter(GLuint query, GLenum target)
+{
+	ASSERT(target == GL_TIMESTAMP_EXT);
+
+	Query *queryObject = createQuery(query, target);
+
+	// Check that name was obtained with glGenQueries
+	if(!queryObject)
+	{
+		return error(GL_INVALID_OPERATION);
+	}
+
+	// Check for type mismatch
+	if(queryObject->getType() != target)
+	{
+		return error(GL_INVALID_OPERATION);
+	}
+
+	queryObject->queryCounter();
+}
+
 void Context::setFramebufferZero(Framebuffer *buffer)
 {
 	delete mFramebufferNameSpace.remove(0);
@@ -1925,6 +1999,21 @@ template<typename T> bool Context::getIntegerv(GLenum pname, T *params) const
 	case GL_MAX_CUBE_MAP_TEXTURE_SIZE:        *params = IMPLEMENTATION_MAX_CUBE_MAP_TEXTURE_SIZE; return true;
 	case GL_NUM_COMPRESSED_TEXTURE_FORMATS:   *params = NUM_COMPRESSED_TEXTURE_FORMATS;           return true;
 	case GL_MAX_SAMPLES_ANGLE:                *params = IMPLEMENTATION_MAX_SAMPLES;               return true;
+	case GL_MAX_SHADER_COMPILER_THREADS_KHR:  *params = mResourceManager->getWorkerPool()->getMaxThreadCount(); return true;
+	case GL_GPU_DISJOINT_EXT:
+		if(!timerQueries)
+		{
+			return false;
+		}
+		*params = 0;   // Timer queries use a monotonic clock
+		return true;
+	case GL_TIMESTAMP_EXT:
+		if(!timerQueries)
+		{
+			return false;
+		}
+		*params = (T)Query::getTimestamp();
+		return true;
 	case GL_SAMPLE_BUFFERS:
 	case GL_SAMPLES:
 		{
@@ -2246,8 +2335,7 @@ template<typename T> bool Context::getIntegerv(GLenum pname, T *params) const
 			*params = mState.pixelUnpackBuffer.name();
 			return true;
 		case GL_PROGRAM_BINARY_FORMATS:
-			// Since NUM_PROGRAM_BINARY_FORMATS is 0, the input
-			// should be a 0 sized array, so don't write to params
+			*params = GL_PROGRAM_BINARY_SWIFTSHADER;
 			return true;
 		case GL_READ_BUFFER:
 			*params = getReadFramebuffer()->getReadBuffer();
@@ -2414,6 +2502,7 @@ bool Context::getQueryParameterInfo(GLenum pname, GLenum *type, unsigned int *nu
 		}
 		break;
 	case GL_MAX_VERTEX_ATTRIBS:
+	case GL_MAX_SHADER_COMPILER_THREADS_KHR:
 	case GL_MAX_VERTEX_UNIFORM_VECTORS:
 	case GL_MAX_VARYING_VECTORS:
 	case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
@@ -2556,6 +2645,15 @@ bool Context::getQueryParameterInfo(GLenum pname, GLenum *type, unsigned int *nu
 			*numParams = 1;
 		}
 		break;
+	case GL_GPU_DISJOINT_EXT:
+	case GL_TIMESTAMP_EXT:
+		if(!timerQueries)
+		{
+			return false;
+		}
+		*type = GL_INT;
+		*numParams = 1;
+		break;
 	case GL_MAX_VIEWPORT_DIMS:
 		{
 			*type = GL_INT;
@@ -2963,7 +3061,8 @@ GLenum Context::applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsize
 // Applies the indices and element array bindings
 GLenum Context::applyIndexBuffer(const void *indices, GLuint start, GLuint end, GLsizei count, GLenum mode, GLenum type, TranslatedIndexData *indexInfo)
 {
-	GLenum err = mIndexDataManager->prepareIndexData(type, start, end, count, getCurrentVertexArray()->getElementArrayBuffer(), indices, indexInfo);
+	bool reorderTriangles = isPrimitiveOrderIndependent(mode);
+	GLenum err = mIndexDataManager->prepareIndexData(type, start, end, count, getCurrentVertexArray()->getElementArrayBuffer(), indices, indexInfo, reorderTriangles);
 
 	if(err == GL_NO_ERROR)
 	{
@@ -2973,6 +3072,84 @@ GLenum Context::applyIndexBuffer(const void *indices, GLuint start, GLuint end,
 	return err;
 }
 
+// Returns true when drawing the triangles in any order produces the same result. That's
+// the case for depth-only passes with a depth test which keeps the nearest or farthest
+// fragment. Opaque color draws with a strict depth test only differ where triangles have
+// equal depths, so reordering those has to be requested with SWIFTSHADER_REORDER_OPAQUE_TRIANGLES=1.
+bool Context::isPrimitiveOrderIndependent(GLenum drawMode)
+{
+	if(drawMode != GL_TRIANGLES)
+	{
+		return false;
+	}
+
+	if(!mState.depthTestEnabled || !mState.depthMask)
+	{
+		return false;
+	}
+
+	if(mState.stencilTestEnabled || mState.primitiveRestartFixedIndexEnabled)
+	{
+		return false;
+	}
+
+	Framebuffer *framebuffer = getDrawFramebuffer();
+
+	if(!framebuffer || !framebuffer->getDepthbuffer())
+	{
+		return false;
+	}
+
+	TransformFeedback *transformFeedback = getTransformFeedback();
+
+	if(transformFeedback && transformFeedback->isActive())
+	{
+		return false;
+	}
+
+	for(int i = 0; i < QUERY_TYPE_COUNT; i++)
+	{
+		if(mState.activeQuery[i])   // Sample counts depend on the order
+		{
+			return false;
+		}
+	}
+
+	bool colorWrites = false;
+
+	if(mState.colorMaskRed || mState.colorMaskGreen || mState.colorMaskBlue || mState.colorMaskAlpha)
+	{
+		for(int i = 0; i < MAX_DRAW_BUFFERS; i++)
+		{
+			if(framebuffer->getDrawBuffer(i) != GL_NONE && framebuffer->getColorbuffer(i))
+			{
+				colorWrites = true;
+			}
+		}
+	}
+
+	if(!colorWrites)   // Each sample ends up with the minimum or maximum depth of its fragments
+	{
+		switch(mState.depthFunc)
+		{
+		case GL_LESS:
+		case GL_LEQUAL:
+		case GL_GREATER:
+		case GL_GEQUAL:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	if(!reorderOpaqueTriangles || (mState.depthFunc != GL_LESS && mState.depthFunc != GL_GREATER))
+	{
+		return false;
+	}
+
+	return !mState.blendEnabled && !mState.sampleAlphaToCoverageEnabled;
+}
+
 // Applies the shaders and shader constants
 void Context::applyShaders()
 {
@@ -3229,6 +3406,11 @@ void Context::readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 	GLsizei outputWidth = (mState.packRowLength > 0) ? mState.packRowLength : width;
 	GLsizei outputPitch = egl::ComputePitch(outputWidth, format, type, mState.packAlignment);
 	GLsizei outputHeight = (mState.packImageHeight == 0) ? height : mState.packImageHeight;
+	if(getPixelPackBuffer())
+	{
+		getPixelPackBuffer()->clearOptimizedIndices();
+	}
+
 	pixels = getPixelPackBuffer() ? (unsigned char*)getPixelPackBuffer()->data() + (ptrdiff_t)pixels : (unsigned char*)pixels;
 	pixels = ((char*)pixels) + egl::ComputePackingOffset(format, type, outputWidth, outputHeight, mState.packAlignment, mState.packSkipImages, mState.packSkipRows, mState.packSkipPixels);
 
@@ -3538,6 +3720,8 @@ void Context::blit(sw::Surface *source, const sw::SliceRect &sRect, sw::Surface
 
 void Context::finish()
 {
+	synchronize();
+
 	device->finish();
 }
 
@@ -4166,6 +4350,8 @@ void Context::blitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1
 
 void Context::bindTexImage(gl::Surface *surface)
 {
+	synchronize();
+
 	es2::Texture2D *textureObject = getTexture2D();
 
 	if(textureObject)
@@ -4176,6 +4362,8 @@ void Context::bindTexImage(gl::Surface *surface)
 
 EGLenum Context::validateSharedImage(EGLenum target, GLuint name, GLuint textureLevel)
 {
+	synchronize();
+
 	GLenum textureTarget = GL_NONE;
 
 	switch(target)
@@ -4247,6 +4435,8 @@ EGLenum Context::validateSharedImage(EGLenum target, GLuint name, GLuint texture
 
 egl::Image *Context::createSharedImage(EGLenum target, GLuint name, GLuint textureLevel)
 {
+	synchronize();
+
 	GLenum textureTarget = GL_NONE;
 
 	switch(target)
@@ -4282,6 +4472,11 @@ egl::Image *Context::getSharedImage(GLeglImageOES image)
 	return display->getSharedImage(image);
 }
 
+CommandQueue *Context::getCommandQueue() const
+{
+	return commandQueue;
+}
+
 Device *Context::getDevice()
 {
 	return device;
@@ -4317,6 +4512,7 @@ const GLubyte *Context::getExtensions(GLuint index, GLuint *numExt) const
 		"GL_OES_vertex_half_float",
 		"GL_EXT_blend_minmax",
 		"GL_EXT_color_buffer_half_float",
+		"GL_EXT_disjoint_timer_query",
 		"GL_EXT_draw_buffers",
 		"GL_EXT_instanced_arrays",
 		"GL_EXT_occlusion_query_boolean",
@@ -4327,6 +4523,7 @@ const GLubyte *Context::getExtensions(GLuint index, GLuint *numExt) const
 		"GL_EXT_texture_filter_anisotropic",
 		"GL_EXT_texture_format_BGRA8888",
 		"GL_EXT_texture_rg",
+		"GL_KHR_parallel_shader_compile",
 		"GL_ANGLE_framebuffer_blit",
 		"GL_ANGLE_framebuffer_multisample",
 		"GL_ANGLE_instanced_arrays",
@@ -4346,57 +4543,53 @@ const GLubyte *Context::getExtensions(GLuint index, GLuint *numExt) const
 		"GL_EXT_color_buffer_float",
 	};
 
-	GLuint numES2extensions = sizeof(es2extensions) / sizeof(es2extensions[0]);
-	GLuint numExtensions = numES2extensions;
+	std::vector<const char*> extensions;
+
+	for(const char *extension : es2extensions)
+	{
+		if(timerQueries || strcmp(extension, "GL_EXT_disjoint_timer_query") != 0)
+		{
+			extensions.push_back(extension);
+		}
+	}
 
 	if(clientVersion >= 3)
 	{
-		numExtensions += sizeof(es3extensions) / sizeof(es3extensions[0]);
+		extensions.insert(extensions.end(), std::begin(es3extensions), std::end(es3extensions));
 	}
 
 	if(numExt)
 	{
-		*numExt = numExtensions;
+		*numExt = static_cast<GLuint>(extensions.size());
 
 		return nullptr;
 	}
 
 	if(index == GL_INVALID_INDEX)
 	{
-		static std::string extensionsCat;
-
-		if(extensionsCat.empty() && (numExtensions > 0))
+		// Kept by each context, since the exposed extensions depend on its version and settings
+		if(extensionString.empty())
 		{
-			for(const char *extension : es2extensions)
+			for(const char *extension : extensions)
 			{
-				extensionsCat += std::string(extension) + " ";
-			}
-
-			if(clientVersion >= 3)
-			{
-				for(const char *extension : es3extensions)
-				{
-					extensionsCat += std::string(extension) + " ";
-				}
+				extensionString += std::string(extension) + " ";
 			}
 		}
 
-		return (const GLubyte*)extensionsCat.c_str();
+		return (const GLubyte*)extensionString.c_str();
 	}
 
-	if(index >= numExtensions)
+	if(index >= extensions.size())
 	{
 		return nullptr;
 	}
 
-	if(index < numES2extensions)
-	{
-		return (const GLubyte*)es2extensions[index];
-	}
-	else
-	{
-		return (const GLubyte*)es3extensions[index - numES2extensions];
-	}
+	return (const GLubyte*)extensions[index];
+}
+
+bool Context::hasTimerQueries() const
+{
+	return timerQueries;
 }
 
 }
@@ -70,6 +70,7 @@ class Query;
 class Sampler;
 class VertexArray;
 class TransformFeedback;
+class CommandQueue;
 
 enum
 {
@@ -102,7 +103,7 @@ enum
 	MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS = 4,
 	MAX_UNIFORM_BUFFER_BINDINGS = sw::MAX_UNIFORM_BUFFER_BINDINGS,
 	UNIFORM_BUFFER_OFFSET_ALIGNMENT = 1,
-	NUM_PROGRAM_BINARY_FORMATS = 0,
+	NUM_PROGRAM_BINARY_FORMATS = 1,
 };
 
 const GLenum compressedTextureFormats[] =
@@ -158,6 +159,10 @@ const GLenum compressedTextureFormats[] =
 
 const GLenum GL_TEXTURE_FILTERING_HINT_CHROMIUM = 0x8AF0;
 
+// Taken from the 0x8AF0 block reserved for Chromium in the Khronos enum registry, like the hint above.
+// Binaries in this format are only accepted by the build which produced them.
+const GLenum GL_PROGRAM_BINARY_SWIFTSHADER = 0x8AFF;
+
 const GLint NUM_COMPRESSED_TEXTURE_FORMATS = sizeof(compressedTextureFormats) / sizeof(compressedTextureFormats[0]);
 
 const GLint multisampleCount[] = {4, 2, 1};
@@ -175,6 +180,7 @@ enum QueryType
 	QUERY_ANY_SAMPLES_PASSED,
 	QUERY_ANY_SAMPLES_PASSED_CONSERVATIVE,
 	QUERY_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN,
+	QUERY_TIME_ELAPSED,
 
 	QUERY_TYPE_COUNT
 };
@@ -434,6 +440,8 @@ public:
 	Context(egl::Display *display, const Context *shareContext, EGLint clientVersion, const egl::Config *config);
 
 	void makeCurrent(gl::Surface *surface) override;
+	void synchronize() override;
+	void addFence(sw::Fence *fence) override;
 	EGLint getClientVersion() const override;
 	EGLint getConfigID() const override;
 
@@ -512,6 +520,7 @@ public:
 
 	void setFramebufferReadBuffer(GLenum buf);
 	void setFramebufferDrawBuffers(GLsizei n, const GLenum *bufs);
+	void setMaxShaderCompilerThreads(GLuint count);
 	GLuint getReadFramebufferColorIndex() const;
 
 	GLuint getActiveQuery(GLenum target) const;
@@ -609,6 +618,7 @@ public:
 
 	void beginQuery(GLenum target, GLuint query);
 	void endQuery(GLenum target);
+	void queryCounter(GLuint query, GLenum target);
 
 	void setFramebufferZero(Framebuffer *framebuffer);
 
@@ -622,7 +632,7 @@ public:
 	Fence *getFence(GLuint handle) const;
 	FenceSync *getFenceSync(GLsync handle) const;
 	Shader *getShader(GLuint handle) const;
-	Program *getProgram(GLuint handle) const;
+	Program *getProgram(GLuint handle, bool waitForLink = true) const;
 	virtual Texture *getTexture(GLuint handle) const;
 	Framebuffer *getFramebuffer(GLuint handle) const;
 	virtual Renderbuffer *getRenderbuffer(GLuint handle) const;
@@ -700,9 +710,12 @@ public:
 	egl::Image *createSharedImage(EGLenum target, GLuint name, GLuint textureLevel) override;
 	egl::Image *getSharedImage(GLeglImageOES image);
 
+	CommandQueue *getCommandQueue() const;
+
 	Device *getDevice();
 
 	const GLubyte *getExtensions(GLuint index, GLuint *numExt = nullptr) const;
+	bool hasTimerQueries() const;   // Whether GL_EXT_disjoint_timer_query is exposed
 
 private:
 	~Context() override;
@@ -712,6 +725,7 @@ private:
 	void applyState(GLenum drawMode);
 	GLenum applyVertexBuffer(GLint base, GLint first, GLsizei count, GLsizei instanceId);
 	GLenum applyIndexBuffer(const void *indices, GLuint start, GLuint end, GLsizei count, GLenum mode, GLenum type, TranslatedIndexData *indexInfo);
+	bool isPrimitiveOrderIndependent(GLenum drawMode);
 	void applyShaders();
 	void applyTextures();
 	void applyTextures(sw::SamplerType type);
@@ -772,6 +786,13 @@ private:
 
 	Device *device;
 	ResourceManager *mResourceManager;
+
+	CommandQueue *commandQueue;   // Only when commands are executed on a server thread
+
+	bool reorderOpaqueTriangles;   // Even when triangles of equal depth would resolve differently
+	bool timerQueries;
+
+	mutable std::string extensionString;
 };
 }
 
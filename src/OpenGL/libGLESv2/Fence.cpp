@@ -17,7 +17,6 @@
 #include "Fence.h"
 
 #include "main.h"
-#include "Common/Thread.hpp"
 
 namespace es2
 {
@@ -27,10 +26,13 @@ Fence::Fence()
 	mQuery = false;
 	mCondition = GL_NONE;
 	mStatus = GL_FALSE;
+	mFence = new sw::Fence();
 }
 
 Fence::~Fence()
 {
+	mFence->release();   // Deleted once the draw calls before it have completed
+
 	mQuery = false;
 }
 
@@ -51,6 +53,8 @@ void Fence::setFence(GLenum condition)
 	mQuery = true;
 	mCondition = condition;
 	mStatus = GL_FALSE;
+
+	getDevice()->addFence(mFence);
 }
 
 GLboolean Fence::testFence()
@@ -60,10 +64,7 @@ GLboolean Fence::testFence()
 		return error(GL_INVALID_OPERATION, GL_TRUE);
 	}
 
-	// The current assumtion is that no matter where the fence is placed, it is
-	// done by the time it is tested, which is similar to Context::flush(), since
-	// we don't queue anything without processing it as fast as possible.
-	mStatus = GL_TRUE;
+	mStatus = mFence->isSignaled() ? GL_TRUE : GL_FALSE;
 
 	return mStatus;
 }
@@ -75,10 +76,8 @@ void Fence::finishFence()
 		return error(GL_INVALID_OPERATION);
 	}
 
-	while(!testFence())
-	{
-		sw::Thread::yield();
-	}
+	mFence->wait(GL_TIMEOUT_IGNORED);
+	testFence();
 }
 
 void Fence::getFenceiv(GLenum pname, GLint *params)
@@ -117,22 +116,36 @@ void Fence::getFenceiv(GLenum pname, GLint *params)
 
 FenceSync::FenceSync(GLuint name, GLenum condition, GLbitfield flags) : NamedObject(name), mCondition(condition), mFlags(flags)
 {
+	Device *device = getDevice();
+
+	mFence = new sw::Fence();
+	device->addFence(mFence);
+	mDevice = device;
 }
 
 FenceSync::~FenceSync()
 {
+	mFence->release();   // Deleted once the draw calls before it have completed
 }
 
 GLenum FenceSync::clientWait(GLbitfield flags, GLuint64 timeout)
 {
-	// The current assumtion is that no matter where the fence is placed, it is
-	// done by the time it is tested, which is similar to Context::flush(), since
-	// we don't queue anything without processing it as fast as possible.
-	return GL_ALREADY_SIGNALED;
+	if(mFence->isSignaled())
+	{
+		return GL_ALREADY_SIGNALED;
+	}
+
+	// Draw calls start executing when they're issued, so GL_SYNC_FLUSH_COMMANDS_BIT needs no flush
+	return mFence->wait(timeout) ? GL_CONDITION_SATISFIED : GL_TIMEOUT_EXPIRED;
 }
 
 void FenceSync::serverWait(GLbitfield flags, GLuint64 timeout)
 {
+	// A device executes its draw calls in order, so only fences of other contexts' devices have to be waited on
+	if(getDevice() != mDevice)
+	{
+		mFence->wait(timeout);
+	}
 }
 
 void FenceSync::getSynciv(GLenum pname, GLsizei *length, GLint *values)
@@ -146,10 +159,7 @@ void FenceSync::getSynciv(GLenum pname, GLsizei *length, GLint *values)
 		}
 		break;
 	case GL_SYNC_STATUS:
-		// The current assumtion is that no matter where the fence is placed, it is
-		// done by the time it is tested, which is similar to Context::flush(), since
-		// we don't queue anything without processing it as fast as possible.
-		values[0] = GL_SIGNALED;
+		values[0] = mFence->isSignaled() ? GL_SIGNALED : GL_UNSIGNALED;
 		if(length) {
 			*length = 1;
 		}
@@ -18,10 +18,12 @@
 #define LIBGLESV2_FENCE_H_
 
 #include "common/Object.hpp"
+#include "Renderer/Fence.hpp"
 #include <GLES2/gl2.h>
 
 namespace es2
 {
+class Device;
 
 class Fence
 {
@@ -39,6 +41,8 @@ private:
 	bool mQuery;
 	GLenum mCondition;
 	GLboolean mStatus;
+
+	sw::Fence *mFence;
 };
 
 class FenceSync : public gl::NamedObject
@@ -57,6 +61,9 @@ public:
 private:
 	GLenum mCondition;
 	GLbitfield mFlags;
+
+	sw::Fence *mFence;
+	const Device *mDevice;   // Only compared against, to tell whether waiting on the server is implied
 };
 
 }
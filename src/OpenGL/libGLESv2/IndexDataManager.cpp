@@ -22,10 +22,18 @@
 
 #include <string.h>
 #include <algorithm>
+#include <vector>
 
 namespace
 {
 	enum { INITIAL_INDEX_BUFFER_SIZE = 4096 * sizeof(GLuint) };
+
+	// Triangle lists shorter than this are not worth reordering
+	enum { MIN_REORDERED_INDEX_COUNT = 3 * 256 };
+
+	// FIFO cache size assumed when reordering. Smaller than the renderer's vertex cache,
+	// to leave headroom for its set conflicts.
+	enum { REORDER_CACHE_SIZE = 32 };
 }
 
 namespace es2
@@ -93,7 +101,152 @@ void computeRange(GLenum type, const void *indices, GLsizei count, GLuint *minIn
 	else UNREACHABLE(type);
 }
 
-GLenum IndexDataManager::prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, Buffer *buffer, const void *indices, TranslatedIndexData *translated)
+// Reorders a triangle list for vertex cache locality, using Sander et al.'s 'Tipsy' algorithm. Triangles
+// are emitted in fans around the most recently cached vertex that still has unemitted triangles.
+template<class IndexType>
+void optimizeTriangleOrder(const IndexType *input, GLsizei count, GLuint vertexCount, IndexType *output)
+{
+	const int triangleCount = count / 3;
+
+	// Triangles adjacent to each vertex
+	std::vector<int> first(vertexCount + 1, 0);
+	std::vector<int> adjacency(triangleCount * 3);
+
+	for(GLsizei i = 0; i < triangleCount * 3; i++)
+	{
+		first[input[i] + 1]++;
+	}
+
+	for(GLuint v = 0; v < vertexCount; v++)
+	{
+		first[v + 1] += first[v];
+	}
+
+	std::vector<int> liveCount(vertexCount);   // Unemitted triangles per vertex
+
+	for(GLuint v = 0; v < vertexCount; v++)
+	{
+		liveCount[v] = first[v + 1] - first[v];
+	}
+
+	std::vector<int> fill(first.begin(), first.end() - 1);
+
+	for(GLsizei i = 0; i < triangleCount * 3; i++)
+	{
+		adjacency[fill[input[i]]++] = i / 3;
+	}
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<int> timestamp(vertexCount, 0);
+	std::vector<GLuint> deadEnd;
+	std::vector<GLuint> candidates;
+
+	int time = REORDER_CACHE_SIZE + 1;
+	GLuint cursor = 0;
+	int fanning = input[0];
+	IndexType *out = output;
+
+	while(fanning >= 0)
+	{
+		candidates.clear();
+
+		for(int a = first[fanning]; a < first[fanning + 1]; a++)
+		{
+			int t = adjacency[a];
+
+			if(emitted[t])
+			{
+				continue;
+			}
+
+			for(int k = 0; k < 3; k++)
+			{
+				IndexType v = input[3 * t + k];
+
+				*out++ = v;
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				liveCount[v]--;
+
+				if(time - timestamp[v] > REORDER_CACHE_SIZE)
+				{
+					timestamp[v] = time++;
+				}
+			}
+
+			emitted[t] = true;
+		}
+
+		// Prefer the oldest candidate which will still be cached once its own fan is emitted
+		int next = -1;
+		int bestPriority = -1;
+
+		for(size_t c = 0; c < candidates.size(); c++)
+		{
+			GLuint v = candidates[c];
+
+			if(liveCount[v] > 0)
+			{
+				int priority = 0;
+
+				if(time - timestamp[v] + 2 * liveCount[v] <= REORDER_CACHE_SIZE)
+				{
+					priority = time - timestamp[v];
+				}
+
+				if(priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = v;
+				}
+			}
+		}
+
+		while(next < 0 && !deadEnd.empty())
+		{
+			GLuint v = deadEnd.back();
+			deadEnd.pop_back();
+
+			if(liveCount[v] > 0)
+			{
+				next = v;
+			}
+		}
+
+		while(next < 0 && cursor < vertexCount)
+		{
+			if(liveCount[cursor] > 0)
+			{
+				next = cursor;
+			}
+
+			cursor++;
+		}
+
+		fanning = next;
+	}
+
+	ASSERT(out == output + triangleCount * 3);
+}
+
+void IndexDataManager::optimizeTriangleOrder(GLenum type, const void *input, GLsizei count, GLuint maxIndex, void *output)
+{
+	if(type == GL_UNSIGNED_BYTE)
+	{
+		es2::optimizeTriangleOrder(static_cast<const GLubyte*>(input), count, maxIndex + 1, static_cast<GLubyte*>(output));
+	}
+	else if(type == GL_UNSIGNED_INT)
+	{
+		es2::optimizeTriangleOrder(static_cast<const GLuint*>(input), count, maxIndex + 1, static_cast<GLuint*>(output));
+	}
+	else if(type == GL_UNSIGNED_SHORT)
+	{
+		es2::optimizeTriangleOrder(static_cast<const GLushort*>(input), count, maxIndex + 1, static_cast<GLushort*>(output));
+	}
+	else UNREACHABLE(type);
+}
+
+GLenum IndexDataManager::prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, Buffer *buffer, const void *indices, TranslatedIndexData *translated, bool reorderTriangles)
 {
 	if(!mStreamingBuffer)
 	{
@@ -122,6 +275,20 @@ GLenum IndexDataManager::prepareIndexData(GLenum type, GLuint start, GLuint end,
 
 		translated->indexBuffer = staticBuffer;
 		translated->indexOffset = static_cast<unsigned int>(offset);
+
+		// Static triangle lists whose primitive order doesn't affect the result get reordered once
+		// for vertex cache locality. Meshes with more vertices than indices are left alone.
+		if(reorderTriangles && buffer->usage() == GL_STATIC_DRAW && count >= MIN_REORDERED_INDEX_COUNT &&
+		   count % 3 == 0 && translated->maxIndex < static_cast<GLuint>(count))
+		{
+			sw::Resource *optimized = buffer->getOptimizedIndices(type, offset, count, translated->maxIndex);
+
+			if(optimized)
+			{
+				translated->indexBuffer = optimized;
+				translated->indexOffset = 0;
+			}
+		}
 	}
 	else
 	{
@@ -58,9 +58,10 @@ public:
 	IndexDataManager();
 	virtual ~IndexDataManager();
 
-	GLenum prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, Buffer *arrayElementBuffer, const void *indices, TranslatedIndexData *translated);
+	GLenum prepareIndexData(GLenum type, GLuint start, GLuint end, GLsizei count, Buffer *arrayElementBuffer, const void *indices, TranslatedIndexData *translated, bool reorderTriangles);
 
 	static std::size_t typeSize(GLenum type);
+	static void optimizeTriangleOrder(GLenum type, const void *input, GLsizei count, GLuint maxIndex, void *output);
 
 private:
 	StreamingIndexBuffer *mStreamingBuffer;
@@ -25,10 +25,13 @@
 #include "common/debug.h"
 #include "Shader/PixelShader.hpp"
 #include "Shader/VertexShader.hpp"
+#include "Common/Serialization.hpp"
+#include "Common/Version.h"
 
 #include <algorithm>
 #include <string>
 #include <stdlib.h>
+#include <string.h>
 
 namespace es2
 {
@@ -41,6 +44,83 @@ namespace es2
 		return buffer;
 	}
 
+	namespace
+	{
+		const unsigned int programBinaryMagic = 0x42505753;   // 'SWPB'
+		const unsigned int programBinaryVersion = 2;          // Increment when the serialized layout changes
+
+		// Binaries are rejected unless produced by the same version with the same shader layout
+		unsigned int programBinaryLayout()
+		{
+			return (unsigned int)(sizeof(sw::Shader::Instruction) << 16) ^ (unsigned int)(sizeof(sw::Shader::Semantic) << 8) ^ (unsigned int)sizeof(void*);
+		}
+
+		unsigned int checksum(const unsigned char *data, size_t size)   // FNV-1a
+		{
+			unsigned int hash = 2166136261u;
+
+			for(size_t i = 0; i < size; i++)
+			{
+				hash = (hash ^ data[i]) * 16777619u;
+			}
+
+			return hash;
+		}
+
+		bool isBoolean(const bool &value)   // Bools read back as part of a struct aren't checked by the deserializer
+		{
+			unsigned char byte;
+			memcpy(&byte, &value, sizeof(byte));
+			return byte <= 1;
+		}
+
+		// Types of uniforms and transform feedback varyings which the utility functions handle
+		bool isVariableType(GLenum type)
+		{
+			switch(type)
+			{
+			case GL_BOOL:
+			case GL_BOOL_VEC2:
+			case GL_BOOL_VEC3:
+			case GL_BOOL_VEC4:
+			case GL_FLOAT:
+			case GL_FLOAT_VEC2:
+			case GL_FLOAT_VEC3:
+			case GL_FLOAT_VEC4:
+			case GL_INT:
+			case GL_INT_VEC2:
+			case GL_INT_VEC3:
+			case GL_INT_VEC4:
+			case GL_UNSIGNED_INT:
+			case GL_UNSIGNED_INT_VEC2:
+			case GL_UNSIGNED_INT_VEC3:
+			case GL_UNSIGNED_INT_VEC4:
+			case GL_FLOAT_MAT2:
+			case GL_FLOAT_MAT2x3:
+			case GL_FLOAT_MAT2x4:
+			case GL_FLOAT_MAT3x2:
+			case GL_FLOAT_MAT3:
+			case GL_FLOAT_MAT3x4:
+			case GL_FLOAT_MAT4x2:
+			case GL_FLOAT_MAT4x3:
+			case GL_FLOAT_MAT4:
+				return true;
+			default:
+				return IsSamplerUniform(type);
+			}
+		}
+
+		// Register indices are either unused (-1) or leave room for the whole uniform
+		bool isValidRegister(short registerIndex, unsigned int registerCount, unsigned int limit)
+		{
+			return registerIndex == -1 || (registerIndex >= 0 && registerCount <= limit && static_cast<unsigned int>(registerIndex) <= limit - registerCount);
+		}
+	}
+
+	Uniform::BlockInfo::BlockInfo() : index(-1), offset(-1), arrayStride(-1), matrixStride(-1), isRowMajorMatrix(false)
+	{
+	}
+
 	Uniform::BlockInfo::BlockInfo(const glsl::Uniform& uniform, int blockIndex)
 	{
 		if(blockIndex >= 0)
@@ -172,6 +252,7 @@ namespace es2
 
 	Program::~Program()
 	{
+		waitForLink();
 		unlink();
 
 		if(vertexShader)
@@ -1226,6 +1307,7 @@ namespace es2
 					transformFeedbackBuffers[index].getOffset() + baseOffset,
 					transformFeedbackLinkedVaryings[index].reg * 4 + transformFeedbackLinkedVaryings[index].col,
 					nbRegs, nbComponentsPerReg, componentStride);
+				transformFeedbackBuffers[index].get()->clearOptimizedIndices();   // The draw overwrites the contents
 				enableTransformFeedback |= 1ULL << index;
 			}
 		}
@@ -1237,6 +1319,7 @@ namespace es2
 			// written by a vertex shader are written, interleaved, into the buffer object
 			// bound to the first transform feedback binding point (index = 0).
 			sw::Resource* resource = transformFeedbackBuffers[0].get()->getResource();
+			transformFeedbackBuffers[0].get()->clearOptimizedIndices();   // The draw overwrites the contents
 			int componentStride = static_cast<int>(totalLinkedVaryingsComponents);
 			int baseOffset = transformFeedbackBuffers[0].getOffset() + (transformFeedback->vertexOffset() * componentStride * sizeof(float));
 			maxVaryings = sw::min(maxVaryings, (unsigned int)sw::MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS);
@@ -1480,6 +1563,44 @@ namespace es2
 	// compiling them into binaries, determining the attribute mappings, and collecting
 	// a list of uniforms
 	void Program::link()
+	{
+		waitForLink();
+
+		// Linking waits for the shaders to finish compiling, and modifying
+		// the shaders waits for the link to complete
+		int clientVersion = egl::getClientVersion();
+
+		linkTask = resourceManager->getWorkerPool()->enqueue([this, clientVersion]()
+		{
+			linkShaders(clientVersion);
+		});
+
+		if(vertexShader)
+		{
+			vertexShader->addLinkTask(linkTask);
+		}
+
+		if(fragmentShader)
+		{
+			fragmentShader->addLinkTask(linkTask);
+		}
+	}
+
+	void Program::waitForLink()
+	{
+		if(linkTask)
+		{
+			linkTask->wait();
+			linkTask.reset();
+		}
+	}
+
+	bool Program::isLinkComplete() const
+	{
+		return !linkTask || linkTask->isDone();
+	}
+
+	void Program::linkShaders(int clientVersion)
 	{
 		unlink();
 
@@ -1503,7 +1624,7 @@ namespace es2
 			return;
 		}
 
-		if(!linkAttributes())
+		if(!linkAttributes(clientVersion))
 		{
 			return;
 		}
@@ -1533,7 +1654,7 @@ namespace es2
 	}
 
 	// Determines the mapping between GL attributes and vertex stream usage indices
-	bool Program::linkAttributes()
+	bool Program::linkAttributes(int clientVersion)
 	{
 		unsigned int usedLocations = 0;
 
@@ -1554,7 +1675,7 @@ namespace es2
 
 				// In GLSL 3.00, attribute aliasing produces a link error
 				// In GLSL 1.00, attribute aliasing is allowed
-				if(egl::getClientVersion() >= 3)
+				if(clientVersion >= 3)
 				{
 					for(int i = 0; i < rows; i++)
 					{
@@ -2506,8 +2627,379 @@ namespace es2
 
 	GLint Program::getBinaryLength() const
 	{
-		UNIMPLEMENTED();
-		return 0;
+		if(!linked)
+		{
+			return 0;
+		}
+
+		std::vector<unsigned char> binary;
+		serialize(binary);
+
+		return static_cast<GLint>(binary.size());
+	}
+
+	// Returns false if the buffer is too small to hold the binary
+	bool Program::getBinary(GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary) const
+	{
+		std::vector<unsigned char> data;
+		serialize(data);
+
+		if(data.size() > static_cast<size_t>(bufSize))
+		{
+			if(length)
+			{
+				*length = 0;
+			}
+
+			return false;
+		}
+
+		memcpy(binary, data.data(), data.size());
+
+		if(length)
+		{
+			*length = static_cast<GLsizei>(data.size());
+		}
+
+		*binaryFormat = GL_PROGRAM_BINARY_SWIFTSHADER;
+
+		return true;
+	}
+
+	// Replaces the linked state with a previously retrieved binary. Uniforms get their initial values.
+	void Program::loadBinary(const void *binary, GLsizei length)
+	{
+		unlink();
+		resetUniformBlockBindings();
+
+		if(!deserialize(binary, length))
+		{
+			unlink();
+			appendToInfoLog("Program binary is invalid or was produced by a different implementation version");
+			return;
+		}
+
+		linked = true;
+	}
+
+	void Program::serialize(std::vector<unsigned char> &binary) const
+	{
+		std::vector<unsigned char> payload;
+		sw::Serializer stream(payload);
+
+		vertexBinary->serialize(stream);
+		pixelBinary->serialize(stream);
+
+		for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+		{
+			stream.write(linkedAttribute[i].type);
+			stream.write(linkedAttribute[i].name);
+			stream.write(linkedAttribute[i].arraySize);
+			stream.write(linkedAttribute[i].location);
+			stream.write(linkedAttribute[i].registerIndex);
+			stream.write(attributeStream[i]);
+		}
+
+		stream.write(samplersPS);
+		stream.write(samplersVS);
+
+		stream.write(static_cast<unsigned int>(uniforms.size()));
+
+		for(const Uniform *uniform : uniforms)
+		{
+			stream.write(uniform->type);
+			stream.write(uniform->precision);
+			stream.write(uniform->name);
+			stream.write(uniform->arraySize);
+			stream.write(uniform->blockInfo);
+			stream.write(uniform->psRegisterIndex);
+			stream.write(uniform->vsRegisterIndex);
+		}
+
+		stream.write(static_cast<unsigned int>(uniformIndex.size()));
+
+		for(const UniformLocation &location : uniformIndex)
+		{
+			stream.write(location.name);
+			stream.write(location.element);
+			stream.write(location.index);
+		}
+
+		stream.write(static_cast<unsigned int>(uniformBlocks.size()));
+
+		for(const UniformBlock *block : uniformBlocks)
+		{
+			stream.write(block->name);
+			stream.write(block->elementIndex);
+			stream.write(block->dataSize);
+			stream.write(static_cast<unsigned int>(block->memberUniformIndexes.size()));
+
+			for(unsigned int member : block->memberUniformIndexes)
+			{
+				stream.write(member);
+			}
+
+			stream.write(block->psRegisterIndex);
+			stream.write(block->vsRegisterIndex);
+		}
+
+		stream.write(transformFeedbackBufferMode);
+		stream.write(static_cast<unsigned int>(totalLinkedVaryingsComponents));
+		stream.write(static_cast<unsigned int>(transformFeedbackLinkedVaryings.size()));
+
+		for(const LinkedVarying &varying : transformFeedbackLinkedVaryings)
+		{
+			stream.write(varying.name);
+			stream.write(varying.type);
+			stream.write(varying.size);
+			stream.write(varying.reg);
+			stream.write(varying.col);
+		}
+
+		sw::Serializer header(binary);
+		header.write(programBinaryMagic);
+		header.write(programBinaryVersion);
+		header.write(std::string(VERSION_STRING));
+		header.write(programBinaryLayout());
+		header.write(static_cast<unsigned int>(payload.size()));
+		header.write(checksum(payload.data(), payload.size()));
+		header.write(payload.data(), payload.size());
+	}
+
+	bool Program::deserialize(const void *binary, GLsizei length)
+	{
+		sw::Deserializer header(binary, length);
+
+		unsigned int magic = 0;
+		unsigned int version = 0;
+		std::string versionString;
+		unsigned int layout = 0;
+		unsigned int payloadSize = 0;
+		unsigned int payloadChecksum = 0;
+
+		header.read(magic);
+		header.read(version);
+		header.read(versionString);
+		header.read(layout);
+		header.read(payloadSize);
+		header.read(payloadChecksum);
+
+		if(header.failed() || magic != programBinaryMagic || version != programBinaryVersion ||
+		   versionString != VERSION_STRING || layout != programBinaryLayout() || payloadSize != header.remaining())
+		{
+			return false;
+		}
+
+		const unsigned char *payload = static_cast<const unsigned char*>(binary) + (length - payloadSize);
+
+		if(checksum(payload, payloadSize) != payloadChecksum)
+		{
+			return false;
+		}
+
+		sw::Deserializer stream(payload, payloadSize);
+
+		vertexBinary = new sw::VertexShader();
+		pixelBinary = new sw::PixelShader();
+
+		if(!vertexBinary->deserialize(stream) || !pixelBinary->deserialize(stream))
+		{
+			return false;
+		}
+
+		for(int i = 0; i < MAX_VERTEX_ATTRIBS; i++)
+		{
+			stream.read(linkedAttribute[i].type);
+			stream.read(linkedAttribute[i].name);
+			stream.read(linkedAttribute[i].arraySize);
+			stream.read(linkedAttribute[i].location);
+			stream.read(linkedAttribute[i].registerIndex);
+			stream.read(attributeStream[i]);
+
+			if(attributeStream[i] < -1 || attributeStream[i] >= MAX_VERTEX_ATTRIBS)
+			{
+				stream.fail();
+			}
+		}
+
+		stream.read(samplersPS);
+		stream.read(samplersVS);
+
+		for(int i = 0; i < MAX_TEXTURE_IMAGE_UNITS; i++)
+		{
+			samplersPS[i].logicalTextureUnit = 0;
+
+			if(!isBoolean(samplersPS[i].active) || (samplersPS[i].active && samplersPS[i].textureType >= TEXTURE_TYPE_COUNT))
+			{
+				stream.fail();
+			}
+		}
+
+		for(int i = 0; i < MAX_VERTEX_TEXTURE_IMAGE_UNITS; i++)
+		{
+			samplersVS[i].logicalTextureUnit = 0;
+
+			if(!isBoolean(samplersVS[i].active) || (samplersVS[i].active && samplersVS[i].textureType >= TEXTURE_TYPE_COUNT))
+			{
+				stream.fail();
+			}
+		}
+
+		unsigned int uniformCount = 0;
+		stream.read(uniformCount);
+
+		for(unsigned int i = 0; i < uniformCount && !stream.failed(); i++)
+		{
+			GLenum type;
+			GLenum precision;
+			std::string name;
+			unsigned int arraySize;
+			Uniform::BlockInfo blockInfo;
+			short psRegisterIndex;
+			short vsRegisterIndex;
+
+			stream.read(type);
+			stream.read(precision);
+			stream.read(name);
+			stream.read(arraySize);
+			stream.read(blockInfo);
+			stream.read(psRegisterIndex);
+			stream.read(vsRegisterIndex);
+
+			// Bound the uniform's storage before allocating it
+			if(!isVariableType(type) || arraySize > MAX_UNIFORM_BLOCK_SIZE || UniformTypeSize(type) * std::max(arraySize, 1u) > MAX_UNIFORM_BLOCK_SIZE)
+			{
+				stream.fail();
+			}
+			else if(IsSamplerUniform(type))
+			{
+				unsigned int samplerCount = std::max(arraySize, 1u);
+
+				if(!isValidRegister(psRegisterIndex, samplerCount, MAX_TEXTURE_IMAGE_UNITS) ||
+				   !isValidRegister(vsRegisterIndex, samplerCount, MAX_VERTEX_TEXTURE_IMAGE_UNITS))
+				{
+					stream.fail();
+				}
+			}
+			else
+			{
+				unsigned int registerCount = VariableRegisterCount(type) * std::max(arraySize, 1u);
+
+				if(!isValidRegister(psRegisterIndex, registerCount, MAX_FRAGMENT_UNIFORM_VECTORS) ||
+				   !isValidRegister(vsRegisterIndex, registerCount, MAX_VERTEX_UNIFORM_VECTORS))
+				{
+					stream.fail();
+				}
+			}
+
+			if(!stream.failed())
+			{
+				Uniform *uniform = new Uniform(type, precision, name, arraySize, blockInfo);
+				uniform->psRegisterIndex = psRegisterIndex;
+				uniform->vsRegisterIndex = vsRegisterIndex;
+				uniforms.push_back(uniform);
+			}
+		}
+
+		unsigned int locationCount = 0;
+		stream.read(locationCount);
+
+		for(unsigned int i = 0; i < locationCount && !stream.failed(); i++)
+		{
+			std::string name;
+			unsigned int element;
+			unsigned int index;
+
+			stream.read(name);
+			stream.read(element);
+			stream.read(index);
+
+			if(index >= uniforms.size() || element >= static_cast<unsigned int>(uniforms[index]->size()))
+			{
+				stream.fail();
+				break;
+			}
+
+			uniformIndex.push_back(UniformLocation(name, element, index));
+		}
+
+		unsigned int blockCount = 0;
+		stream.read(blockCount);
+
+		for(unsigned int i = 0; i < blockCount && !stream.failed(); i++)
+		{
+			std::string name;
+			unsigned int elementIndex;
+			unsigned int dataSize;
+			unsigned int memberCount = 0;
+			std::vector<unsigned int> memberUniformIndexes;
+
+			stream.read(name);
+			stream.read(elementIndex);
+			stream.read(dataSize);
+			stream.read(memberCount);
+
+			for(unsigned int m = 0; m < memberCount && !stream.failed(); m++)
+			{
+				unsigned int member;
+				stream.read(member);
+
+				if(member >= uniforms.size())
+				{
+					stream.fail();
+				}
+
+				memberUniformIndexes.push_back(member);
+			}
+
+			UniformBlock *block = new UniformBlock(name, elementIndex, dataSize, memberUniformIndexes);
+			stream.read(block->psRegisterIndex);
+			stream.read(block->vsRegisterIndex);
+			uniformBlocks.push_back(block);
+
+			if(dataSize > MAX_UNIFORM_BLOCK_SIZE ||
+			   (block->psRegisterIndex != GL_INVALID_INDEX && block->psRegisterIndex >= MAX_FRAGMENT_UNIFORM_BLOCKS) ||
+			   (block->vsRegisterIndex != GL_INVALID_INDEX && block->vsRegisterIndex >= MAX_VERTEX_UNIFORM_BLOCKS))
+			{
+				stream.fail();
+			}
+		}
+
+		unsigned int totalComponents = 0;
+		unsigned int varyingCount = 0;
+
+		stream.read(transformFeedbackBufferMode);
+		stream.read(totalComponents);
+		stream.read(varyingCount);
+
+		totalLinkedVaryingsComponents = totalComponents;
+
+		if((transformFeedbackBufferMode != GL_INTERLEAVED_ATTRIBS && transformFeedbackBufferMode != GL_SEPARATE_ATTRIBS) ||
+		   totalComponents > sw::MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS || varyingCount > MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS)
+		{
+			stream.fail();
+		}
+
+		for(unsigned int i = 0; i < varyingCount && !stream.failed(); i++)
+		{
+			LinkedVarying varying;
+
+			stream.read(varying.name);
+			stream.read(varying.type);
+			stream.read(varying.size);
+			stream.read(varying.reg);
+			stream.read(varying.col);
+
+			if(!isVariableType(varying.type) || IsSamplerUniform(varying.type) || varying.size < 1 || varying.size > sw::MAX_VERTEX_OUTPUTS ||
+			   varying.reg < 0 || varying.reg + VariableRegisterCount(varying.type) * varying.size > sw::MAX_VERTEX_OUTPUTS || varying.col < 0 || varying.col > 3)
+			{
+				stream.fail();
+			}
+
+			transformFeedbackLinkedVaryings.push_back(varying);
+		}
+
+		return !stream.failed() && stream.remaining() == 0;
 	}
 
 	void Program::release()
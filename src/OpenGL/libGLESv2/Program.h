@@ -20,6 +20,7 @@
 
 #include "Shader.h"
 #include "Context.h"
+#include "Common/WorkerPool.hpp"
 #include "Shader/PixelShader.hpp"
 #include "Shader/VertexShader.hpp"
 
@@ -39,6 +40,7 @@ namespace es2
 	{
 		struct BlockInfo
 		{
+			BlockInfo();   // Not part of a uniform block
 			BlockInfo(const glsl::Uniform& uniform, int blockIndex);
 
 			int index;
@@ -176,7 +178,9 @@ namespace es2
 		void applyUniformBuffers(Device *device, BufferBinding* uniformBuffers);
 		void applyTransformFeedback(Device *device, TransformFeedback* transformFeedback);
 
-		void link();
+		void link();   // Links in the background
+		void waitForLink();
+		bool isLinkComplete() const;   // Doesn't wait for the link
 		bool isLinked() const;
 		size_t getInfoLogLength() const;
 		void getInfoLog(GLsizei bufSize, GLsizei *length, char *infoLog);
@@ -216,15 +220,20 @@ namespace es2
 		bool getBinaryRetrievableHint() const { return retrievableBinary; }
 		void setBinaryRetrievable(bool retrievable) { retrievableBinary = retrievable; }
 		GLint getBinaryLength() const;
+		bool getBinary(GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary) const;
+		void loadBinary(const void *binary, GLsizei length);
 
 	private:
+		void linkShaders(int clientVersion);
 		void unlink();
+		void serialize(std::vector<unsigned char> &binary) const;
+		bool deserialize(const void *binary, GLsizei length);
 		void resetUniformBlockBindings();
 
 		bool linkVaryings();
 		bool linkTransformFeedback();
 
-		bool linkAttributes();
+		bool linkAttributes(int clientVersion);
 		int getAttributeBinding(const glsl::Attribute &attribute);
 
 		bool linkUniforms(const Shader *shader);
@@ -305,6 +314,8 @@ namespace es2
 		typedef std::vector<LinkedVarying> LinkedVaryingArray;
 		LinkedVaryingArray transformFeedbackLinkedVaryings;
 
+		std::shared_ptr<sw::Task> linkTask;   // Pending link, if any
+
 		bool linked;
 		bool orphaned;   // Flag to indicate that the program can be deleted when no longer in use
 		char *infoLog;
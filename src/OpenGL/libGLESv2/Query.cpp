@@ -17,11 +17,18 @@
 #include "Query.h"
 
 #include "main.h"
-#include "Common/Thread.hpp"
+#include "Common/Timer.hpp"
 
 namespace es2
 {
 
+static GLuint64 nanoseconds(int64_t counter)
+{
+	const int64_t frequency = sw::Timer::frequency();
+
+	return (GLuint64)(counter / frequency * 1000000000 + counter % frequency * 1000000000 / frequency);
+}
+
 Query::Query(GLuint name, GLenum type) : NamedObject(name)
 {
 	mQuery = nullptr;
@@ -32,7 +39,10 @@ Query::Query(GLuint name, GLenum type) : NamedObject(name)
 
 Query::~Query()
 {
-	delete mQuery;
+	if(mQuery)
+	{
+		mQuery->release();   // Deleted once the draw calls it was issued to have completed
+	}
 }
 
 void Query::begin()
@@ -49,6 +59,9 @@ void Query::begin()
 		case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 			type = sw::Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN;
 			break;
+		case GL_TIME_ELAPSED_EXT:
+			type = sw::Query::TIME_ELAPSED;
+			break;
 		default:
 			UNREACHABLE(mType);
 			return;
@@ -75,6 +88,8 @@ void Query::begin()
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		device->setTransformFeedbackQueryEnabled(true);
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		break;
 	default:
 		ASSERT(false);
 	}
@@ -100,6 +115,8 @@ void Query::end()
 	case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 		device->setTransformFeedbackQueryEnabled(false);
 		break;
+	case GL_TIME_ELAPSED_EXT:
+		break;
 	default:
 		ASSERT(false);
 	}
@@ -108,17 +125,39 @@ void Query::end()
 	mResult = GL_FALSE;
 }
 
-GLuint Query::getResult()
+void Query::queryCounter()
 {
-	if(mQuery)
+	ASSERT(mType == GL_TIMESTAMP_EXT);
+
+	if(!mQuery)
 	{
-		while(!testQuery())
+		mQuery = new sw::Query(sw::Query::TIMESTAMP);
+
+		if(!mQuery)
 		{
-			sw::Thread::yield();
+			return error(GL_OUT_OF_MEMORY);
 		}
 	}
 
-	return (GLuint)mResult;
+	Device *device = getDevice();
+
+	mQuery->begin();
+	mQuery->end();
+	device->addTimestamp(mQuery);
+
+	mStatus = GL_FALSE;
+	mResult = 0;
+}
+
+GLuint64 Query::getResult()
+{
+	if(mQuery)
+	{
+		mQuery->wait(GL_TIMEOUT_IGNORED);
+		testQuery();
+	}
+
+	return mResult;
 }
 
 GLboolean Query::isResultAvailable()
@@ -136,11 +175,16 @@ GLenum Query::getType() const
 	return mType;
 }
 
+GLuint64 Query::getTimestamp()
+{
+	return nanoseconds(sw::Timer::counter());
+}
+
 GLboolean Query::testQuery()
 {
 	if(mQuery != nullptr && mStatus != GL_TRUE)
 	{
-		if(!mQuery->building && mQuery->reference == 0)
+		if(!mQuery->building && mQuery->isSignaled())
 		{
 			unsigned int resultSum = mQuery->data;
 			mStatus = GL_TRUE;
@@ -154,6 +198,12 @@ GLboolean Query::testQuery()
 			case GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 				mResult = resultSum;
 				break;
+			case GL_TIME_ELAPSED_EXT:
+				mResult = mQuery->startTime ? nanoseconds(mQuery->endTime - mQuery->startTime) : 0;
+				break;
+			case GL_TIMESTAMP_EXT:
+				mResult = nanoseconds(mQuery->endTime);
+				break;
 			default:
 				ASSERT(false);
 			}
@@ -33,18 +33,21 @@ public:
 
 	void begin();
 	void end();
-	GLuint getResult();
+	void queryCounter();   // Records a GL_TIMESTAMP_EXT
+	GLuint64 getResult();
 	GLboolean isResultAvailable();
 
 	GLenum getType() const;
 
+	static GLuint64 getTimestamp();   // Current time in nanoseconds, as recorded by timer queries
+
 private:
 	GLboolean testQuery();
 
 	sw::Query* mQuery;
 	GLenum mType;
 	GLboolean mStatus;
-	GLint mResult;
+	GLuint64 mResult;
 };
 
 }
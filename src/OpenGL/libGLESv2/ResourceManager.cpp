@@ -251,9 +251,16 @@ Texture *ResourceManager::getTexture(unsigned int handle)
 	return mTextureNameSpace.find(handle);
 }
 
-Program *ResourceManager::getProgram(unsigned int handle)
+Program *ResourceManager::getProgram(unsigned int handle, bool waitForLink)
 {
-	return mProgramNameSpace.find(handle);
+	Program *programObject = mProgramNameSpace.find(handle);
+
+	if(programObject && waitForLink)
+	{
+		programObject->waitForLink();   // Any use of the program observes the result of linking
+	}
+
+	return programObject;
 }
 
 Renderbuffer *ResourceManager::getRenderbuffer(unsigned int handle)
@@ -347,4 +354,9 @@ bool ResourceManager::isSampler(GLuint sampler)
 	return mSamplerNameSpace.isReserved(sampler);
 }
 
+sw::WorkerPool *ResourceManager::getWorkerPool()
+{
+	return &mWorkerPool;
+}
+
 }
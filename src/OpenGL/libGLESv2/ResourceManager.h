@@ -18,6 +18,7 @@
 #ifndef LIBGLESV2_RESOURCEMANAGER_H_
 #define LIBGLESV2_RESOURCEMANAGER_H_
 
+#include "Common/WorkerPool.hpp"
 #include "common/NameSpace.hpp"
 
 #include <GLES2/gl2.h>
@@ -73,7 +74,7 @@ public:
 
 	Buffer *getBuffer(GLuint handle);
 	Shader *getShader(GLuint handle);
-	Program *getProgram(GLuint handle);
+	Program *getProgram(GLuint handle, bool waitForLink = true);
 	Texture *getTexture(GLuint handle);
 	Renderbuffer *getRenderbuffer(GLuint handle);
 	Sampler *getSampler(GLuint handle);
@@ -86,6 +87,8 @@ public:
 
 	bool isSampler(GLuint sampler);
 
+	sw::WorkerPool *getWorkerPool();
+
 private:
 	std::size_t mRefCount;
 
@@ -97,6 +100,8 @@ private:
 	gl::NameSpace<Renderbuffer> mRenderbufferNameSpace;
 	gl::NameSpace<Sampler> mSamplerNameSpace;
 	gl::NameSpace<FenceSync> mFenceSyncNameSpace;
+
+	sw::WorkerPool mWorkerPool;   // Compiles shaders and links programs
 };
 
 }
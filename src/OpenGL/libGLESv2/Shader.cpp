@@ -21,9 +21,85 @@
 #include "main.h"
 #include "utilities.h"
 
+#include "Common/Math.hpp"
+#include "Common/MutexLock.hpp"
+#include "Renderer/LRUCache.hpp"
+
 #include <string>
 #include <algorithm>
 
+namespace
+{
+	struct CompiledShaderKey
+	{
+		bool operator==(const CompiledShaderKey &key) const
+		{
+			return type == key.type && clientVersion == key.clientVersion && sourceHash == key.sourceHash;
+		}
+
+		GLenum type;
+		int clientVersion;
+		uint64_t sourceHash;
+	};
+
+	// Result of compiling a shader source, or the errors it produced
+	class CompiledShader
+	{
+	public:
+		explicit CompiledShader(const char *source) : source(source), shader(nullptr), references(0)
+		{
+		}
+
+		~CompiledShader()
+		{
+			delete shader;
+		}
+
+		void bind()
+		{
+			references++;
+		}
+
+		void unbind()
+		{
+			if(--references == 0)
+			{
+				delete this;
+			}
+		}
+
+		const std::string source;   // Compared on lookup, to rule out hash collisions
+		sw::Shader *shader;         // Null if the compilation failed
+		std::string infoLog;
+
+		glsl::VaryingList varyings;
+		glsl::ActiveUniforms activeUniforms;
+		glsl::ActiveAttributes activeAttributes;
+		glsl::ActiveUniformBlocks activeUniformBlocks;
+
+	private:
+		int references;
+	};
+
+	// Applications often compile identical shaders repeatedly, e.g. once per
+	// material or on every context creation, so results are kept per process.
+	sw::LRUCache<CompiledShaderKey, CompiledShader> compiledShaders(256);
+	sw::MutexLock compiledShadersMutex;
+
+	CompiledShaderKey compiledShaderKey(GLenum type, int clientVersion, const char *source)
+	{
+		CompiledShaderKey key;
+		key.type = type;
+		key.clientVersion = clientVersion;
+		key.sourceHash = sw::FNV_1a(reinterpret_cast<const unsigned char*>(source), static_cast<int>(strlen(source)));
+
+		return key;
+	}
+
+	sw::MutexLock compilerMutex;   // Guards initialization and release of the compiler globals
+	int activeCompilations = 0;
+}
+
 namespace es2
 {
 bool Shader::compilerInitialized = false;
@@ -40,6 +116,8 @@ Shader::Shader(ResourceManager *manager, GLuint handle) : mHandle(handle), mReso
 
 Shader::~Shader()
 {
+	waitForTasks();
+
 	delete[] mSource;
 }
 
@@ -90,6 +168,8 @@ void Shader::setSource(GLsizei count, const char *const *string, const GLint *le
 
 size_t Shader::getInfoLogLength() const
 {
+	waitForCompile();
+
 	if(infoLog.empty())
 	{
 		return 0;
@@ -102,6 +182,8 @@ size_t Shader::getInfoLogLength() const
 
 void Shader::getInfoLog(GLsizei bufSize, GLsizei *length, char *infoLogOut)
 {
+	waitForCompile();
+
 	int index = 0;
 
 	if(bufSize > 0)
@@ -156,12 +238,6 @@ void Shader::getSource(GLsizei bufSize, GLsizei *length, char *source)
 
 TranslatorASM *Shader::createCompiler(GLenum shaderType)
 {
-	if(!compilerInitialized)
-	{
-		InitCompilerGlobals();
-		compilerInitialized = true;
-	}
-
 	TranslatorASM *assembler = new TranslatorASM(this, shaderType);
 
 	ShBuiltInResources resources;
@@ -194,23 +270,95 @@ void Shader::clear()
 	varyings.clear();
 	activeUniforms.clear();
 	activeAttributes.clear();
+	activeUniformBlocks.clear();
+}
+
+bool Shader::loadCompiled(const char *source, int clientVersion)
+{
+	CompiledShaderKey key = compiledShaderKey(getType(), clientVersion, source);
+
+	LockGuard lock(compiledShadersMutex);
+
+	const CompiledShader *compiled = compiledShaders.query(key);
+
+	if(!compiled || compiled->source != source)
+	{
+		return false;
+	}
+
+	if(compiled->shader)
+	{
+		restoreShader(compiled->shader);
+	}
+	else
+	{
+		deleteShader();
+	}
+
+	infoLog = compiled->infoLog;
+	varyings = compiled->varyings;
+	activeUniforms = compiled->activeUniforms;
+	activeAttributes = compiled->activeAttributes;
+	activeUniformBlocks = compiled->activeUniformBlocks;
+
+	return true;
+}
+
+void Shader::storeCompiled(const char *source, int clientVersion)
+{
+	CompiledShader *compiled = new CompiledShader(source);
+
+	compiled->shader = getShader() ? copyShader() : nullptr;
+	compiled->infoLog = infoLog;
+	compiled->varyings = varyings;
+	compiled->activeUniforms = activeUniforms;
+	compiled->activeAttributes = activeAttributes;
+	compiled->activeUniformBlocks = activeUniformBlocks;
+
+	LockGuard lock(compiledShadersMutex);
+
+	compiledShaders.add(compiledShaderKey(getType(), clientVersion, source), compiled);
 }
 
 void Shader::compile()
 {
+	waitForTasks();
 	clear();
 
-	createShader();
-	TranslatorASM *compiler = createCompiler(getType());
-
 	// Ensure we don't pass a nullptr source to the compiler
-	const char *source = "\0";
-	if(mSource)
+	std::string source = mSource ? mSource : "";
+	int clientVersion = es2::getContext()->getClientVersion();
+
+	if(loadCompiled(source.c_str(), clientVersion))
+	{
+		return;
+	}
+
 	{
-		source = mSource;
+		LockGuard lock(compilerMutex);
+
+		if(!compilerInitialized)
+		{
+			InitCompilerGlobals();
+			compilerInitialized = true;
+		}
+
+		activeCompilations++;
 	}
 
-	bool success = compiler->compile(&source, 1, SH_OBJECT_CODE);
+	compileTask = mResourceManager->getWorkerPool()->enqueue([this, source, clientVersion]()
+	{
+		compile(source, clientVersion);
+	});
+}
+
+void Shader::compile(const std::string &source, int clientVersion)
+{
+	createShader();
+	TranslatorASM *compiler = createCompiler(getType());
+
+	const char *sourceString = source.c_str();
+	bool success = compiler->compile(&sourceString, 1, SH_OBJECT_CODE);
 
 	if(false)
 	{
@@ -218,14 +366,13 @@ void Shader::compile()
 		char buffer[256];
 		sprintf(buffer, "shader-input-%d-%d.txt", getName(), serial);
 		FILE *file = fopen(buffer, "wt");
-		fprintf(file, "%s", mSource);
+		fprintf(file, "%s", sourceString);
 		fclose(file);
 		getShader()->print("shader-output-%d-%d.txt", getName(), serial);
 		serial++;
 	}
 
 	int shaderVersion = compiler->getShaderVersion();
-	int clientVersion = es2::getContext()->getClientVersion();
 
 	if(shaderVersion >= 300 && clientVersion < 3)
 	{
@@ -242,13 +389,59 @@ void Shader::compile()
 	}
 
 	delete compiler;
+
+	storeCompiled(sourceString, clientVersion);
+
+	LockGuard lock(compilerMutex);
+	activeCompilations--;
+}
+
+void Shader::waitForCompile() const
+{
+	if(compileTask)
+	{
+		compileTask->wait();
+	}
+}
+
+// Waits for everything which might still access the compiled shader
+void Shader::waitForTasks()
+{
+	// Links first, since they wait on the compilation themselves
+	for(auto &task : linkTasks)
+	{
+		task->wait();
+	}
+
+	linkTasks.clear();
+
+	if(compileTask)
+	{
+		compileTask->wait();
+		compileTask.reset();
+	}
+}
+
+void Shader::addLinkTask(const std::shared_ptr<sw::Task> &task)
+{
+	// Forget about completed links, for shaders linked into many programs
+	linkTasks.erase(std::remove_if(linkTasks.begin(), linkTasks.end(), [](const std::shared_ptr<sw::Task> &task) { return task->isDone(); }), linkTasks.end());
+
+	linkTasks.push_back(task);
 }
 
 bool Shader::isCompiled()
 {
+	waitForCompile();
+
 	return getShader() != 0;
 }
 
+bool Shader::isCompileComplete() const
+{
+	return !compileTask || compileTask->isDone();
+}
+
 void Shader::addRef()
 {
 	mRefCount++;
@@ -281,8 +474,14 @@ void Shader::flagForDeletion()
 
 void Shader::releaseCompiler()
 {
-	FreeCompilerGlobals();
-	compilerInitialized = false;
+	LockGuard lock(compilerMutex);
+
+	// Releasing the compiler is only a hint, so just skip it while still in use
+	if(compilerInitialized && activeCompilations == 0)
+	{
+		FreeCompilerGlobals();
+		compilerInitialized = false;
+	}
 }
 
 // true if varying x has a higher priority in packing than y
@@ -421,6 +620,17 @@ void VertexShader::deleteShader()
 	vertexShader = nullptr;
 }
 
+sw::Shader *VertexShader::copyShader() const
+{
+	return new sw::VertexShader(vertexShader);
+}
+
+void VertexShader::restoreShader(const sw::Shader *shader)
+{
+	delete vertexShader;
+	vertexShader = new sw::VertexShader(static_cast<const sw::VertexShader*>(shader));
+}
+
 FragmentShader::FragmentShader(ResourceManager *manager, GLuint handle) : Shader(manager, handle)
 {
 	pixelShader = 0;
@@ -458,4 +668,15 @@ void FragmentShader::deleteShader()
 	pixelShader = nullptr;
 }
 
+sw::Shader *FragmentShader::copyShader() const
+{
+	return new sw::PixelShader(pixelShader);
+}
+
+void FragmentShader::restoreShader(const sw::Shader *shader)
+{
+	delete pixelShader;
+	pixelShader = new sw::PixelShader(static_cast<const sw::PixelShader*>(shader));
+}
+
 }
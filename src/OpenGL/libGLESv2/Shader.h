@@ -21,6 +21,7 @@
 #define LIBGLESV2_SHADER_H_
 
 #include "ResourceManager.h"
+#include "Common/WorkerPool.hpp"
 
 #include "compiler/TranslatorASM.h"
 
@@ -57,8 +58,9 @@ public:
 	size_t getSourceLength() const;
 	void getSource(GLsizei bufSize, GLsizei *length, char *source);
 
-	void compile();
+	void compile();   // Compiles in the background
 	bool isCompiled();
+	bool isCompileComplete() const;   // Doesn't wait for the compilation
 
 	void addRef();
 	void release();
@@ -72,6 +74,8 @@ protected:
 	static bool compilerInitialized;
 	TranslatorASM *createCompiler(GLenum shaderType);
 	void clear();
+	bool loadCompiled(const char *source, int clientVersion);
+	void storeCompiled(const char *source, int clientVersion);
 
 	static bool compareVarying(const glsl::Varying &x, const glsl::Varying &y);
 
@@ -81,6 +85,16 @@ protected:
 private:
 	virtual void createShader() = 0;
 	virtual void deleteShader() = 0;
+	virtual sw::Shader *copyShader() const = 0;
+	virtual void restoreShader(const sw::Shader *shader) = 0;   // Replaces the shader with a copy
+
+	void compile(const std::string &source, int clientVersion);
+	void waitForCompile() const;
+	void waitForTasks();
+	void addLinkTask(const std::shared_ptr<sw::Task> &task);
+
+	std::shared_ptr<sw::Task> compileTask;              // Pending compilation, if any
+	std::vector<std::shared_ptr<sw::Task>> linkTasks;   // Pending links reading the compiled shader
 
 	const GLuint mHandle;
 	unsigned int mRefCount;     // Number of program objects this shader is attached to
@@ -107,6 +121,8 @@ public:
 private:
 	virtual void createShader();
 	virtual void deleteShader();
+	virtual sw::Shader *copyShader() const;
+	virtual void restoreShader(const sw::Shader *shader);
 
 	sw::VertexShader *vertexShader;
 };
@@ -126,6 +142,8 @@ public:
 private:
 	virtual void createShader();
 	virtual void deleteShader();
+	virtual sw::Shader *copyShader() const;
+	virtual void restoreShader(const sw::Shader *shader);
 
 	sw::PixelShader *pixelShader;
 };
@@ -183,6 +183,7 @@ void BeginQueryEXT(GLenum target, GLuint name)
 	{
 	case GL_ANY_SAMPLES_PASSED_EXT:
 	case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:
+	case GL_TIME_ELAPSED_EXT:
 		break;
 	default:
 		return error(GL_INVALID_ENUM);
@@ -197,6 +198,11 @@ void BeginQueryEXT(GLenum target, GLuint name)
 
 	if(context)
 	{
+		if(target == GL_TIME_ELAPSED_EXT && !context->hasTimerQueries())
+		{
+			return error(GL_INVALID_ENUM);
+		}
+
 		context->beginQuery(target, name);
 	}
 }
@@ -1885,6 +1891,7 @@ void EndQueryEXT(GLenum target)
 	{
 	case GL_ANY_SAMPLES_PASSED_EXT:
 	case GL_ANY_SAMPLES_PASSED_CONSERVATIVE_EXT:
+	case GL_TIME_ELAPSED_EXT:
 		break;
 	default:
 		return error(GL_INVALID_ENUM);
@@ -1894,6 +1901,11 @@ void EndQueryEXT(GLenum target)
 
 	if(context)
 	{
+		if(target == GL_TIME_ELAPSED_EXT && !context->hasTimerQueries())
+		{
+			return error(GL_INVALID_ENUM);
+		}
+
 		context->endQuery(target);
 	}
 }
@@ -3150,7 +3162,7 @@ void GetProgramiv(GLuint program, GLenum pname, GLint* params)
 
 	if(context)
 	{
-		es2::Program *programObject = context->getProgram(program);
+		es2::Program *programObject = context->getProgram(program, pname != GL_COMPLETION_STATUS_KHR);
 
 		if(!programObject)
 		{
@@ -3174,6 +3186,9 @@ void GetProgramiv(GLuint program, GLenum pname, GLint* params)
 		case GL_LINK_STATUS:
 			*params = programObject->isLinked();
 			return;
+		case GL_COMPLETION_STATUS_KHR:
+			*params = programObject->isLinkComplete();
+			return;
 		case GL_VALIDATE_STATUS:
 			*params = programObject->isValidated();
 			return;
@@ -3290,6 +3305,16 @@ void GetQueryivEXT(GLenum target, GLenum pname, GLint *params)
 	{
 	case GL_CURRENT_QUERY_EXT:
 		break;
+	case GL_QUERY_COUNTER_BITS_EXT:
+		switch(target)
+		{
+		case GL_TIME_ELAPSED_EXT:
+		case GL_TIMESTAMP_EXT:
+			break;
+		default:
+			return error(GL_INVALID_ENUM);
+		}
+		break;
 	default:
 		return error(GL_INVALID_ENUM);
 	}
@@ -3298,14 +3323,25 @@ void GetQueryivEXT(GLenum target, GLenum pname, GLint *params)
 
 	if(context)
 	{
-		params[0] = context->getActiveQuery(target);
+		if((target == GL_TIME_ELAPSED_EXT || target == GL_TIMESTAMP_EXT) && !context->hasTimerQueries())
+		{
+			return error(GL_INVALID_ENUM);
+		}
+
+		if(pname == GL_QUERY_COUNTER_BITS_EXT)
+		{
+			params[0] = 64;
+		}
+		else
+		{
+			params[0] = context->getActiveQuery(target);
+		}
 	}
 }
 
-void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
+template<typename T>
+static void GetQueryObject(GLuint name, GLenum pname, T *params)
 {
-	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLuint *params = %p)", name, pname, params);
-
 	switch(pname)
 	{
 	case GL_QUERY_RESULT_EXT:
@@ -3334,7 +3370,7 @@ void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
 		switch(pname)
 		{
 		case GL_QUERY_RESULT_EXT:
-			params[0] = queryObject->getResult();
+			params[0] = (T)queryObject->getResult();
 			break;
 		case GL_QUERY_RESULT_AVAILABLE_EXT:
 			params[0] = queryObject->isResultAvailable();
@@ -3345,6 +3381,34 @@ void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
 	}
 }
 
+void GetQueryObjectivEXT(GLuint name, GLenum pname, GLint *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLint *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
+void GetQueryObjectuivEXT(GLuint name, GLenum pname, GLuint *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLuint *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
+void GetQueryObjecti64vEXT(GLuint name, GLenum pname, GLint64 *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLint64 *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
+void GetQueryObjectui64vEXT(GLuint name, GLenum pname, GLuint64 *params)
+{
+	TRACE("(GLuint name = %d, GLenum pname = 0x%X, GLuint64 *params = %p)", name, pname, params);
+
+	GetQueryObject(name, pname, params);
+}
+
 void GetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
 {
 	TRACE("(GLenum target = 0x%X, GLenum pname = 0x%X, GLint* params = %p)", target, pname, params);
@@ -3416,6 +3480,9 @@ void GetShaderiv(GLuint shader, GLenum pname, GLint* params)
 		case GL_COMPILE_STATUS:
 			*params = shaderObject->isCompiled() ? GL_TRUE : GL_FALSE;
 			return;
+		case GL_COMPLETION_STATUS_KHR:
+			*params = shaderObject->isCompileComplete() ? GL_TRUE : GL_FALSE;
+			return;
 		case GL_INFO_LOG_LENGTH:
 			*params = (GLint)shaderObject->getInfoLogLength();
 			return;
@@ -6854,6 +6921,45 @@ void DrawBuffersEXT(GLsizei n, const GLenum *bufs)
 	}
 }
 
+void MaxShaderCompilerThreadsKHR(GLuint count)
+{
+	TRACE("(GLuint count = %d)", count);
+
+	es2::Context *context = es2::getContext();
+
+	if(context)
+	{
+		context->setMaxShaderCompilerThreads(count);
+	}
+}
+
+void QueryCounterEXT(GLuint name, GLenum target)
+{
+	TRACE("(GLuint name = %d, GLenum target = 0x%X)", name, target);
+
+	if(target != GL_TIMESTAMP_EXT)
+	{
+		return error(GL_INVALID_ENUM);
+	}
+
+	es2::Context *context = es2::getContext();
+
+	if(context)
+	{
+		if(!context->hasTimerQueries())
+		{
+			return error(GL_INVALID_ENUM);
+		}
+
+		context->queryCounter(name, target);
+	}
+}
+
+void GetInteger64vEXT(GLenum pname, GLint64 *data)
+{
+	glGetInteger64v(pname, data);   // Also takes GL_TIMESTAMP_EXT and GL_GPU_DISJOINT_EXT
+}
+
 }
 
 extern "C" NO_SANITIZE_FUNCTION __eglMustCastToProperFunctionPointerType es2GetProcAddress(const char *procname)
@@ -6914,6 +7020,12 @@ extern "C" NO_SANITIZE_FUNCTION __eglMustCastToProperFunctionPointerType es2GetP
 		EXTENSION(glGetFramebufferAttachmentParameterivOES),
 		EXTENSION(glGenerateMipmapOES),
 		EXTENSION(glDrawBuffersEXT),
+		EXTENSION(glMaxShaderCompilerThreadsKHR),
+		EXTENSION(glQueryCounterEXT),
+		EXTENSION(glGetQueryObjectivEXT),
+		EXTENSION(glGetQueryObjecti64vEXT),
+		EXTENSION(glGetQueryObjectui64vEXT),
+		EXTENSION(glGetInteger64vEXT),
 
 		#undef EXTENSION
 	};
@@ -241,6 +241,12 @@ public:
 	void (*glGetFramebufferAttachmentParameterivOES)(GLenum target, GLenum attachment, GLenum pname, GLint* params);
 	void (*glGenerateMipmapOES)(GLenum target);
 	void (*glDrawBuffersEXT)(GLsizei n, const GLenum *bufs);
+	void (*glMaxShaderCompilerThreadsKHR)(GLuint count);
+	void (*glQueryCounterEXT)(GLuint name, GLenum target);
+	void (*glGetQueryObjectivEXT)(GLuint name, GLenum pname, GLint *params);
+	void (*glGetQueryObjecti64vEXT)(GLuint name, GLenum pname, GLint64 *params);
+	void (*glGetQueryObjectui64vEXT)(GLuint name, GLenum pname, GLuint64 *params);
+	void (*glGetInteger64vEXT)(GLenum pname, GLint64 *data);
 
 	egl::Context *(*es2CreateContext)(egl::Display *display, const egl::Context *shareContext, int clientVersion, const egl::Config *config);
 	__eglMustCastToProperFunctionPointerType (*es2GetProcAddress)(const char *procname);
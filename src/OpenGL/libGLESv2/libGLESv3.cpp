@@ -1593,7 +1593,7 @@ GL_APICALL void *GL_APIENTRY glMapBufferRange(GLenum target, GLintptr offset, GL
 		GLsizeiptr bufferSize = buffer->size();
 		if((offset < 0) || (length < 0) || ((offset + length) > bufferSize))
 		{
-			error(GL_INVALID_VALUE);
+			return error(GL_INVALID_VALUE, nullptr);
 		}
 
 		if((access & ~(GL_MAP_READ_BIT |
@@ -1603,7 +1603,28 @@ GL_APICALL void *GL_APIENTRY glMapBufferRange(GLenum target, GLintptr offset, GL
 		               GL_MAP_FLUSH_EXPLICIT_BIT |
 		               GL_MAP_UNSYNCHRONIZED_BIT)) != 0)
 		{
-			error(GL_INVALID_VALUE);
+			return error(GL_INVALID_VALUE, nullptr);
+		}
+
+		if(length == 0 || buffer->isMapped())
+		{
+			return error(GL_INVALID_OPERATION, nullptr);
+		}
+
+		if(!(access & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT)))
+		{
+			return error(GL_INVALID_OPERATION, nullptr);
+		}
+
+		// Reading is incompatible with discarding or racing the contents
+		if((access & GL_MAP_READ_BIT) && (access & (GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT)))
+		{
+			return error(GL_INVALID_OPERATION, nullptr);
+		}
+
+		if((access & GL_MAP_FLUSH_EXPLICIT_BIT) && !(access & GL_MAP_WRITE_BIT))
+		{
+			return error(GL_INVALID_OPERATION, nullptr);
 		}
 
 		return buffer->mapRange(offset, length, access);
@@ -1633,10 +1654,15 @@ GL_APICALL void GL_APIENTRY glFlushMappedBufferRange(GLenum target, GLintptr off
 			return error(GL_INVALID_OPERATION);
 		}
 
-		GLsizeiptr bufferSize = buffer->size();
-		if((offset < 0) || (length < 0) || ((offset + length) > bufferSize))
+		if(!buffer->isMapped() || !(buffer->access() & GL_MAP_FLUSH_EXPLICIT_BIT))
+		{
+			return error(GL_INVALID_OPERATION);
+		}
+
+		// Relative to the mapped range
+		if((offset < 0) || (length < 0) || ((offset + length) > buffer->length()))
 		{
-			error(GL_INVALID_VALUE);
+			return error(GL_INVALID_VALUE);
 		}
 
 		buffer->flushMappedRange(offset, length);
@@ -3619,7 +3645,22 @@ GL_APICALL void GL_APIENTRY glGetProgramBinary(GLuint program, GLsizei bufSize,
 		return error(GL_INVALID_VALUE);
 	}
 
-	UNIMPLEMENTED();
+	es2::Context *context = es2::getContext();
+
+	if(context)
+	{
+		es2::Program *programObject = context->getProgram(program);
+
+		if(!programObject || !programObject->isLinked())
+		{
+			return error(GL_INVALID_OPERATION);
+		}
+
+		if(!programObject->getBinary(bufSize, length, binaryFormat, binary))
+		{
+			return error(GL_INVALID_OPERATION);
+		}
+	}
 }
 
 GL_APICALL void GL_APIENTRY glProgramBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length)
@@ -3632,7 +3673,24 @@ GL_APICALL void GL_APIENTRY glProgramBinary(GLuint program, GLenum binaryFormat,
 		return error(GL_INVALID_VALUE);
 	}
 
-	UNIMPLEMENTED();
+	if(binaryFormat != GL_PROGRAM_BINARY_SWIFTSHADER)
+	{
+		return error(GL_INVALID_ENUM);
+	}
+
+	es2::Context *context = es2::getContext();
+
+	if(context)
+	{
+		es2::Program *programObject = context->getProgram(program);
+
+		if(!programObject)
+		{
+			return error(GL_INVALID_OPERATION);
+		}
+
+		programObject->loadBinary(binary, length);
+	}
 }
 
 GL_APICALL void GL_APIENTRY glProgramParameteri(GLuint program, GLenum pname, GLint value)
@@ -17,6 +17,7 @@
 #include "main.h"
 
 #include "libGLESv2.hpp"
+#include "CommandQueue.h"
 #include "Framebuffer.h"
 #include "libEGL/main.h"
 #include "common/Surface.hpp"
@@ -24,6 +25,8 @@
 #include "Common/SharedLibrary.hpp"
 #include "common/debug.h"
 
+#include <string.h>
+
 #if !defined(_MSC_VER)
 #define CONSTRUCTOR __attribute__((constructor))
 #define DESTRUCTOR __attribute__((destructor))
@@ -83,7 +86,7 @@ extern "C" BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved
 
 namespace es2
 {
-es2::Context *getContext()
+static es2::Context *getCurrentContext()
 {
 	egl::Context *context = libEGL->clientGetCurrentContext();
 
@@ -96,6 +99,104 @@ es2::Context *getContext()
 	return nullptr;
 }
 
+es2::Context *getContext()
+{
+	es2::Context *context = CommandQueue::getServerContext();
+
+	if(context)   // Executing recorded commands
+	{
+		return context;
+	}
+
+	context = getCurrentContext();
+	CommandQueue *commandQueue = context ? context->getCommandQueue() : nullptr;
+
+	if(commandQueue)
+	{
+		commandQueue->synchronize();   // Commands which aren't recorded execute after all earlier ones
+	}
+
+	return context;
+}
+
+// Returns the queue to record commands into, if the current context executes them on a server thread
+static CommandQueue *getCommandQueue()
+{
+	es2::Context *context = getCurrentContext();
+
+	return context ? context->getCommandQueue() : nullptr;
+}
+
+template<typename... Parameters, typename... Arguments>
+static void dispatch(void (*function)(Parameters...), Arguments... arguments)
+{
+	CommandQueue *commandQueue = getCommandQueue();
+
+	if(commandQueue)
+	{
+		commandQueue->record([=]() { function(arguments...); });
+	}
+	else
+	{
+		function(arguments...);
+	}
+}
+
+template<typename... Parameters, typename... Arguments>
+static void dispatchDraw(bool indexed, void (*function)(Parameters...), Arguments... arguments)
+{
+	CommandQueue *commandQueue = getCommandQueue();
+
+	if(commandQueue && commandQueue->canRecordDraw(indexed))
+	{
+		commandQueue->record([=]() { function(arguments...); });
+	}
+	else
+	{
+		function(arguments...);
+	}
+}
+
+// Copy of a uniform array small enough to be recorded
+template<typename T>
+struct UniformValues
+{
+	T values[16];
+};
+
+template<typename T>
+static void dispatchUniform(void (*function)(GLint, GLsizei, const T*), int components, GLint location, GLsizei count, const T *v)
+{
+	CommandQueue *commandQueue = getCommandQueue();
+
+	if(commandQueue && count > 0 && count * components <= 16)
+	{
+		UniformValues<T> copy;
+		memcpy(copy.values, v, count * components * sizeof(T));
+		commandQueue->record([=]() { function(location, count, copy.values); });
+	}
+	else
+	{
+		function(location, count, v);
+	}
+}
+
+static void dispatchUniformMatrix(void (*function)(GLint, GLsizei, GLboolean, const GLfloat*), int components, GLint location, GLsizei count, GLboolean transpose, const GLfloat *value)
+{
+	CommandQueue *commandQueue = getCommandQueue();
+
+	if(commandQueue && count > 0 && count * components <= 16)
+	{
+		UniformValues<GLfloat> copy;
+		memcpy(copy.values, value, count * components * sizeof(GLfloat));
+		commandQueue->record([=]() { function(location, count, transpose, copy.values); });
+	}
+	else
+	{
+		function(location, count, transpose, value);
+	}
+}
+
 Device *getDevice()
 {
 	Context *context = getContext();
@@ -142,7 +243,12 @@ namespace egl
 {
 GLint getClientVersion()
 {
-	Context *context = libEGL->clientGetCurrentContext();
+	Context *context = es2::CommandQueue::getServerContext();
+
+	if(!context)
+	{
+		context = libEGL->clientGetCurrentContext();
+	}
 
 	return context ? context->getClientVersion() : 0;
 }
@@ -351,13 +457,19 @@ GL_APICALL void FramebufferTexture2DOES(GLenum target, GLenum attachment, GLenum
 GL_APICALL void GetFramebufferAttachmentParameterivOES(GLenum target, GLenum attachment, GLenum pname, GLint* params);
 GL_APICALL void GenerateMipmapOES(GLenum target);
 GL_APICALL void DrawBuffersEXT(GLsizei n, const GLenum *bufs);
+GL_APICALL void MaxShaderCompilerThreadsKHR(GLuint count);
+GL_APICALL void QueryCounterEXT(GLuint name, GLenum target);
+GL_APICALL void GetQueryObjectivEXT(GLuint name, GLenum pname, GLint *params);
+GL_APICALL void GetQueryObjecti64vEXT(GLuint name, GLenum pname, GLint64 *params);
+GL_APICALL void GetQueryObjectui64vEXT(GLuint name, GLenum pname, GLuint64 *params);
+GL_APICALL void GetInteger64vEXT(GLenum pname, GLint64 *data);
 }
 
 extern "C"
 {
 GL_APICALL void GL_APIENTRY glActiveTexture(GLenum texture)
 {
-	return es2::ActiveTexture(texture);
+	return es2::dispatch(es2::ActiveTexture, texture);
 }
 
 GL_APICALL void GL_APIENTRY glAttachShader(GLuint program, GLuint shader)
@@ -377,12 +489,19 @@ GL_APICALL void GL_APIENTRY glBindAttribLocation(GLuint program, GLuint index, c
 
 GL_APICALL void GL_APIENTRY glBindBuffer(GLenum target, GLuint buffer)
 {
-	return es2::BindBuffer(target, buffer);
+	es2::CommandQueue *commandQueue = es2::getCommandQueue();
+
+	if(commandQueue && target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		commandQueue->bindElementArrayBuffer(buffer);
+	}
+
+	return es2::dispatch(es2::BindBuffer, target, buffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer)
 {
-	return es2::BindFramebuffer(target, framebuffer);
+	return es2::dispatch(es2::BindFramebuffer, target, framebuffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindFramebufferOES(GLenum target, GLuint framebuffer)
@@ -392,7 +511,7 @@ GL_APICALL void GL_APIENTRY glBindFramebufferOES(GLenum target, GLuint framebuff
 
 GL_APICALL void GL_APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer)
 {
-	return es2::BindRenderbuffer(target, renderbuffer);
+	return es2::dispatch(es2::BindRenderbuffer, target, renderbuffer);
 }
 
 GL_APICALL void GL_APIENTRY glBindRenderbufferOES(GLenum target, GLuint renderbuffer)
@@ -402,32 +521,32 @@ GL_APICALL void GL_APIENTRY glBindRenderbufferOES(GLenum target, GLuint renderbu
 
 GL_APICALL void GL_APIENTRY glBindTexture(GLenum target, GLuint texture)
 {
-	return es2::BindTexture(target, texture);
+	return es2::dispatch(es2::BindTexture, target, texture);
 }
 
 GL_APICALL void GL_APIENTRY glBlendColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
-	return es2::BlendColor(red, green, blue, alpha);
+	return es2::dispatch(es2::BlendColor, red, green, blue, alpha);
 }
 
 GL_APICALL void GL_APIENTRY glBlendEquation(GLenum mode)
 {
-	return es2::BlendEquation(mode);
+	return es2::dispatch(es2::BlendEquation, mode);
 }
 
 GL_APICALL void GL_APIENTRY glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
 {
-	return es2::BlendEquationSeparate(modeRGB, modeAlpha);
+	return es2::dispatch(es2::BlendEquationSeparate, modeRGB, modeAlpha);
 }
 
 GL_APICALL void GL_APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
 {
-	return es2::BlendFunc(sfactor, dfactor);
+	return es2::dispatch(es2::BlendFunc, sfactor, dfactor);
 }
 
 GL_APICALL void GL_APIENTRY glBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
 {
-	return es2::BlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+	return es2::dispatch(es2::BlendFuncSeparate, srcRGB, dstRGB, srcAlpha, dstAlpha);
 }
 
 GL_APICALL void GL_APIENTRY glBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
@@ -452,27 +571,27 @@ GL_APICALL GLenum GL_APIENTRY glCheckFramebufferStatusOES(GLenum target)
 
 GL_APICALL void GL_APIENTRY glClear(GLbitfield mask)
 {
-	return es2::Clear(mask);
+	return es2::dispatch(es2::Clear, mask);
 }
 
 GL_APICALL void GL_APIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
 {
-	return es2::ClearColor(red, green, blue, alpha);
+	return es2::dispatch(es2::ClearColor, red, green, blue, alpha);
 }
 
 GL_APICALL void GL_APIENTRY glClearDepthf(GLclampf depth)
 {
-	return es2::ClearDepthf(depth);
+	return es2::dispatch(es2::ClearDepthf, depth);
 }
 
 GL_APICALL void GL_APIENTRY glClearStencil(GLint s)
 {
-	return es2::ClearStencil(s);
+	return es2::dispatch(es2::ClearStencil, s);
 }
 
 GL_APICALL void GL_APIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
 {
-	return es2::ColorMask(red, green, blue, alpha);
+	return es2::dispatch(es2::ColorMask, red, green, blue, alpha);
 }
 
 GL_APICALL void GL_APIENTRY glCompileShader(GLuint shader)
@@ -514,7 +633,7 @@ GL_APICALL GLuint GL_APIENTRY glCreateShader(GLenum type)
 
 GL_APICALL void GL_APIENTRY glCullFace(GLenum mode)
 {
-	return es2::CullFace(mode);
+	return es2::dispatch(es2::CullFace, mode);
 }
 
 GL_APICALL void GL_APIENTRY glDeleteBuffers(GLsizei n, const GLuint* buffers)
@@ -569,17 +688,17 @@ GL_APICALL void GL_APIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
 
 GL_APICALL void GL_APIENTRY glDepthFunc(GLenum func)
 {
-	return es2::DepthFunc(func);
+	return es2::dispatch(es2::DepthFunc, func);
 }
 
 GL_APICALL void GL_APIENTRY glDepthMask(GLboolean flag)
 {
-	return es2::DepthMask(flag);
+	return es2::dispatch(es2::DepthMask, flag);
 }
 
 GL_APICALL void GL_APIENTRY glDepthRangef(GLclampf zNear, GLclampf zFar)
 {
-	return es2::DepthRangef(zNear, zFar);
+	return es2::dispatch(es2::DepthRangef, zNear, zFar);
 }
 
 GL_APICALL void GL_APIENTRY glDetachShader(GLuint program, GLuint shader)
@@ -589,32 +708,39 @@ GL_APICALL void GL_APIENTRY glDetachShader(GLuint program, GLuint shader)
 
 GL_APICALL void GL_APIENTRY glDisable(GLenum cap)
 {
-	return es2::Disable(cap);
+	return es2::dispatch(es2::Disable, cap);
 }
 
 GL_APICALL void GL_APIENTRY glDisableVertexAttribArray(GLuint index)
 {
-	return es2::DisableVertexAttribArray(index);
+	es2::CommandQueue *commandQueue = es2::getCommandQueue();
+
+	if(commandQueue)
+	{
+		commandQueue->enableVertexAttribArray(index, false);
+	}
+
+	return es2::dispatch(es2::DisableVertexAttribArray, index);
 }
 
 GL_APICALL void GL_APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
 {
-	return es2::DrawArrays(mode, first, count);
+	return es2::dispatchDraw(false, es2::DrawArrays, mode, first, count);
 }
 
 GL_APICALL void GL_APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
 {
-	return es2::DrawElements(mode, count, type, indices);
+	return es2::dispatchDraw(true, es2::DrawElements, mode, count, type, indices);
 }
 
 GL_APICALL void GL_APIENTRY glDrawArraysInstancedEXT(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
 {
-	return es2::DrawArraysInstancedEXT(mode, first, count, instanceCount);
+	return es2::dispatchDraw(false, es2::DrawArraysInstancedEXT, mode, first, count, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glDrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount)
 {
-	return es2::DrawElementsInstancedEXT(mode, count, type, indices, instanceCount);
+	return es2::dispatchDraw(true, es2::DrawElementsInstancedEXT, mode, count, type, indices, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttribDivisorEXT(GLuint index, GLuint divisor)
@@ -624,12 +750,12 @@ GL_APICALL void GL_APIENTRY glVertexAttribDivisorEXT(GLuint index, GLuint diviso
 
 GL_APICALL void GL_APIENTRY glDrawArraysInstancedANGLE(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
 {
-	return es2::DrawArraysInstancedANGLE(mode, first, count, instanceCount);
+	return es2::dispatchDraw(false, es2::DrawArraysInstancedANGLE, mode, first, count, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glDrawElementsInstancedANGLE(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instanceCount)
 {
-	return es2::DrawElementsInstancedANGLE(mode, count, type, indices, instanceCount);
+	return es2::dispatchDraw(true, es2::DrawElementsInstancedANGLE, mode, count, type, indices, instanceCount);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttribDivisorANGLE(GLuint index, GLuint divisor)
@@ -639,12 +765,19 @@ GL_APICALL void GL_APIENTRY glVertexAttribDivisorANGLE(GLuint index, GLuint divi
 
 GL_APICALL void GL_APIENTRY glEnable(GLenum cap)
 {
-	return es2::Enable(cap);
+	return es2::dispatch(es2::Enable, cap);
 }
 
 GL_APICALL void GL_APIENTRY glEnableVertexAttribArray(GLuint index)
 {
-	return es2::EnableVertexAttribArray(index);
+	es2::CommandQueue *commandQueue = es2::getCommandQueue();
+
+	if(commandQueue)
+	{
+		commandQueue->enableVertexAttribArray(index, true);
+	}
+
+	return es2::dispatch(es2::EnableVertexAttribArray, index);
 }
 
 GL_APICALL void GL_APIENTRY glEndQueryEXT(GLenum target)
@@ -689,7 +822,7 @@ GL_APICALL void GL_APIENTRY glFramebufferTexture2DOES(GLenum target, GLenum atta
 
 GL_APICALL void GL_APIENTRY glFrontFace(GLenum mode)
 {
-	return es2::FrontFace(mode);
+	return es2::dispatch(es2::FrontFace, mode);
 }
 
 GL_APICALL void GL_APIENTRY glGenBuffers(GLsizei n, GLuint* buffers)
@@ -914,7 +1047,7 @@ GL_APICALL void GL_APIENTRY glGetVertexAttribPointerv(GLuint index, GLenum pname
 
 GL_APICALL void GL_APIENTRY glHint(GLenum target, GLenum mode)
 {
-	return es2::Hint(target, mode);
+	return es2::dispatch(es2::Hint, target, mode);
 }
 
 GL_APICALL GLboolean GL_APIENTRY glIsBuffer(GLuint buffer)
@@ -974,7 +1107,7 @@ GL_APICALL GLboolean GL_APIENTRY glIsTexture(GLuint texture)
 
 GL_APICALL void GL_APIENTRY glLineWidth(GLfloat width)
 {
-	return es2::LineWidth(width);
+	return es2::dispatch(es2::LineWidth, width);
 }
 
 GL_APICALL void GL_APIENTRY glLinkProgram(GLuint program)
@@ -989,7 +1122,7 @@ GL_APICALL void GL_APIENTRY glPixelStorei(GLenum pname, GLint param)
 
 GL_APICALL void GL_APIENTRY glPolygonOffset(GLfloat factor, GLfloat units)
 {
-	return es2::PolygonOffset(factor, units);
+	return es2::dispatch(es2::PolygonOffset, factor, units);
 }
 
 GL_APICALL void GL_APIENTRY glReadnPixelsEXT(GLint x, GLint y, GLsizei width, GLsizei height,
@@ -1030,7 +1163,7 @@ GL_APICALL void GL_APIENTRY glRenderbufferStorageOES(GLenum target, GLenum inter
 
 GL_APICALL void GL_APIENTRY glSampleCoverage(GLclampf value, GLboolean invert)
 {
-	return es2::SampleCoverage(value, invert);
+	return es2::dispatch(es2::SampleCoverage, value, invert);
 }
 
 GL_APICALL void GL_APIENTRY glSetFenceNV(GLuint fence, GLenum condition)
@@ -1040,7 +1173,7 @@ GL_APICALL void GL_APIENTRY glSetFenceNV(GLuint fence, GLenum condition)
 
 GL_APICALL void GL_APIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
 {
-	return es2::Scissor(x, y, width, height);
+	return es2::dispatch(es2::Scissor, x, y, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glShaderBinary(GLsizei n, const GLuint* shaders, GLenum binaryformat, const GLvoid* binary, GLsizei length)
@@ -1055,32 +1188,32 @@ GL_APICALL void GL_APIENTRY glShaderSource(GLuint shader, GLsizei count, const G
 
 GL_APICALL void GL_APIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask)
 {
-	return es2::StencilFunc(func, ref, mask);
+	return es2::dispatch(es2::StencilFunc, func, ref, mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask)
 {
-	return es2::StencilFuncSeparate(face, func, ref, mask);
+	return es2::dispatch(es2::StencilFuncSeparate, face, func, ref, mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilMask(GLuint mask)
 {
-	return es2::StencilMask(mask);
+	return es2::dispatch(es2::StencilMask, mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilMaskSeparate(GLenum face, GLuint mask)
 {
-	return es2::StencilMaskSeparate(face, mask);
+	return es2::dispatch(es2::StencilMaskSeparate, face, mask);
 }
 
 GL_APICALL void GL_APIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
 {
-	return es2::StencilOp(fail, zfail, zpass);
+	return es2::dispatch(es2::StencilOp, fail, zfail, zpass);
 }
 
 GL_APICALL void GL_APIENTRY glStencilOpSeparate(GLenum face, GLenum fail, GLenum zfail, GLenum zpass)
 {
-	return es2::StencilOpSeparate(face, fail, zfail, zpass);
+	return es2::dispatch(es2::StencilOpSeparate, face, fail, zfail, zpass);
 }
 
 GLboolean GL_APIENTRY glTestFenceNV(GLuint fence)
@@ -1096,7 +1229,7 @@ GL_APICALL void GL_APIENTRY glTexImage2D(GLenum target, GLint level, GLint inter
 
 GL_APICALL void GL_APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param)
 {
-	return es2::TexParameterf(target, pname, param);
+	return es2::dispatch(es2::TexParameterf, target, pname, param);
 }
 
 GL_APICALL void GL_APIENTRY glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params)
@@ -1106,7 +1239,7 @@ GL_APICALL void GL_APIENTRY glTexParameterfv(GLenum target, GLenum pname, const
 
 GL_APICALL void GL_APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
 {
-	return es2::TexParameteri(target, pname, param);
+	return es2::dispatch(es2::TexParameteri, target, pname, param);
 }
 
 GL_APICALL void GL_APIENTRY glTexParameteriv(GLenum target, GLenum pname, const GLint* params)
@@ -1122,102 +1255,102 @@ GL_APICALL void GL_APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xo
 
 GL_APICALL void GL_APIENTRY glUniform1f(GLint location, GLfloat x)
 {
-	return es2::Uniform1f(location, x);
+	return es2::dispatch(es2::Uniform1f, location, x);
 }
 
 GL_APICALL void GL_APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat* v)
 {
-	return es2::Uniform1fv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform1fv, 1, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform1i(GLint location, GLint x)
 {
-	return es2::Uniform1i(location, x);
+	return es2::dispatch(es2::Uniform1i, location, x);
 }
 
 GL_APICALL void GL_APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint* v)
 {
-	return es2::Uniform1iv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform1iv, 1, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2f(GLint location, GLfloat x, GLfloat y)
 {
-	return es2::Uniform2f(location, x, y);
+	return es2::dispatch(es2::Uniform2f, location, x, y);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat* v)
 {
-	return es2::Uniform2fv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform2fv, 2, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2i(GLint location, GLint x, GLint y)
 {
-	return es2::Uniform2i(location, x, y);
+	return es2::dispatch(es2::Uniform2i, location, x, y);
 }
 
 GL_APICALL void GL_APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint* v)
 {
-	return es2::Uniform2iv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform2iv, 2, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z)
 {
-	return es2::Uniform3f(location, x, y, z);
+	return es2::dispatch(es2::Uniform3f, location, x, y, z);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat* v)
 {
-	return es2::Uniform3fv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform3fv, 3, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3i(GLint location, GLint x, GLint y, GLint z)
 {
-	return es2::Uniform3i(location, x, y, z);
+	return es2::dispatch(es2::Uniform3i, location, x, y, z);
 }
 
 GL_APICALL void GL_APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint* v)
 {
-	return es2::Uniform3iv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform3iv, 3, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
-	return es2::Uniform4f(location, x, y, z, w);
+	return es2::dispatch(es2::Uniform4f, location, x, y, z, w);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat* v)
 {
-	return es2::Uniform4fv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform4fv, 4, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4i(GLint location, GLint x, GLint y, GLint z, GLint w)
 {
-	return es2::Uniform4i(location, x, y, z, w);
+	return es2::dispatch(es2::Uniform4i, location, x, y, z, w);
 }
 
 GL_APICALL void GL_APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint* v)
 {
-	return es2::Uniform4iv(location, count, v);
+	return es2::dispatchUniform(es2::Uniform4iv, 4, location, count, v);
 }
 
 GL_APICALL void GL_APIENTRY glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-	return es2::UniformMatrix2fv(location, count, transpose, value);
+	return es2::dispatchUniformMatrix(es2::UniformMatrix2fv, 4, location, count, transpose, value);
 }
 
 GL_APICALL void GL_APIENTRY glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-	return es2::UniformMatrix3fv(location, count, transpose, value);
+	return es2::dispatchUniformMatrix(es2::UniformMatrix3fv, 9, location, count, transpose, value);
 }
 
 GL_APICALL void GL_APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
 {
-	return es2::UniformMatrix4fv(location, count, transpose, value);
+	return es2::dispatchUniformMatrix(es2::UniformMatrix4fv, 16, location, count, transpose, value);
 }
 
 GL_APICALL void GL_APIENTRY glUseProgram(GLuint program)
 {
-	return es2::UseProgram(program);
+	return es2::dispatch(es2::UseProgram, program);
 }
 
 GL_APICALL void GL_APIENTRY glValidateProgram(GLuint program)
@@ -1227,7 +1360,7 @@ GL_APICALL void GL_APIENTRY glValidateProgram(GLuint program)
 
 GL_APICALL void GL_APIENTRY glVertexAttrib1f(GLuint index, GLfloat x)
 {
-	return es2::VertexAttrib1f(index, x);
+	return es2::dispatch(es2::VertexAttrib1f, index, x);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib1fv(GLuint index, const GLfloat* values)
@@ -1237,7 +1370,7 @@ GL_APICALL void GL_APIENTRY glVertexAttrib1fv(GLuint index, const GLfloat* value
 
 GL_APICALL void GL_APIENTRY glVertexAttrib2f(GLuint index, GLfloat x, GLfloat y)
 {
-	return es2::VertexAttrib2f(index, x, y);
+	return es2::dispatch(es2::VertexAttrib2f, index, x, y);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib2fv(GLuint index, const GLfloat* values)
@@ -1247,7 +1380,7 @@ GL_APICALL void GL_APIENTRY glVertexAttrib2fv(GLuint index, const GLfloat* value
 
 GL_APICALL void GL_APIENTRY glVertexAttrib3f(GLuint index, GLfloat x, GLfloat y, GLfloat z)
 {
-	return es2::VertexAttrib3f(index, x, y, z);
+	return es2::dispatch(es2::VertexAttrib3f, index, x, y, z);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib3fv(GLuint index, const GLfloat* values)
@@ -1257,7 +1390,7 @@ GL_APICALL void GL_APIENTRY glVertexAttrib3fv(GLuint index, const GLfloat* value
 
 GL_APICALL void GL_APIENTRY glVertexAttrib4f(GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
 {
-	return es2::VertexAttrib4f(index, x, y, z, w);
+	return es2::dispatch(es2::VertexAttrib4f, index, x, y, z, w);
 }
 
 GL_APICALL void GL_APIENTRY glVertexAttrib4fv(GLuint index, const GLfloat* values)
@@ -1272,7 +1405,7 @@ GL_APICALL void GL_APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLen
 
 GL_APICALL void GL_APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
 {
-	return es2::Viewport(x, y, width, height);
+	return es2::dispatch(es2::Viewport, x, y, width, height);
 }
 
 GL_APICALL void GL_APIENTRY glBlitFramebufferNV(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
@@ -1332,6 +1465,36 @@ GL_APICALL void GL_APIENTRY glDrawBuffersEXT(GLsizei n, const GLenum *bufs)
 	return es2::DrawBuffersEXT(n, bufs);
 }
 
+GL_APICALL void GL_APIENTRY glMaxShaderCompilerThreadsKHR(GLuint count)
+{
+	return es2::MaxShaderCompilerThreadsKHR(count);
+}
+
+GL_APICALL void GL_APIENTRY glQueryCounterEXT(GLuint name, GLenum target)
+{
+	return es2::QueryCounterEXT(name, target);
+}
+
+GL_APICALL void GL_APIENTRY glGetQueryObjectivEXT(GLuint name, GLenum pname, GLint *params)
+{
+	return es2::GetQueryObjectivEXT(name, pname, params);
+}
+
+GL_APICALL void GL_APIENTRY glGetQueryObjecti64vEXT(GLuint name, GLenum pname, GLint64 *params)
+{
+	return es2::GetQueryObjecti64vEXT(name, pname, params);
+}
+
+GL_APICALL void GL_APIENTRY glGetQueryObjectui64vEXT(GLuint name, GLenum pname, GLuint64 *params)
+{
+	return es2::GetQueryObjectui64vEXT(name, pname, params);
+}
+
+GL_APICALL void GL_APIENTRY glGetInteger64vEXT(GLenum pname, GLint64 *data)
+{
+	return es2::GetInteger64vEXT(pname, data);
+}
+
 void GL_APIENTRY Register(const char *licenseKey)
 {
 	// Nothing to do, SwiftShader is open-source
@@ -1540,6 +1703,12 @@ LibGLESv2exports::LibGLESv2exports()
 	this->glGetFramebufferAttachmentParameterivOES = es2::GetFramebufferAttachmentParameterivOES;
 	this->glGenerateMipmapOES = es2::GenerateMipmapOES;
 	this->glDrawBuffersEXT = es2::DrawBuffersEXT;
+	this->glMaxShaderCompilerThreadsKHR = es2::MaxShaderCompilerThreadsKHR;
+	this->glQueryCounterEXT = es2::QueryCounterEXT;
+	this->glGetQueryObjectivEXT = es2::GetQueryObjectivEXT;
+	this->glGetQueryObjecti64vEXT = es2::GetQueryObjecti64vEXT;
+	this->glGetQueryObjectui64vEXT = es2::GetQueryObjectui64vEXT;
+	this->glGetInteger64vEXT = es2::GetInteger64vEXT;
 
 	this->es2CreateContext = ::es2CreateContext;
 	this->es2GetProcAddress = ::es2GetProcAddress;
@@ -5950,6 +5950,23 @@ namespace sw
 
 		return RValue<Long>(V(::builder->CreateCall(rdtsc)));
 	}
+
+	void NonTemporalStore(RValue<Int4> value, RValue<Pointer<Byte>> address)
+	{
+		// Stored as floats, which the x86 back-end has non-temporal store patterns for
+		Value *pointer = Nucleus::createBitCast(address.value, Pointer<Float4>::getType());
+		llvm::StoreInst *store = ::builder->CreateStore(Nucleus::createBitCast(value.value, Float4::getType()), pointer);
+		store->setAlignment(16);
+
+		llvm::Value *one = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*::context), 1);
+		store->setMetadata(::context->getMDKindID("nontemporal"), llvm::MDNode::get(*::context, one));
+	}
+
+	void StoreFence()
+	{
+		// The JIT can't encode SFENCE, so use a full fence (MFENCE), which also orders non-temporal stores
+		::builder->CreateFence(llvm::SequentiallyConsistent);
+	}
 }
 
 namespace sw
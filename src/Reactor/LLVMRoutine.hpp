@@ -34,10 +34,10 @@ namespace sw
 		//void setFunctionSize(int functionSize);
 
 		//const void *getBuffer();
-		const void *getEntry();
+		const void *getEntry() override;
 		//int getBufferSize();
 		//int getFunctionSize();   // Includes constants before the entry point
-		int getCodeSize();       // Executable code only
+		int getCodeSize() override;   // Executable code only
 		//bool isDynamic();
 
 	private:
@@ -2254,6 +2254,10 @@ namespace sw
 	}
 
 	RValue<Long> Ticks();
+
+	// Stores around the caches, for large outputs which won't be read again soon. The address must be 16-byte aligned.
+	void NonTemporalStore(RValue<Int4> value, RValue<Pointer<Byte>> address);
+	void StoreFence();   // Orders preceding non-temporal stores before any later stores
 }
 
 namespace sw
@@ -25,6 +25,7 @@ namespace sw
 		virtual ~Routine();
 
 		virtual const void *getEntry() = 0;
+		virtual int getCodeSize() = 0;   // Executable code only
 
 		// Reference counting
 		void bind();
@@ -441,7 +441,7 @@ namespace sw
 		ELFMemoryStreamer &operator=(const ELFMemoryStreamer &) = delete;
 
 	public:
-		ELFMemoryStreamer() : Routine(), entry(nullptr)
+		ELFMemoryStreamer() : Routine(), entry(nullptr), codeSize(0)
 		{
 			position = 0;
 			buffer.reserve(0x1000);
@@ -491,7 +491,6 @@ namespace sw
 			{
 				position = std::numeric_limits<std::size_t>::max();   // Can't stream more data after this
 
-				size_t codeSize = 0;
 				entry = loadImage(&buffer[0], codeSize);
 
 				#if defined(_WIN32)
@@ -506,8 +505,16 @@ namespace sw
 			return entry;
 		}
 
+		int getCodeSize() override
+		{
+			getEntry();   // The code size is only known after loading the image
+
+			return static_cast<int>(codeSize);
+		}
+
 	private:
 		void *entry;
+		size_t codeSize;
 		std::vector<uint8_t, ExecutableAllocator<uint8_t>> buffer;
 		std::size_t position;
 
@@ -7153,4 +7160,13 @@ namespace sw
 	{
 		assert(false && "UNIMPLEMENTED"); return RValue<Long>(V(nullptr));
 	}
+
+	void NonTemporalStore(RValue<Int4> value, RValue<Pointer<Byte>> address)
+	{
+		*Pointer<Int4>(address, 16) = value;   // Subzero has no non-temporal stores
+	}
+
+	void StoreFence()
+	{
+	}
 }
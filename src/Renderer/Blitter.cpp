@@ -15,6 +15,7 @@
 #include "Blitter.hpp"
 
 #include "Reactor/Reactor.hpp"
+#include "Common/Half.hpp"
 #include "Common/Memory.hpp"
 #include "Common/Debug.hpp"
 
@@ -101,8 +102,27 @@ namespace sw
 		}
 
 		uint8_t *d = (uint8_t*)dest->lockInternal(dRect.x0, dRect.y0, dRect.slice, sw::LOCK_WRITEONLY, sw::PUBLIC);
+		int bytes = Surface::bytes(dest->getFormat());
+		int width = dRect.x1 - dRect.x0;
+		int height = dRect.y1 - dRect.y0;
 
-		switch(Surface::bytes(dest->getFormat()))
+		if(width * height * bytes >= NON_TEMPORAL_THRESHOLD)
+		{
+			int pattern = (bytes == 2) ? (packed | packed << 16) : packed;
+
+			for(int i = dRect.y0; i < dRect.y1; i++)
+			{
+				Surface::memfill4(d, pattern, width * bytes, true);
+				d += dest->getInternalPitchB();
+			}
+
+			storeFence();
+			dest->unlockInternal();
+
+			return true;
+		}
+
+		switch(bytes)
 		{
 		case 2:
 			for(int i = dRect.y0; i < dRect.y1; i++)
@@ -127,6 +147,153 @@ namespace sw
 		return true;
 	}
 
+	bool Blitter::fastBlit(Surface *source, const SliceRect &sourceRect, Surface *dest, const SliceRect &destRect, const Blitter::Options& options)
+	{
+		if((options & (WRITE_RGBA | CLEAR_OPERATION)) != WRITE_RGBA)
+		{
+			return false;
+		}
+
+		Rect dRect = destRect;
+		Rect sRect = sourceRect;
+		if(destRect.x0 > destRect.x1)
+		{
+			swap(dRect.x0, dRect.x1);
+			swap(sRect.x0, sRect.x1);
+		}
+		if(destRect.y0 > destRect.y1)
+		{
+			swap(dRect.y0, dRect.y1);
+			swap(sRect.y0, sRect.y1);
+		}
+
+		bool flipY = sRect.y0 > sRect.y1;
+		if(flipY)
+		{
+			swap(sRect.y0, sRect.y1);
+		}
+
+		int width = dRect.x1 - dRect.x0;
+		int height = dRect.y1 - dRect.y0;
+
+		// Only unscaled copies which are not mirrored horizontally, so filtering has no effect
+		if(sRect.x1 - sRect.x0 != width || sRect.y1 - sRect.y0 != height || width <= 0 || height <= 0)
+		{
+			return false;
+		}
+
+		bool useSourceInternal = !source->isExternalDirty();
+		bool useDestInternal = !dest->isExternalDirty();
+		bool isStencil = ((options & USE_STENCIL) == USE_STENCIL);
+
+		Format format = isStencil ? source->getStencilFormat() : source->getFormat(useSourceInternal);
+		Format destFormat = isStencil ? dest->getStencilFormat() : dest->getFormat(useDestInternal);
+
+		// Half and single precision float formats with the same channels get converted instead of copied
+		int halfToFloatChannels = Surface::halfFloatChannels(format, destFormat);
+		int floatToHalfChannels = Surface::halfFloatChannels(destFormat, format);
+
+		if(format != destFormat && !halfToFloatChannels && !floatToHalfChannels)
+		{
+			return false;
+		}
+
+		if(Surface::isCompressed(format) || format == FORMAT_NULL ||
+		   format == FORMAT_YV12_BT601 || format == FORMAT_YV12_BT709 || format == FORMAT_YV12_JFIF)
+		{
+			return false;
+		}
+
+		bool quadLayout = Surface::hasQuadLayout(format);
+		int rows = 1;   // Rows interleaved in each line of memory
+
+		if(quadLayout)
+		{
+			// Whole 2x2 quads must be copied, so the rectangles must start on even coordinates and
+			// may only extend into the padding of the last odd column or row
+			if(flipY || ((sRect.x0 | sRect.y0 | dRect.x0 | dRect.y0) & 1) ||
+			   ((sRect.x1 & 1) && sRect.x1 != source->getWidth()) || ((sRect.y1 & 1) && sRect.y1 != source->getHeight()) ||
+			   ((dRect.x1 & 1) && dRect.x1 != dest->getWidth()) || ((dRect.y1 & 1) && dRect.y1 != dest->getHeight()))
+			{
+				return false;
+			}
+
+			rows = 2;
+			width = align(width, 2);
+			height = align(height, 2);
+		}
+
+		bool isEntireDest = dest->isEntire(destRect);
+
+		byte *s = (byte*)(isStencil ? source->lockStencil(0, 0, 0, sw::PUBLIC) :
+		                              source->lock(0, 0, sourceRect.slice, sw::LOCK_READONLY, sw::PUBLIC, useSourceInternal));
+		byte *d = (byte*)(isStencil ? dest->lockStencil(0, 0, 0, sw::PUBLIC) :
+		                              dest->lock(0, 0, destRect.slice, isEntireDest ? sw::LOCK_DISCARD : sw::LOCK_WRITEONLY, sw::PUBLIC, useDestInternal));
+		int sPitchB = isStencil ? source->getStencilPitchB() : source->getPitchB(useSourceInternal);
+		int dPitchB = isStencil ? dest->getStencilPitchB() : dest->getPitchB(useDestInternal);
+
+		int bytes = Surface::bytes(format);
+		int destBytes = Surface::bytes(destFormat);
+		int lineB = width * rows * bytes;
+
+		s += sRect.y0 * sPitchB + sRect.x0 * rows * bytes;
+		d += dRect.y0 * dPitchB + dRect.x0 * rows * destBytes;
+
+		if(flipY)
+		{
+			s += (height - 1) * sPitchB;
+			sPitchB = -sPitchB;
+		}
+
+		if(halfToFloatChannels)
+		{
+			for(int y = 0; y < height; y++)
+			{
+				halfToFloat((float*)d, (const unsigned short*)s, width * halfToFloatChannels);
+
+				s += sPitchB;
+				d += dPitchB;
+			}
+		}
+		else if(floatToHalfChannels)
+		{
+			for(int y = 0; y < height; y++)
+			{
+				floatToHalf((unsigned short*)d, (const float*)s, width * floatToHalfChannels);
+
+				s += sPitchB;
+				d += dPitchB;
+			}
+		}
+		else if(sPitchB * rows == lineB && dPitchB * rows == lineB)
+		{
+			memcpy(d, s, lineB * (height / rows));
+		}
+		else
+		{
+			for(int y = 0; y < height; y += rows)
+			{
+				memcpy(d, s, lineB);
+
+				s += sPitchB * rows;
+				d += dPitchB * rows;
+			}
+		}
+
+		if(isStencil)
+		{
+			source->unlockStencil();
+			dest->unlockStencil();
+		}
+		else
+		{
+			source->unlock(useSourceInternal);
+			dest->unlock(useDestInternal);
+		}
+
+		return true;
+	}
+
 	void Blitter::blit(Surface *source, const SliceRect &sRect, Surface *dest, const SliceRect &dRect, bool filter, bool isStencil)
 	{
 		Blitter::Options options = WRITE_RGBA;
@@ -148,6 +315,11 @@ namespace sw
 			return;
 		}
 
+		if(fastBlit(source, sourceRect, dest, destRect, options))
+		{
+			return;
+		}
+
 		if(blitReactor(source, sourceRect, dest, destRect, options))
 		{
 			return;
@@ -16,6 +16,7 @@
 
 #include "Polygon.hpp"
 #include "Renderer.hpp"
+#include "Math.hpp"
 #include "Debug.hpp"
 
 namespace sw
@@ -80,6 +81,29 @@ namespace sw
 		return polygon.n >= 3;
 	}
 
+	bool Clipper::isInsideGuardBand(const Polygon &polygon, int clipFlagsOr, const DrawCall &draw) const
+	{
+		if(clipFlagsOr & ~(CLIP_LEFT | CLIP_RIGHT | CLIP_TOP | CLIP_BOTTOM | CLIP_FINITE))
+		{
+			return false;   // Near, far and user plane crossings require actual clipping
+		}
+
+		const float guardBandX = draw.data->guardBandX;
+		const float guardBandY = draw.data->guardBandY;
+
+		for(int i = 0; i < polygon.n; i++)
+		{
+			const float4 &v = *polygon.P[polygon.i][i];
+
+			if(!(v.w > 0.0f) || abs(v.x) > guardBandX * v.w || abs(v.y) > guardBandY * v.w)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	void Clipper::clipNear(Polygon &polygon)
 	{
 		const float4 **V = polygon.P[polygon.i];
@@ -59,6 +59,10 @@ namespace sw
 		unsigned int computeClipFlags(const float4 &v);
 		bool clip(Polygon &polygon, int clipFlagsOr, const DrawCall &draw);
 
+		// Triangles which only cross the left, right, top or bottom planes but lie
+		// within the guard band can be scissored by the rasterizer instead of clipped.
+		bool isInsideGuardBand(const Polygon &polygon, int clipFlagsOr, const DrawCall &draw) const;
+
 	private:
 		void clipNear(Polygon &polygon);
 		void clipFar(Polygon &polygon);
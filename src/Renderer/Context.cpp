@@ -38,11 +38,14 @@ namespace sw
 	bool forceWindowed = false;
 	bool quadLayoutEnabled = false;
 	bool veryEarlyDepthTest = true;
+	bool hierarchicalDepthCulling = true;
 	bool complementaryDepthBuffer = false;
 	bool postBlendSRGB = false;
 	bool exactColorRounding = false;
 	TransparencyAntialiasing transparencyAntialiasing = TRANSPARENCY_NONE;
 	bool forceClearRegisters = false;
+	bool uniformSpecialization = false;   // Compile stable branch constants into routines
+	bool textureTiling = false;           // Sample 2D textures from a 4x4 tiled copy
 
 	Context::Context()
 	{
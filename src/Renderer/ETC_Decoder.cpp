@@ -14,6 +14,14 @@
 
 #include "ETC_Decoder.hpp"
 
+#include "Common/CPUID.hpp"
+
+#include <string.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+	#include <emmintrin.h>
+#endif
+
 namespace
 {
 	inline int clampByte(int value)
@@ -51,12 +59,6 @@ namespace
 			b = static_cast<unsigned char>(clampByte(blue));
 			a = static_cast<unsigned char>(clampByte(alpha));
 		}
-
-		const bgra8& addA(int alpha)
-		{
-			a = alpha;
-			return *this;
-		}
 	};
 
 	inline int extend_4to8bits(int x)
@@ -79,39 +81,151 @@ namespace
 		return (x << 1) | (x >> 6);
 	}
 
+	#if defined(__i386__) || defined(__x86_64__)
+		inline __m128i select(__m128i a, __m128i b, __m128i mask)
+		{
+			return _mm_xor_si128(a, _mm_and_si128(_mm_xor_si128(a, b), mask));
+		}
+
+		// Sets four colors to a base color plus each of the intensity modifiers, clamped to bytes
+		inline void setColorsSSE2(bgra8 colors[4], int red, int green, int blue, const int modifier[4])
+		{
+			__m128i m = _mm_packs_epi32(_mm_loadu_si128((const __m128i*)modifier), _mm_setzero_si128());
+			m = _mm_unpacklo_epi16(m, m);
+
+			__m128i color = _mm_unpacklo_epi8(_mm_cvtsi32_si128(blue | green << 8 | red << 16), _mm_setzero_si128());
+			color = _mm_unpacklo_epi64(color, color);
+
+			__m128i c01 = _mm_add_epi16(color, _mm_unpacklo_epi32(m, m));
+			__m128i c23 = _mm_add_epi16(color, _mm_unpackhi_epi32(m, m));
+
+			_mm_storeu_si128((__m128i*)colors, _mm_packus_epi16(c01, c23));   // Alpha gets set when writing pixels
+		}
+
+		// Writes a whole block four pixels at a time, looking up each row's colors from
+		// the palettes with the index bits as select masks
+		void writeBlockSSE2(unsigned char *dest, int pitch, int msb, int lsb, const bgra8 *palette0, const bgra8 *palette1, bool flip, unsigned char alphaValues[4][4], bool nonOpaquePunchThroughAlpha)
+		{
+			const __m128i rgb = _mm_set1_epi32(0x00FFFFFF);
+			__m128i p0 = _mm_and_si128(_mm_loadu_si128((const __m128i*)palette0), rgb);
+			__m128i p1 = _mm_and_si128(_mm_loadu_si128((const __m128i*)palette1), rgb);
+
+			// Colors of each index for the four pixels of the top and bottom two rows
+			__m128i palette[2][4];
+
+			if(flip)
+			{
+				palette[0][0] = _mm_shuffle_epi32(p0, 0x00);
+				palette[0][1] = _mm_shuffle_epi32(p0, 0x55);
+				palette[0][2] = _mm_shuffle_epi32(p0, 0xAA);
+				palette[0][3] = _mm_shuffle_epi32(p0, 0xFF);
+				palette[1][0] = _mm_shuffle_epi32(p1, 0x00);
+				palette[1][1] = _mm_shuffle_epi32(p1, 0x55);
+				palette[1][2] = _mm_shuffle_epi32(p1, 0xAA);
+				palette[1][3] = _mm_shuffle_epi32(p1, 0xFF);
+			}
+			else
+			{
+				palette[0][0] = palette[1][0] = _mm_unpacklo_epi64(_mm_shuffle_epi32(p0, 0x00), _mm_shuffle_epi32(p1, 0x00));
+				palette[0][1] = palette[1][1] = _mm_unpacklo_epi64(_mm_shuffle_epi32(p0, 0x55), _mm_shuffle_epi32(p1, 0x55));
+				palette[0][2] = palette[1][2] = _mm_unpacklo_epi64(_mm_shuffle_epi32(p0, 0xAA), _mm_shuffle_epi32(p1, 0xAA));
+				palette[0][3] = palette[1][3] = _mm_unpacklo_epi64(_mm_shuffle_epi32(p0, 0xFF), _mm_shuffle_epi32(p1, 0xFF));
+			}
+
+			const __m128i bits = _mm_setr_epi32(1 << 0, 1 << 4, 1 << 8, 1 << 12);   // Index bits of a row's pixels
+
+			for(int j = 0; j < 4; j++)
+			{
+				__m128i msbMask = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(msb >> j), bits), bits);
+				__m128i lsbMask = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(lsb >> j), bits), bits);
+
+				const __m128i *p = palette[j >> 1];
+				__m128i color = select(select(p[0], p[1], lsbMask), select(p[2], p[3], lsbMask), msbMask);
+
+				int alphaRow;
+				memcpy(&alphaRow, alphaValues[j], sizeof(alphaRow));
+				__m128i alpha = _mm_unpacklo_epi8(_mm_cvtsi32_si128(alphaRow), _mm_setzero_si128());
+				alpha = _mm_slli_epi32(_mm_unpacklo_epi16(alpha, _mm_setzero_si128()), 24);
+				color = _mm_or_si128(color, alpha);
+
+				if(nonOpaquePunchThroughAlpha)   // Index 2 is transparent black
+				{
+					color = _mm_andnot_si128(_mm_andnot_si128(lsbMask, msbMask), color);
+				}
+
+				_mm_storeu_si128((__m128i*)dest, color);
+				dest += pitch;
+			}
+		}
+	#endif
+
+	// Sets four colors to a base color plus each of the intensity modifiers
+	inline void setColors(bgra8 colors[4], int red, int green, int blue, const int modifier[4])
+	{
+		#if defined(__i386__) || defined(__x86_64__)
+			if(sw::CPUID::supportsSSE2())
+			{
+				setColorsSSE2(colors, red, green, blue, modifier);
+				return;
+			}
+		#endif
+
+		for(int i = 0; i < 4; i++)
+		{
+			colors[i].set(red + modifier[i], green + modifier[i], blue + modifier[i]);
+		}
+	}
+
 	struct ETC2
 	{
-		// Decodes unsigned single or dual channel block to bytes
+		// Decodes single or dual channel block to bytes
 		static void DecodeBlock(const ETC2** sources, unsigned char *dest, int nbChannels, int x, int y, int w, int h, int pitch, bool isSigned)
 		{
-			if(isSigned)
+			unsigned char values[2][8];
+			unsigned long long indices[2];
+
+			for(int c = 0; c < nbChannels; c++)
 			{
-				signed char* sDst = reinterpret_cast<signed char*>(dest);
-				for(int j = 0; j < 4 && (y + j) < h; j++)
+				sources[c]->getSingleChannelValues(values[c], isSigned);
+				indices[c] = sources[c]->getSingleChannelIndices();
+			}
+
+			if((x + 4) <= w && (y + 4) <= h)   // Whole block, written a row at a time
+			{
+				for(int j = 0; j < 4; j++)
 				{
-					for(int i = 0; i < 4 && (x + i) < w; i++)
+					unsigned long long row = 0;
+
+					for(int i = 0; i < 4; i++)
 					{
-						for(int c = nbChannels - 1; c >= 0; c--)
+						int shift = 45 - 3 * (i * 4 + j);
+
+						for(int c = 0; c < nbChannels; c++)
 						{
-							sDst[i * nbChannels + c] = clampSByte(sources[c]->getSingleChannel(i, j, isSigned));
+							row |= (unsigned long long)values[c][(indices[c] >> shift) & 7] << (8 * (i * nbChannels + c));
 						}
 					}
-					sDst += pitch;
+
+					memcpy(dest, &row, 4 * nbChannels);
+					dest += pitch;
 				}
+
+				return;
 			}
-			else
+
+			for(int j = 0; j < 4 && (y + j) < h; j++)
 			{
-				for(int j = 0; j < 4 && (y + j) < h; j++)
+				for(int i = 0; i < 4 && (x + i) < w; i++)
 				{
-					for(int i = 0; i < 4 && (x + i) < w; i++)
+					int shift = 45 - 3 * (i * 4 + j);
+
+					for(int c = 0; c < nbChannels; c++)
 					{
-						for(int c = nbChannels - 1; c >= 0; c--)
-						{
-							dest[i * nbChannels + c] = clampByte(sources[c]->getSingleChannel(i, j, isSigned));
-						}
+						dest[i * nbChannels + c] = values[c][(indices[c] >> shift) & 7];
 					}
-					dest += pitch;
 				}
+
+				dest += pitch;
 			}
 		}
 
@@ -391,67 +505,10 @@ namespace
 			bgra8 subblockColors0[4];
 			bgra8 subblockColors1[4];
 
-			const int i10 = intensityModifier[cw1][0];
-			const int i11 = intensityModifier[cw1][1];
-			const int i12 = intensityModifier[cw1][2];
-			const int i13 = intensityModifier[cw1][3];
-
-			subblockColors0[0].set(r1 + i10, g1 + i10, b1 + i10);
-			subblockColors0[1].set(r1 + i11, g1 + i11, b1 + i11);
-			subblockColors0[2].set(r1 + i12, g1 + i12, b1 + i12);
-			subblockColors0[3].set(r1 + i13, g1 + i13, b1 + i13);
-
-			const int i20 = intensityModifier[cw2][0];
-			const int i21 = intensityModifier[cw2][1];
-			const int i22 = intensityModifier[cw2][2];
-			const int i23 = intensityModifier[cw2][3];
-
-			subblockColors1[0].set(r2 + i20, g2 + i20, b2 + i20);
-			subblockColors1[1].set(r2 + i21, g2 + i21, b2 + i21);
-			subblockColors1[2].set(r2 + i22, g2 + i22, b2 + i22);
-			subblockColors1[3].set(r2 + i23, g2 + i23, b2 + i23);
-
-			unsigned char* destStart = dest;
-
-			if(flipbit)
-			{
-				for(int j = 0; j < 2 && (y + j) < h; j++)
-				{
-					bgra8* color = (bgra8*)dest;
-					if((x + 0) < w) color[0] = subblockColors0[getIndex(0, j)].addA(alphaValues[j][0]);
-					if((x + 1) < w) color[1] = subblockColors0[getIndex(1, j)].addA(alphaValues[j][1]);
-					if((x + 2) < w) color[2] = subblockColors0[getIndex(2, j)].addA(alphaValues[j][2]);
-					if((x + 3) < w) color[3] = subblockColors0[getIndex(3, j)].addA(alphaValues[j][3]);
-					dest += pitch;
-				}
+			setColors(subblockColors0, r1, g1, b1, intensityModifier[cw1]);
+			setColors(subblockColors1, r2, g2, b2, intensityModifier[cw2]);
 
-				for(int j = 2; j < 4 && (y + j) < h; j++)
-				{
-					bgra8* color = (bgra8*)dest;
-					if((x + 0) < w) color[0] = subblockColors1[getIndex(0, j)].addA(alphaValues[j][0]);
-					if((x + 1) < w) color[1] = subblockColors1[getIndex(1, j)].addA(alphaValues[j][1]);
-					if((x + 2) < w) color[2] = subblockColors1[getIndex(2, j)].addA(alphaValues[j][2]);
-					if((x + 3) < w) color[3] = subblockColors1[getIndex(3, j)].addA(alphaValues[j][3]);
-					dest += pitch;
-				}
-			}
-			else
-			{
-				for(int j = 0; j < 4 && (y + j) < h; j++)
-				{
-					bgra8* color = (bgra8*)dest;
-					if((x + 0) < w) color[0] = subblockColors0[getIndex(0, j)].addA(alphaValues[j][0]);
-					if((x + 1) < w) color[1] = subblockColors0[getIndex(1, j)].addA(alphaValues[j][1]);
-					if((x + 2) < w) color[2] = subblockColors1[getIndex(2, j)].addA(alphaValues[j][2]);
-					if((x + 3) < w) color[3] = subblockColors1[getIndex(3, j)].addA(alphaValues[j][3]);
-					dest += pitch;
-				}
-			}
-
-			if(nonOpaquePunchThroughAlpha)
-			{
-				decodePunchThroughAlphaBlock(destStart, x, y, w, h, pitch);
-			}
+			writeBlock(dest, x, y, w, h, pitch, subblockColors0, subblockColors1, flipbit, alphaValues, nonOpaquePunchThroughAlpha);
 		}
 
 		void decodeTBlock(unsigned char *dest, int x, int y, int w, int h, int pitch, unsigned char alphaValues[4][4], bool nonOpaquePunchThroughAlpha) const
@@ -476,22 +533,7 @@ namespace
 			paintColors[2].set(r2, g2, b2);
 			paintColors[3].set(r2 - d, g2 - d, b2 - d);
 
-			unsigned char* destStart = dest;
-
-			for(int j = 0; j < 4 && (y + j) < h; j++)
-			{
-				bgra8* color = (bgra8*)dest;
-				if((x + 0) < w) color[0] = paintColors[getIndex(0, j)].addA(alphaValues[j][0]);
-				if((x + 1) < w) color[1] = paintColors[getIndex(1, j)].addA(alphaValues[j][1]);
-				if((x + 2) < w) color[2] = paintColors[getIndex(2, j)].addA(alphaValues[j][2]);
-				if((x + 3) < w) color[3] = paintColors[getIndex(3, j)].addA(alphaValues[j][3]);
-				dest += pitch;
-			}
-
-			if(nonOpaquePunchThroughAlpha)
-			{
-				decodePunchThroughAlphaBlock(destStart, x, y, w, h, pitch);
-			}
+			writeBlock(dest, x, y, w, h, pitch, paintColors, paintColors, false, alphaValues, nonOpaquePunchThroughAlpha);
 		}
 
 		void decodeHBlock(unsigned char *dest, int x, int y, int w, int h, int pitch, unsigned char alphaValues[4][4], bool nonOpaquePunchThroughAlpha) const
@@ -516,22 +558,7 @@ namespace
 			paintColors[2].set(r2 + d, g2 + d, b2 + d);
 			paintColors[3].set(r2 - d, g2 - d, b2 - d);
 
-			unsigned char* destStart = dest;
-
-			for(int j = 0; j < 4 && (y + j) < h; j++)
-			{
-				bgra8* color = (bgra8*)dest;
-				if((x + 0) < w) color[0] = paintColors[getIndex(0, j)].addA(alphaValues[j][0]);
-				if((x + 1) < w) color[1] = paintColors[getIndex(1, j)].addA(alphaValues[j][1]);
-				if((x + 2) < w) color[2] = paintColors[getIndex(2, j)].addA(alphaValues[j][2]);
-				if((x + 3) < w) color[3] = paintColors[getIndex(3, j)].addA(alphaValues[j][3]);
-				dest += pitch;
-			}
-
-			if(nonOpaquePunchThroughAlpha)
-			{
-				decodePunchThroughAlphaBlock(destStart, x, y, w, h, pitch);
-			}
+			writeBlock(dest, x, y, w, h, pitch, paintColors, paintColors, false, alphaValues, nonOpaquePunchThroughAlpha);
 		}
 
 		void decodePlanarBlock(unsigned char *dest, int x, int y, int w, int h, int pitch, unsigned char alphaValues[4][4]) const
@@ -564,65 +591,65 @@ namespace
 			}
 		}
 
-		// Index for individual, differential, H and T modes
-		inline int getIndex(int x, int y) const
+		// Writes the colors selected by the pixel indices for individual, differential, H and T modes,
+		// from the first palette for the first subblock and from the second palette for the second one
+		void writeBlock(unsigned char *dest, int x, int y, int w, int h, int pitch, const bgra8 *palette0, const bgra8 *palette1, bool flip, unsigned char alphaValues[4][4], bool nonOpaquePunchThroughAlpha) const
 		{
-			int bitIndex = x * 4 + y;
-			int bitOffset = bitIndex & 7;
-			int lsb = (pixelIndexLSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
-			int msb = (pixelIndexMSB[1 - (bitIndex >> 3)] >> bitOffset) & 1;
+			// Bit x * 4 + y holds the index of pixel (x, y)
+			const int msb = pixelIndexMSB[0] << 8 | pixelIndexMSB[1];
+			const int lsb = pixelIndexLSB[0] << 8 | pixelIndexLSB[1];
 
-			return (msb << 1) | lsb;
-		}
+			#if defined(__i386__) || defined(__x86_64__)
+				if((x + 4) <= w && (y + 4) <= h && sw::CPUID::supportsSSE2())
+				{
+					writeBlockSSE2(dest, pitch, msb, lsb, palette0, palette1, flip, alphaValues, nonOpaquePunchThroughAlpha);
+					return;
+				}
+			#endif
 
-		void decodePunchThroughAlphaBlock(unsigned char *dest, int x, int y, int w, int h, int pitch) const
-		{
 			for(int j = 0; j < 4 && (y + j) < h; j++)
 			{
+				bgra8* color = (bgra8*)dest;
+
 				for(int i = 0; i < 4 && (x + i) < w; i++)
 				{
-					if(getIndex(i, j) == 2) //  msb == 1 && lsb == 0
+					int index = ((msb >> (i * 4 + j)) & 1) << 1 | ((lsb >> (i * 4 + j)) & 1);
+					const bgra8 *palette = ((flip ? j : i) < 2) ? palette0 : palette1;
+
+					if(nonOpaquePunchThroughAlpha && index == 2)   // msb == 1 && lsb == 0
+					{
+						color[i].set(0, 0, 0, 0);
+					}
+					else
 					{
-						((bgra8*)dest)[i].set(0, 0, 0, 0);
+						color[i] = palette[index];
+						color[i].a = alphaValues[j][i];
 					}
 				}
+
 				dest += pitch;
 			}
 		}
 
 		// Single channel utility functions
-		inline int getSingleChannel(int x, int y, bool isSigned) const
+		// Bits 45 - 3 * (x * 4 + y) to 47 - 3 * (x * 4 + y) hold the index of pixel (x, y)
+		inline unsigned long long getSingleChannelIndices() const
 		{
-			int codeword = isSigned ? signed_base_codeword : base_codeword;
-			return codeword + getSingleChannelModifier(x, y) * multiplier;
-		}
+			const unsigned char *bytes = reinterpret_cast<const unsigned char*>(this);
+			unsigned long long indices = 0;
 
-		inline int getSingleChannelIndex(int x, int y) const
-		{
-			switch(x * 4 + y)
+			for(int i = 2; i < 8; i++)
 			{
-			case 0: return ma;
-			case 1: return mb;
-			case 2: return mc1 << 1 | mc2;
-			case 3: return md;
-			case 4: return me;
-			case 5: return mf1 << 2 | mf2;
-			case 6: return mg;
-			case 7: return mh;
-			case 8: return mi;
-			case 9: return mj;
-			case 10: return mk1 << 1 | mk2;
-			case 11: return ml;
-			case 12: return mm;
-			case 13: return mn1 << 2 | mn2;
-			case 14: return mo;
-			default: return mp; // 15
+				indices = (indices << 8) | bytes[i];
 			}
+
+			return indices;
 		}
 
-		inline int getSingleChannelModifier(int x, int y) const
+		// Values for each of the eight indices, clamped to bytes
+		inline void getSingleChannelValues(unsigned char values[8], bool isSigned) const
 		{
-			static const int modifierTable[16][8] = { { -3, -6, -9, -15, 2, 5, 8, 14 },
+			static const short modifierTable[16][8] = { { -3, -6, -9, -15, 2, 5, 8, 14 },
 			{ -3, -7, -10, -13, 2, 6, 9, 12 },
 			{ -2, -5, -8, -13, 1, 4, 7, 12 },
 			{ -2, -4, -6, -13, 1, 3, 5, 12 },
@@ -639,7 +666,24 @@ namespace
 			{ -4, -6, -8, -9, 3, 5, 7, 8 },
 			{ -3, -5, -7, -9, 2, 4, 6, 8 } };
 
-			return modifierTable[table_index][getSingleChannelIndex(x, y)];
+			int codeword = isSigned ? signed_base_codeword : base_codeword;
+
+			#if defined(__i386__) || defined(__x86_64__)
+				if(sw::CPUID::supportsSSE2())
+				{
+					__m128i value = _mm_mullo_epi16(_mm_loadu_si128((const __m128i*)modifierTable[table_index]), _mm_set1_epi16(multiplier));
+					value = _mm_add_epi16(value, _mm_set1_epi16(codeword));
+					value = isSigned ? _mm_packs_epi16(value, value) : _mm_packus_epi16(value, value);
+					_mm_storel_epi64((__m128i*)values, value);
+					return;
+				}
+			#endif
+
+			for(int i = 0; i < 8; i++)
+			{
+				int value = codeword + modifierTable[table_index][i] * multiplier;
+				values[i] = static_cast<unsigned char>(isSigned ? clampSByte(value) : clampByte(value));
+			}
 		}
 	};
 }
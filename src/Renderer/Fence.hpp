@@ -0,0 +1,110 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_Fence_hpp
+#define sw_Fence_hpp
+
+#include "Common/Thread.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+
+namespace sw
+{
+	// Point in a renderer's queue of draw calls, which gets signaled once all draw
+	// calls issued before it have completed. Reference counted, so its owner can
+	// release it while draw calls still refer to it. Only depends on headers, so
+	// the EGL library can use it for its sync objects.
+	class Fence
+	{
+	public:
+		Fence() : references(1), pending(0)   // Referenced by its creator
+		{
+		}
+
+		void addRef()
+		{
+			atomicIncrement(&references);
+		}
+
+		void release()
+		{
+			if(atomicDecrement(&references) == 0)
+			{
+				delete this;
+			}
+		}
+
+		// Called by the renderer for each draw call the fence depends on, which holds a reference until it retires
+		void issue()
+		{
+			addRef();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			pending++;
+		}
+
+		void retire()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+
+				if(--pending == 0)
+				{
+					signaled.notify_all();
+				}
+			}
+
+			release();
+		}
+
+		bool isSignaled() const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return pending == 0;
+		}
+
+		// Returns whether the fence got signaled within the timeout, in nanoseconds.
+		// Timeouts too long for the clock to represent, like GL_TIMEOUT_IGNORED, never expire.
+		bool wait(uint64_t timeout) const
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			auto isDone = [this]() { return pending == 0; };
+
+			if(timeout >= (uint64_t)1 << 62)
+			{
+				signaled.wait(lock, isDone);
+				return true;
+			}
+
+			return signaled.wait_for(lock, std::chrono::nanoseconds(timeout), isDone);
+		}
+
+	protected:
+		virtual ~Fence()
+		{
+		}
+
+	private:
+		volatile int references;
+
+		mutable std::mutex mutex;
+		mutable std::condition_variable signaled;
+		int pending;   // Draw calls issued before the fence which haven't completed yet
+	};
+}
+
+#endif   // sw_Fence_hpp
@@ -931,7 +931,7 @@ namespace sw
 		fog.offset = replicate(fogOffset);
 	}
 
-	const PixelProcessor::State PixelProcessor::update() const
+	const PixelProcessor::State PixelProcessor::update()
 	{
 		State state;
 
@@ -947,6 +947,11 @@ namespace sw
 		state.depthOverride = context->pixelShader && context->pixelShader->depthOverride();
 		state.shaderContainsKill = context->pixelShader ? context->pixelShader->containsKill() : false;
 
+		if(uniformSpecialization && context->pixelShader)
+		{
+			state.specialized = specialization.specialize(context->pixelShader, c, FRAGMENT_UNIFORM_VECTORS, i, b, state.branchConstant);
+		}
+
 		if(context->alphaTestActive())
 		{
 			state.alphaCompareMode = context->alphaCompareMode;
@@ -982,6 +987,7 @@ namespace sw
 			state.depthTestActive = true;
 			state.depthCompareMode = context->depthCompareMode;
 			state.quadLayoutDepthBuffer = Surface::hasQuadLayout(context->depthBuffer->getInternalFormat());
+			state.hierarchicalDepthBuffer = context->depthBuffer->hasHierarchicalDepth();
 		}
 
 		state.occlusionEnabled = context->occlusionEnabled;
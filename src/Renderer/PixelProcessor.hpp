@@ -17,6 +17,7 @@
 
 #include "Context.hpp"
 #include "RoutineCache.hpp"
+#include "ShaderSpecialization.hpp"
 
 namespace sw
 {
@@ -36,11 +37,13 @@ namespace sw
 
 			bool depthOverride                        : 1;
 			bool shaderContainsKill                   : 1;
+			bool specialized                          : 1;   // Branch constants are compiled in
 
 			DepthCompareMode depthCompareMode         : BITS(DEPTH_LAST);
 			AlphaCompareMode alphaCompareMode         : BITS(ALPHA_LAST);
 			bool depthWriteEnable                     : 1;
 			bool quadLayoutDepthBuffer                : 1;
+			bool hierarchicalDepthBuffer              : 1;
 
 			bool stencilActive                        : 1;
 			StencilCompareMode stencilCompareMode     : BITS(STENCIL_LAST);
@@ -107,6 +110,8 @@ namespace sw
 
 				Interpolant interpolant[MAX_FRAGMENT_INPUTS];
 			};
+
+			int branchConstant[Shader::MAX_BRANCH_CONSTANTS];
 		};
 
 		struct State : States
@@ -301,7 +306,7 @@ namespace sw
 		void setOcclusionEnabled(bool enable);
 
 	protected:
-		const State update() const;
+		const State update();
 		Routine *routine(const State &state);
 		void setRoutineCacheSize(int routineCacheSize);
 
@@ -332,6 +337,7 @@ namespace sw
 		Context *const context;
 
 		RoutineCache<State> *routineCache;
+		ShaderSpecialization specialization;
 	};
 }
 
@@ -20,11 +20,11 @@
 
 namespace sw
 {
-	struct Triangle
+	struct Triangle   // Indices of the vertices in the batch, which are shared between triangles
 	{
-		Vertex v0;
-		Vertex v1;
-		Vertex v2;
+		unsigned int v0;
+		unsigned int v1;
+		unsigned int v2;
 	};
 
 	struct PlaneEquation   // z = A * x + B * y + C
@@ -63,17 +63,21 @@ namespace sw
 		int64_t clockwiseMask;
 		int64_t invClockwiseMask;
 
-		struct Span
+		// Non-horizontal polygon edges, in 1/16th pixel units. The rasterizer computes the span
+		// of each scanline from the left and right edge crossing it, so the memory needed doesn't
+		// depend on the primitive's height, and the render target height isn't limited.
+		struct Edge
 		{
-			unsigned short left;
-			unsigned short right;
+			int X;          // Upper vertex
+			int Y;
+			int DX;         // Lower vertex minus upper vertex, with DY > 0
+			int DY;
+			float rcpFDY;   // 1 / (16 * DY), for estimating the intersections with scanlines
+			int right;      // All ones when bounding spans on the right instead of the left
 		};
 
-		// The rasterizer adds a zero length span to the top and bottom of the polygon to allow
-		// for 2x2 pixel processing. We need an even number of spans to keep accesses aligned.
-		Span outlineUnderflow[2];
-		Span outline[OUTLINE_RESOLUTION];
-		Span outlineOverflow[2];
+		int edgeCount;
+		Edge edge[16];   // One per vertex of a clipped polygon, at most
 	};
 }
 
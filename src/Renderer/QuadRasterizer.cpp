@@ -20,9 +20,12 @@
 #include "Constants.hpp"
 #include "Debug.hpp"
 
+#include <float.h>
+
 namespace sw
 {
 	extern bool veryEarlyDepthTest;
+	extern bool hierarchicalDepthCulling;
 	extern bool complementaryDepthBuffer;
 	extern bool fullPixelPositionRegister;
 
@@ -65,7 +68,7 @@ namespace sw
 				rasterize(yMin, yMax);
 			}
 
-			primitive += sizeof(Primitive) * state.multiSample;
+			primitive += sizeof(Primitive);
 			count--;
 		}
 		Until(count == 0)
@@ -113,32 +116,42 @@ namespace sw
 			sBuffer = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,stencilBuffer)) + yMin * *Pointer<Int>(data + OFFSET(DrawData,stencilPitchB));
 		}
 
+		Pointer<Byte> hiZBuffer;
+
+		if(hierarchicalDepthTest() || hierarchicalDepthInvalidate())
+		{
+			hiZBuffer = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,hierarchicalDepth)) + (yMin >> 1) * *Pointer<Int>(data + OFFSET(DrawData,hierarchicalDepthPitchB));
+		}
+
 		Int y = yMin;
 
 		Do
 		{
-			Int x0a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 0) * sizeof(Primitive::Span)));
-			Int x0b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->left) + (y + 1) * sizeof(Primitive::Span)));
+			Int4 spans[4];
+
+			for(unsigned int q = 0; q < state.multiSample; q++)
+			{
+				spans[q] = span(y, q);
+			}
+
+			Int x0a = Extract(spans[0], 0);
+			Int x0b = Extract(spans[0], 2);
 			Int x0 = Min(x0a, x0b);
 
 			for(unsigned int q = 1; q < state.multiSample; q++)
 			{
-				x0a = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left) + (y + 0) * sizeof(Primitive::Span)));
-				x0b = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left) + (y + 1) * sizeof(Primitive::Span)));
-				x0 = Min(x0, Min(x0a, x0b));
+				x0 = Min(x0, Min(Extract(spans[q], 0), Extract(spans[q], 2)));
 			}
 
 			x0 &= 0xFFFFFFFE;
 
-			Int x1a = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 0) * sizeof(Primitive::Span)));
-			Int x1b = Int(*Pointer<Short>(primitive + OFFSET(Primitive,outline->right) + (y + 1) * sizeof(Primitive::Span)));
+			Int x1a = Extract(spans[0], 1);
+			Int x1b = Extract(spans[0], 3);
 			Int x1 = Max(x1a, x1b);
 
 			for(unsigned int q = 1; q < state.multiSample; q++)
 			{
-				x1a = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right) + (y + 0) * sizeof(Primitive::Span)));
-				x1b = Int(*Pointer<Short>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right) + (y + 1) * sizeof(Primitive::Span)));
-				x1 = Max(x1, Max(x1a, x1b));
+				x1 = Max(x1, Max(Extract(spans[q], 1), Extract(spans[q], 3)));
 			}
 
 			Float4 yyyy = Float4(Float(y)) + *Pointer<Float4>(primitive + OFFSET(Primitive,yQuad), 16);
@@ -268,26 +281,87 @@ namespace sw
 
 				for(unsigned int q = 0; q < state.multiSample; q++)
 				{
-					xLeft[q] = *Pointer<Short4>(primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline) + y * sizeof(Primitive::Span));
+					xLeft[q] = Short4(spans[q]);
 					xRight[q] = xLeft[q];
 
 					xLeft[q] = Swizzle(xLeft[q], 0xA0) - Short4(1, 2, 1, 2);
 					xRight[q] = Swizzle(xRight[q], 0xF5) - Short4(0, 1, 0, 1);
 				}
 
-				For(Int x = x0, x < x1, x += 2)
+				Int xs = x0;
+
+				Do
 				{
-					Short4 xxxx = Short4(x);
-					Int cMask[4];
+					Int xe = x1;
 
-					for(unsigned int q = 0; q < state.multiSample; q++)
+					// Process the span one hierarchical depth tile at a time, skipping the occluded ones
+					if(hierarchicalDepthTest() || hierarchicalDepthInvalidate())
 					{
-						Short4 mask = CmpGT(xxxx, xLeft[q]) & CmpGT(xRight[q], xxxx);
-						cMask[q] = SignMask(Pack(mask, mask)) & 0x0000000F;
+						const int W = HIERARCHICAL_DEPTH_TILE_WIDTH;
+
+						Int tileX = xs & -W;
+						Pointer<Byte> tile = hiZBuffer + (tileX >> sw::log2(W)) * sizeof(float);
+						xe = Min(tileX + W, x1);
+
+						if(hierarchicalDepthTest())
+						{
+							// Depth is linear, so its extremes within the tile are found at the corner quads
+							Float4 xxxx = Float4(Float(tileX)) + *Pointer<Float4>(primitive + OFFSET(Primitive,xQuad), 16);
+							Float4 zLeft = interpolate(xxxx, Dz[0], zLeft, primitive + OFFSET(Primitive,z), false, false);
+							xxxx += Float4(W - 2);
+							Float4 zRight = interpolate(xxxx, Dz[0], zRight, primitive + OFFSET(Primitive,z), false, false);
+
+							Float4 zMin = Min(zLeft, zRight);
+							zMin = Min(zMin, zMin.zwzw);
+							zMin = Min(zMin, zMin.yyyy);
+
+							Float tileZ = *Pointer<Float>(tile);
+
+							If(Extract(zMin, 0) > tileZ)
+							{
+								xs = xe;
+							}
+							Else
+							{
+								if(hierarchicalDepthUpdate())
+								{
+									Float4 zMax = Max(zLeft, zRight);
+									zMax = Max(zMax, zMax.zwzw);
+									zMax = Max(zMax, zMax.yyyy);
+
+									Bool covered = Max(x0a, x0b) <= tileX && Min(x1a, x1b) >= tileX + W;
+
+									If(covered && Extract(zMax, 0) < tileZ)
+									{
+										*Pointer<Float>(tile) = Extract(zMax, 0);
+									}
+								}
+							}
+						}
+
+						if(hierarchicalDepthInvalidate())
+						{
+							*Pointer<Float>(tile) = Float(FLT_MAX);
+						}
+					}
+
+					For(Int x = xs, x < xe, x += 2)
+					{
+						Short4 xxxx = Short4(x);
+						Int cMask[4];
+
+						for(unsigned int q = 0; q < state.multiSample; q++)
+						{
+							Short4 mask = CmpGT(xxxx, xLeft[q]) & CmpGT(xRight[q], xxxx);
+							cMask[q] = SignMask(Pack(mask, mask)) & 0x0000000F;
+						}
+
+						quad(cBuffer, zBuffer, sBuffer, cMask, x, y);
 					}
 
-					quad(cBuffer, zBuffer, sBuffer, cMask, x, y);
+					xs = xe;
 				}
+				Until(xs >= x1)
 			}
 
 			for(int index = 0; index < RENDERTARGETS; index++)
@@ -308,11 +382,75 @@ namespace sw
 				sBuffer += *Pointer<Int>(data + OFFSET(DrawData,stencilPitchB)) << (1 + sw::log2(clusterCount));   // FIXME: Precompute
 			}
 
+			if(hierarchicalDepthTest() || hierarchicalDepthInvalidate())
+			{
+				hiZBuffer += *Pointer<Int>(data + OFFSET(DrawData,hierarchicalDepthPitchB)) << sw::log2(clusterCount);
+			}
+
 			y += 2 * clusterCount;
 		}
 		Until(y >= yMax)
 	}
 
+	Int4 QuadRasterizer::span(const Int &y, unsigned int q)
+	{
+		Int4 xMin = *Pointer<Int>(data + OFFSET(DrawData,scissorX0));
+		Int4 xMax = *Pointer<Int>(data + OFFSET(DrawData,scissorX1));
+		Int4 yMin = *Pointer<Int>(primitive + OFFSET(Primitive,yMin));
+		Int4 yMax = *Pointer<Int>(primitive + OFFSET(Primitive,yMax));
+
+		// Left and right bounds of both scanlines. Those not crossed by an edge, or outside
+		// of the (scissored) vertical range, are empty.
+		Int4 yyyy = Int4(y) + Int4(0, 0, 1, 1);
+		Int4 spans = (xMax & Int4(-1, 0, -1, 0)) | (xMin & Int4(0, -1, 0, -1));
+		Int4 inside = CmpNLT(yyyy, yMin) & CmpLT(yyyy, yMax);
+
+		Pointer<Byte> edge = primitive + OFFSET(Primitive,edge);
+		Int edgeCount = *Pointer<Int>(primitive + OFFSET(Primitive,edgeCount));
+
+		For(Int i = 0, i < edgeCount, i++)
+		{
+			Int X = *Pointer<Int>(edge + OFFSET(Primitive::Edge,X));
+			Int Y = *Pointer<Int>(edge + OFFSET(Primitive::Edge,Y));
+			Int DX = *Pointer<Int>(edge + OFFSET(Primitive::Edge,DX));
+			Int DY = *Pointer<Int>(edge + OFFSET(Primitive::Edge,DY));
+			Float rcpFDY = *Pointer<Float>(edge + OFFSET(Primitive::Edge,rcpFDY));
+			Int right = *Pointer<Int>(edge + OFFSET(Primitive::Edge,right));
+
+			if(state.multiSample > 1)
+			{
+				X += *Pointer<Int>(constants + OFFSET(Constants,Xf) + q * sizeof(int));
+				Y += *Pointer<Int>(constants + OFFSET(Constants,Yf) + q * sizeof(int));
+			}
+
+			Int4 FDY = Int4(DY << 4);
+			Int4 DY1 = (yyyy << 4) - Int4(Y);   // Distance of the scanlines below the upper vertex
+
+			// Ceiling of the intersections. For guard band vertices far outside the scissor rectangle
+			// the numerator can exceed 32 bits. The quotient is estimated in floating-point, after
+			// which the wrapping integer arithmetic still produces the exact error-term.
+			Int4 N = Int4(DX) * DY1 + Int4((X & 0x0000000F) * DY);
+			Int4 x = RoundInt((Float4(Float(DX)) * Float4(DY1) + Float4(Float((X & 0x0000000F) * DY))) * Float4(rcpFDY));
+			Int4 d = N - x * FDY;                   // Error-term
+			Int4 ceil = -d >> 31;                   // Ceiling division: remainder <= 0
+			x -= ceil;
+			d -= ceil & FDY;
+			x += (d + FDY - Int4(1)) >> 31;         // Remainder > -FDY
+			x += Int4(X >> 4);
+
+			x = Min(Max(x, xMin), xMax);
+
+			Int4 crossed = inside & CmpNLT(DY1, Int4(0)) & CmpLT(DY1, Int4(DY));
+			Int4 select = crossed & (Int4(right) ^ Int4(-1, 0, -1, 0));
+
+			spans = (spans & ~select) | (x & select);
+
+			edge += sizeof(Primitive::Edge);
+		}
+
+		return spans;
+	}
+
 	Float4 QuadRasterizer::interpolate(Float4 &x, Float4 &D, Float4 &rhw, Pointer<Byte> planeEquation, bool flat, bool perspective)
 	{
 		Float4 interpolant = D;
@@ -335,6 +473,52 @@ namespace sw
 		return state.depthTestActive || state.pixelFogActive() || (shader && shader->isVPosDeclared() && fullPixelPositionRegister);
 	}
 
+	bool QuadRasterizer::hierarchicalDepthTest() const
+	{
+		if(!hierarchicalDepthCulling || complementaryDepthBuffer || !state.hierarchicalDepthBuffer || !state.depthTestActive)
+		{
+			return false;
+		}
+
+		// Rejected tiles must not have any side effects
+		if(state.multiSample > 1 || state.stencilActive || state.depthOverride)
+		{
+			return false;
+		}
+
+		return state.depthCompareMode == DEPTH_LESS || state.depthCompareMode == DEPTH_LESSEQUAL;
+	}
+
+	bool QuadRasterizer::hierarchicalDepthUpdate() const
+	{
+		// Every covered pixel has to write its depth or keep a smaller one
+		return hierarchicalDepthTest() && state.depthWriteEnable && !state.alphaTestActive() && !state.shaderContainsKill && (state.multiSampleMask & 1);
+	}
+
+	bool QuadRasterizer::hierarchicalDepthInvalidate() const
+	{
+		if(!hierarchicalDepthCulling || complementaryDepthBuffer || !state.hierarchicalDepthBuffer || !state.depthTestActive || !state.depthWriteEnable)
+		{
+			return false;
+		}
+
+		if(state.depthOverride)
+		{
+			return true;
+		}
+
+		switch(state.depthCompareMode)
+		{
+		case DEPTH_NEVER:
+		case DEPTH_EQUAL:
+		case DEPTH_LESS:
+		case DEPTH_LESSEQUAL:
+			return false;   // Depth values can only decrease
+		default:
+			return true;
+		}
+	}
+
 	bool QuadRasterizer::interpolateW() const
 	{
 		return state.perspective || (shader && shader->isVPosDeclared() && fullPixelPositionRegister);
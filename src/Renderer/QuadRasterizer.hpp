@@ -49,6 +49,9 @@ namespace sw
 
 		bool interpolateZ() const;
 		bool interpolateW() const;
+		bool hierarchicalDepthTest() const;
+		bool hierarchicalDepthUpdate() const;
+		bool hierarchicalDepthInvalidate() const;
 		Float4 interpolate(Float4 &x, Float4 &D, Float4 &rhw, Pointer<Byte> planeEquation, bool flat, bool perspective);
 
 		const PixelProcessor::State &state;
@@ -56,6 +59,7 @@ namespace sw
 
 	private:
 		void rasterize(Int &yMin, Int &yMax);
+		Int4 span(const Int &y, unsigned int q);
 	};
 }
 
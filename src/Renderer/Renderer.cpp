@@ -31,6 +31,13 @@
 #include "Debug.hpp"
 #include "Reactor/Reactor.hpp"
 
+#include <cmath>
+
+#if defined(__i386__) || defined(__x86_64__)
+	#include <xmmintrin.h>
+	#include <emmintrin.h>
+#endif
+
 #undef max
 
 bool disableServer = true;
@@ -56,12 +63,15 @@ namespace sw
 	extern bool exactColorRounding;
 	extern TransparencyAntialiasing transparencyAntialiasing;
 	extern bool forceClearRegisters;
+	extern bool uniformSpecialization;
+	extern bool textureTiling;
 
 	extern bool precacheVertex;
 	extern bool precacheSetup;
 	extern bool precachePixel;
 
 	int batchSize = 128;
+	int vertexCacheSize = 64;
 	int threadCount = 1;
 	int unitCount = 1;
 	int clusterCount = 1;
@@ -81,6 +91,8 @@ namespace sw
 	DrawCall::DrawCall()
 	{
 		queries = 0;
+		fences = 0;
+		startTime = 0;
 
 		vsDirtyConstF = VERTEX_UNIFORM_VECTORS + 1;
 		vsDirtyConstI = 16;
@@ -90,6 +102,11 @@ namespace sw
 		psDirtyConstI = 16;
 		psDirtyConstB = 16;
 
+		for(int sampler = 0; sampler < TOTAL_IMAGE_UNITS; sampler++)
+		{
+			textureVersion[sampler] = 0;
+		}
+
 		references = -1;
 
 		data = (DrawData*)allocate(sizeof(DrawData));
@@ -99,6 +116,7 @@ namespace sw
 	DrawCall::~DrawCall()
 	{
 		delete queries;
+		delete fences;
 
 		deallocate(data);
 	}
@@ -148,9 +166,17 @@ namespace sw
 		for(int i = 0; i < 16; i++)
 		{
 			triangleBatch[i] = 0;
+			vertexBatch[i] = 0;
 			primitiveBatch[i] = 0;
 		}
 
+		#if PERF_PROFILE
+			for(int sampler = 0; sampler < TOTAL_IMAGE_UNITS; sampler++)
+			{
+				textureVersion[sampler] = 0;
+			}
+		#endif
+
 		for(int draw = 0; draw < DRAW_COUNT; draw++)
 		{
 			drawCall[draw] = new DrawCall();
@@ -248,7 +274,11 @@ namespace sw
 				pixelRoutine = PixelProcessor::routine(pixelState);
 			}
 
-			int batch = batchSize / ms;
+			int batch = batchSize;
+
+			// Spread small draws over all units, without making batches too short to reuse cached vertices
+			int spread = (count + unitCount - 1) / unitCount;
+			batch = clamp((spread + 1) & ~1, 16, batch);
 
 			int (Renderer::*setupPrimitives)(int batch, int count);
 
@@ -314,7 +344,7 @@ namespace sw
 					Query* q = *query;
 					if(includePrimitivesWrittenQueries || (q->type != Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN))
 					{
-						atomicIncrement(&(q->reference));
+						q->issue();
 						draw->queries->push_back(q);
 					}
 				}
@@ -367,7 +397,7 @@ namespace sw
 					draw->texture[sampler] = context->texture[sampler];
 					draw->texture[sampler]->lock(PUBLIC, isReadWriteTexture(sampler) ? MANAGED : PRIVATE);   // If the texure is both read and written, use the same read/write lock as render targets
 
-					data->mipmap[sampler] = context->sampler[sampler].getTextureData();
+					updateTextureData(draw, sampler);
 				}
 			}
 
@@ -425,7 +455,7 @@ namespace sw
 							draw->texture[TEXTURE_IMAGE_UNITS + sampler] = context->texture[TEXTURE_IMAGE_UNITS + sampler];
 							draw->texture[TEXTURE_IMAGE_UNITS + sampler]->lock(PUBLIC, PRIVATE);
 
-							data->mipmap[TEXTURE_IMAGE_UNITS + sampler] = context->sampler[TEXTURE_IMAGE_UNITS + sampler].getTextureData();
+							updateTextureData(draw, TEXTURE_IMAGE_UNITS + sampler);
 						}
 					}
 				}
@@ -586,6 +616,8 @@ namespace sw
 				data->slopeDepthBias = slopeDepthBias;
 				data->depthRange = Z;
 				data->depthNear = N;
+				data->guardBandX = GUARD_BAND_EXTENT / abs(W);
+				data->guardBandY = GUARD_BAND_EXTENT / abs(H);
 				draw->clipFlags = clipFlags;
 
 				if(clipFlags)
@@ -621,6 +653,8 @@ namespace sw
 					data->depthBuffer = (float*)context->depthBuffer->lockInternal(0, 0, q * ms, LOCK_READWRITE, MANAGED);
 					data->depthPitchB = context->depthBuffer->getInternalPitchB();
 					data->depthSliceB = context->depthBuffer->getInternalSliceB();
+					data->hierarchicalDepth = context->depthBuffer->getHierarchicalDepth();
+					data->hierarchicalDepthPitchB = context->depthBuffer->getHierarchicalDepthPitchB();
 				}
 
 				if(draw->stencilBuffer)
@@ -637,6 +671,19 @@ namespace sw
 				data->scissorX1 = scissor.x1;
 				data->scissorY0 = scissor.y0;
 				data->scissorY1 = scissor.y1;
+
+				// Solid triangles within the guard band are not clipped to the viewport, so the scissor rectangle has to do it.
+				// Wide points and lines still get clipped by their center, and are allowed to extend past the viewport.
+				if(setupPrimitives == &Renderer::setupSolidTriangles)
+				{
+					float viewportY0 = min(viewport.y0, viewport.y0 + viewport.height);
+					float viewportY1 = max(viewport.y0, viewport.y0 + viewport.height);
+
+					data->scissorX0 = max(data->scissorX0, (int)floor(viewport.x0));
+					data->scissorX1 = min(data->scissorX1, (int)ceil(viewport.x0 + viewport.width));
+					data->scissorY0 = max(data->scissorY0, (int)floor(viewportY0));
+					data->scissorY1 = min(data->scissorY1, (int)ceil(viewportY1));
+				}
 			}
 
 			draw->primitive = 0;
@@ -789,6 +836,11 @@ namespace sw
 				int count = draw->count;
 				int batch = draw->batchSize;
 
+				if(primitive == 0 && draw->queries)
+				{
+					draw->startTime = Timer::counter();
+				}
+
 				primitiveProgress[unit].drawCall = currentDraw;
 				primitiveProgress[unit].firstPrimitive = primitive;
 				primitiveProgress[unit].primitiveCount = count - primitive >= batch ? batch : count - primitive;
@@ -965,6 +1017,8 @@ namespace sw
 					}
 				#endif
 
+				retireMutex.lock();
+
 				if(draw.queries)
 				{
 					for(std::list<Query*>::iterator q = draw.queries->begin(); q != draw.queries->end(); q++)
@@ -982,17 +1036,40 @@ namespace sw
 						case Query::TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN:
 							atomicAdd((volatile int*)&query->data, processedPrimitives);
 							break;
+						case Query::TIME_ELAPSED:
+							if(!query->startTime || draw.startTime < query->startTime)
+							{
+								query->startTime = draw.startTime;
+							}
+							query->endTime = Timer::counter();
+							break;
+						case Query::TIMESTAMP:
+							query->endTime = Timer::counter();
+							break;
 						default:
 							break;
 						}
 
-						atomicDecrement(&query->reference);
+						query->retire();   // May release the last reference
 					}
 
 					delete draw.queries;
 					draw.queries = 0;
 				}
 
+				if(draw.fences)
+				{
+					for(std::list<Fence*>::iterator f = draw.fences->begin(); f != draw.fences->end(); f++)
+					{
+						(*f)->retire();   // May release the last reference
+					}
+
+					delete draw.fences;
+					draw.fences = 0;
+				}
+
+				retireMutex.unlock();
+
 				for(int i = 0; i < RENDERTARGETS; i++)
 				{
 					if(draw.renderTarget[i])
@@ -1082,7 +1159,10 @@ namespace sw
 			task->vertexCache.drawCall = primitiveProgress[unit].drawCall;
 		}
 
-		unsigned int batch[128][3];   // FIXME: Adjust to dynamic batch size
+		// Vertex indices, which get replaced with those of the batch vertices holding them
+		static_assert(sizeof(Triangle) == 3 * sizeof(unsigned int), "Triangle isn't an index triplet");
+		unsigned int (*batch)[3] = (unsigned int(*)[3])triangle;
+		ASSERT(triangleCount <= MAX_BATCH_SIZE);
 
 		switch(draw->drawType)
 		{
@@ -1491,66 +1571,314 @@ namespace sw
 
 		task->primitiveStart = start;
 		task->vertexCount = triangleCount * 3;
-		vertexRoutine(&triangle->v0, (unsigned int*)&batch, task, data);
+		task->assignVertices(&batch[0][0], (draw->drawType & DRAW_INDEXED32) != DRAW_NONINDEXED);
+		vertexRoutine(vertexBatch[unit], &batch[0][0], task, data);
+
+		#if PERF_PROFILE
+			atomicAdd(&profiler.vertexIndices, task->vertexCount);
+			atomicAdd(&profiler.vertexInvocations, task->shadeCount);
+			atomicAdd(&profiler.vertexLanes, task->vertexLanes);
+		#endif
 	}
 
 	int Renderer::setupSolidTriangles(int unit, int count)
 	{
-		Triangle *triangle = triangleBatch[unit];
+		const Vertex *vertex = vertexBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
 
 		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall % DRAW_COUNT];
 		SetupProcessor::State &state = draw.setupState;
 		const SetupProcessor::RoutinePointer &setupRoutine = draw.setupPointer;
 
-		int ms = state.multiSample;
 		int pos = state.positionRegister;
 		const DrawData *data = draw.data;
 		int visible = 0;
 
-		for(int i = 0; i < count; i++, triangle++)
+		int survivor[MAX_BATCH_SIZE];
+		int survivors = cullTriangles(triangleBatch[unit], vertex, count, draw, survivor);
+
+		for(int i = 0; i < survivors; i++)
 		{
-			Vertex &v0 = triangle->v0;
-			Vertex &v1 = triangle->v1;
-			Vertex &v2 = triangle->v2;
+			const Triangle *triangle = &triangleBatch[unit][survivor[i]];
+
+			const Vertex &v0 = vertex[triangle->v0];
+			const Vertex &v1 = vertex[triangle->v1];
+			const Vertex &v2 = vertex[triangle->v2];
+
+			Polygon polygon(&v0.v[pos], &v1.v[pos], &v2.v[pos]);
 
-			if((v0.clipFlags & v1.clipFlags & v2.clipFlags) == Clipper::CLIP_FINITE)
+			int clipFlagsOr = v0.clipFlags | v1.clipFlags | v2.clipFlags | draw.clipFlags;
+
+			if(clipFlagsOr != Clipper::CLIP_FINITE && !clipper->isInsideGuardBand(polygon, clipFlagsOr, draw))
 			{
-				Polygon polygon(&v0.v[pos], &v1.v[pos], &v2.v[pos]);
+				if(!clipper->clip(polygon, clipFlagsOr, draw))
+				{
+					continue;
+				}
+			}
 
-				int clipFlagsOr = v0.clipFlags | v1.clipFlags | v2.clipFlags | draw.clipFlags;
+			if(setupRoutine(primitive, triangle, vertex, &polygon, data))
+			{
+				primitive++;
+				visible++;
+			}
+		}
 
-				if(clipFlagsOr != Clipper::CLIP_FINITE)
+		return visible;
+	}
+
+	// Returns the reason a triangle can be rejected before setup, or REJECT_REASONS if it can't. The tests
+	// are performed with the same arithmetic as the setup routine, so they never reject a visible triangle.
+	int Renderer::rejectTriangle(const Triangle &triangle, const Vertex *vertex, const DrawCall &draw)
+	{
+		const SetupProcessor::State &state = draw.setupState;
+		const Vertex &v0 = vertex[triangle.v0];
+		const Vertex &v1 = vertex[triangle.v1];
+		const Vertex &v2 = vertex[triangle.v2];
+
+		if((v0.clipFlags & v1.clipFlags & v2.clipFlags) != Clipper::CLIP_FINITE)
+		{
+			return REJECT_OUTSIDE;
+		}
+
+		float x0 = (float)v0.X;
+		float x1 = (float)v1.X;
+		float x2 = (float)v2.X;
+
+		float y0 = (float)v0.Y;
+		float y1 = (float)v1.Y;
+		float y2 = (float)v2.Y;
+
+		float A = (y2 - y0) * x1 + (y1 - y2) * x0 + (y0 - y1) * x2;   // Area
+
+		if(A == 0.0f)
+		{
+			return REJECT_DEGENERATE;
+		}
+
+		int pos = state.positionRegister;
+		bool w0w1w2 = std::signbit(v0.v[pos].w) ^ std::signbit(v1.v[pos].w) ^ std::signbit(v2.v[pos].w);
+
+		A = w0w1w2 ? -A : A;
+
+		if((state.cullMode == CULL_CLOCKWISE && A >= 0.0f) ||
+		   (state.cullMode == CULL_COUNTERCLOCKWISE && A <= 0.0f))
+		{
+			return REJECT_CULLED;
+		}
+
+		// Without clipping, setup uses the projected vertices and can't find sample centers outside of their bounds
+		if((v0.clipFlags | v1.clipFlags | v2.clipFlags | draw.clipFlags) == Clipper::CLIP_FINITE)
+		{
+			const DrawData *data = draw.data;
+			bool multiSample = state.multiSample > 1;
+
+			int yMin = (min(v0.Y, v1.Y, v2.Y) + (multiSample ? 0x0A : 0x0F)) >> 4;
+			int yMax = (max(v0.Y, v1.Y, v2.Y) + (multiSample ? 0x14 : 0x0F)) >> 4;
+
+			if(yMin == yMax)
+			{
+				return REJECT_SUBPIXEL;
+			}
+
+			if(max(yMin, data->scissorY0) >= min(yMax, data->scissorY1))
+			{
+				return REJECT_OUTSIDE;
+			}
+
+			if(!multiSample)
+			{
+				int xMin = (min(v0.X, v1.X, v2.X) + 0x0F) >> 4;
+				int xMax = (max(v0.X, v1.X, v2.X) + 0x0F) >> 4;
+
+				if(xMin == xMax)
 				{
-					if(!clipper->clip(polygon, clipFlagsOr, draw))
-					{
-						continue;
-					}
+					return REJECT_SUBPIXEL;
 				}
 
-				if(setupRoutine(primitive, triangle, &polygon, data))
+				if(max(xMin, data->scissorX0) >= min(xMax, data->scissorX1))
 				{
-					primitive += ms;
-					visible++;
+					return REJECT_OUTSIDE;
 				}
 			}
 		}
 
-		return visible;
+		return REJECT_REASONS;
+	}
+
+	// Stores the indices of the triangles which can't be rejected before setup, and returns their count.
+	// Groups of four triangles are tested at once with SSE2, in the same order as by rejectTriangle().
+	int Renderer::cullTriangles(const Triangle *triangle, const Vertex *vertex, int count, const DrawCall &draw, int *survivor)
+	{
+		int rejected[REJECT_REASONS + 1] = {};
+		int survivors = 0;
+		int i = 0;
+
+		#if defined(__i386__) || defined(__x86_64__)
+			if(CPUID::supportsSSE2())
+			{
+				const SetupProcessor::State &state = draw.setupState;
+				const DrawData *data = draw.data;
+				const int pos = state.positionRegister;
+				const bool multiSample = state.multiSample > 1;
+
+				const __m128i finite = _mm_set1_epi32(Clipper::CLIP_FINITE);
+				const __m128i clipFlags = _mm_set1_epi32(draw.clipFlags);
+				const __m128i scissorX0 = _mm_set1_epi32(data->scissorX0);
+				const __m128i scissorX1 = _mm_set1_epi32(data->scissorX1);
+				const __m128i scissorY0 = _mm_set1_epi32(data->scissorY0);
+				const __m128i scissorY1 = _mm_set1_epi32(data->scissorY1);
+				const __m128i roundMin = _mm_set1_epi32(multiSample ? 0x0A : 0x0F);
+				const __m128i roundMax = _mm_set1_epi32(multiSample ? 0x14 : 0x0F);
+
+				for(; i + 4 <= count; i += 4)
+				{
+					const Triangle *t = &triangle[i];
+					const Vertex *v0[4] = {&vertex[t[0].v0], &vertex[t[1].v0], &vertex[t[2].v0], &vertex[t[3].v0]};
+					const Vertex *v1[4] = {&vertex[t[0].v1], &vertex[t[1].v1], &vertex[t[2].v1], &vertex[t[3].v1]};
+					const Vertex *v2[4] = {&vertex[t[0].v2], &vertex[t[1].v2], &vertex[t[2].v2], &vertex[t[3].v2]};
+
+					#define GATHER(v, field) _mm_setr_epi32(v[0]->field, v[1]->field, v[2]->field, v[3]->field)
+
+					__m128i f0 = GATHER(v0, clipFlags);
+					__m128i f1 = GATHER(v1, clipFlags);
+					__m128i f2 = GATHER(v2, clipFlags);
+
+					__m128i X0 = GATHER(v0, X);
+					__m128i X1 = GATHER(v1, X);
+					__m128i X2 = GATHER(v2, X);
+
+					__m128i Y0 = GATHER(v0, Y);
+					__m128i Y1 = GATHER(v1, Y);
+					__m128i Y2 = GATHER(v2, Y);
+
+					#undef GATHER
+					#define GATHER(v, field) _mm_castps_si128(_mm_setr_ps(v[0]->field, v[1]->field, v[2]->field, v[3]->field))
+
+					__m128i W0 = GATHER(v0, v[pos].w);
+					__m128i W1 = GATHER(v1, v[pos].w);
+					__m128i W2 = GATHER(v2, v[pos].w);
+
+					#undef GATHER
+
+					int outside = ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_and_si128(f0, f1), f2), finite))) & 0xF;
+
+					__m128 x0 = _mm_cvtepi32_ps(X0);
+					__m128 x1 = _mm_cvtepi32_ps(X1);
+					__m128 x2 = _mm_cvtepi32_ps(X2);
+
+					__m128 y0 = _mm_cvtepi32_ps(Y0);
+					__m128 y1 = _mm_cvtepi32_ps(Y1);
+					__m128 y2 = _mm_cvtepi32_ps(Y2);
+
+					__m128 A = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(y2, y0), x1),
+					                                 _mm_mul_ps(_mm_sub_ps(y1, y2), x0)),
+					                                 _mm_mul_ps(_mm_sub_ps(y0, y1), x2));
+
+					int degenerate = _mm_movemask_ps(_mm_cmpeq_ps(A, _mm_setzero_ps()));
+
+					__m128i sign = _mm_and_si128(_mm_xor_si128(_mm_xor_si128(W0, W1), W2), _mm_set1_epi32(0x80000000));
+					A = _mm_xor_ps(A, _mm_castsi128_ps(sign));
+
+					int culled = 0;
+
+					if(state.cullMode == CULL_CLOCKWISE)
+					{
+						culled = _mm_movemask_ps(_mm_cmpge_ps(A, _mm_setzero_ps()));
+					}
+					else if(state.cullMode == CULL_COUNTERCLOCKWISE)
+					{
+						culled = _mm_movemask_ps(_mm_cmple_ps(A, _mm_setzero_ps()));
+					}
+
+					// Bounds of unclipped triangles. The coordinates are exactly representable as floats.
+					__m128i unclipped = _mm_cmpeq_epi32(_mm_or_si128(_mm_or_si128(_mm_or_si128(f0, f1), f2), clipFlags), finite);
+
+					__m128i yMin = _mm_cvttps_epi32(_mm_min_ps(_mm_min_ps(y0, y1), y2));
+					__m128i yMax = _mm_cvttps_epi32(_mm_max_ps(_mm_max_ps(y0, y1), y2));
+					yMin = _mm_srai_epi32(_mm_add_epi32(yMin, roundMin), 4);
+					yMax = _mm_srai_epi32(_mm_add_epi32(yMax, roundMax), 4);
+
+					__m128i empty = _mm_cmpeq_epi32(yMin, yMax);
+					__m128i visible = _mm_and_si128(_mm_cmplt_epi32(yMin, scissorY1), _mm_cmplt_epi32(scissorY0, yMax));
+					visible = _mm_and_si128(visible, _mm_cmplt_epi32(scissorY0, scissorY1));
+
+					int subpixel = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(unclipped, empty)));
+					int offscreen = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(visible, unclipped)));
+
+					if(!multiSample)
+					{
+						__m128i xMin = _mm_cvttps_epi32(_mm_min_ps(_mm_min_ps(x0, x1), x2));
+						__m128i xMax = _mm_cvttps_epi32(_mm_max_ps(_mm_max_ps(x0, x1), x2));
+						xMin = _mm_srai_epi32(_mm_add_epi32(xMin, roundMin), 4);
+						xMax = _mm_srai_epi32(_mm_add_epi32(xMax, roundMax), 4);
+
+						__m128i emptyX = _mm_cmpeq_epi32(xMin, xMax);
+						__m128i visibleX = _mm_and_si128(_mm_cmplt_epi32(xMin, scissorX1), _mm_cmplt_epi32(scissorX0, xMax));
+						visibleX = _mm_and_si128(visibleX, _mm_cmplt_epi32(scissorX0, scissorX1));
+
+						// The vertical tests come first
+						int subpixelX = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(unclipped, emptyX)));
+						int offscreenX = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(visibleX, unclipped)));
+
+						subpixel |= subpixelX & ~offscreen;
+						offscreen |= offscreenX & ~subpixel;
+					}
+
+					for(int j = 0; j < 4; j++)
+					{
+						int reason = (outside & (1 << j)) ? REJECT_OUTSIDE :
+						             (degenerate & (1 << j)) ? REJECT_DEGENERATE :
+						             (culled & (1 << j)) ? REJECT_CULLED :
+						             (subpixel & (1 << j)) ? REJECT_SUBPIXEL :
+						             (offscreen & (1 << j)) ? REJECT_OUTSIDE : REJECT_REASONS;
+
+						rejected[reason]++;
+
+						if(reason == REJECT_REASONS)
+						{
+							survivor[survivors++] = i + j;
+						}
+					}
+				}
+			}
+		#endif
+
+		for(; i < count; i++)
+		{
+			int reason = rejectTriangle(triangle[i], vertex, draw);
+
+			rejected[reason]++;
+
+			if(reason == REJECT_REASONS)
+			{
+				survivor[survivors++] = i;
+			}
+		}
+
+		#if PERF_PROFILE
+			for(int reason = 0; reason < REJECT_REASONS; reason++)
+			{
+				atomicAdd(&profiler.rejectedTriangles[reason], rejected[reason]);
+			}
+		#endif
+
+		return survivors;
 	}
 
 	int Renderer::setupWireframeTriangle(int unit, int count)
 	{
 		Triangle *triangle = triangleBatch[unit];
+		Vertex *vertex = vertexBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
 		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall % DRAW_COUNT];
 		SetupProcessor::State &state = draw.setupState;
 
-		const Vertex &v0 = triangle[0].v0;
-		const Vertex &v1 = triangle[0].v1;
-		const Vertex &v2 = triangle[0].v2;
+		const Vertex &v0 = vertex[triangle[0].v0];
+		const Vertex &v1 = vertex[triangle[0].v1];
+		const Vertex &v2 = vertex[triangle[0].v2];
 
 		float d = (v0.y * v1.x - v0.x * v1.y) * v2.w + (v0.x * v2.y - v0.y * v2.x) * v1.w + (v2.x * v1.y - v1.x * v2.y) * v0.w;
 
@@ -1563,26 +1891,32 @@ namespace sw
 			if(d <= 0) return 0;
 		}
 
-		// Copy attributes
-		triangle[1].v0 = v1;
-		triangle[1].v1 = v2;
-		triangle[2].v0 = v2;
-		triangle[2].v1 = v0;
+		// Edges
+		triangle[1].v0 = triangle[0].v1;
+		triangle[1].v1 = triangle[0].v2;
+		triangle[2].v0 = triangle[0].v2;
+		triangle[2].v1 = triangle[0].v0;
 
 		if(state.color[0][0].flat)   // FIXME
 		{
+			// Copies of the second and third vertex with the colors of the first, after the three of the batch
+			vertex[3] = v1;
+			vertex[4] = v2;
+
 			for(int i = 0; i < 2; i++)
 			{
-				triangle[1].v0.C[i] = triangle[0].v0.C[i];
-				triangle[1].v1.C[i] = triangle[0].v0.C[i];
-				triangle[2].v0.C[i] = triangle[0].v0.C[i];
-				triangle[2].v1.C[i] = triangle[0].v0.C[i];
+				vertex[3].C[i] = v0.C[i];
+				vertex[4].C[i] = v0.C[i];
 			}
+
+			triangle[1].v0 = 3;
+			triangle[1].v1 = 4;
+			triangle[2].v0 = 4;
 		}
 
 		for(int i = 0; i < 3; i++)
 		{
-			if(setupLine(*primitive, *triangle, draw))
+			if(setupLine(*primitive, *triangle, vertex, draw))
 			{
 				primitive->area = 0.5f * d;
 
@@ -1599,15 +1933,16 @@ namespace sw
 	int Renderer::setupVertexTriangle(int unit, int count)
 	{
 		Triangle *triangle = triangleBatch[unit];
+		Vertex *vertex = vertexBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
 		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall % DRAW_COUNT];
 		SetupProcessor::State &state = draw.setupState;
 
-		const Vertex &v0 = triangle[0].v0;
-		const Vertex &v1 = triangle[0].v1;
-		const Vertex &v2 = triangle[0].v2;
+		const Vertex &v0 = vertex[triangle[0].v0];
+		const Vertex &v1 = vertex[triangle[0].v1];
+		const Vertex &v2 = vertex[triangle[0].v2];
 
 		float d = (v0.y * v1.x - v0.x * v1.y) * v2.w + (v0.x * v2.y - v0.y * v2.x) * v1.w + (v2.x * v1.y - v1.x * v2.y) * v0.w;
 
@@ -1620,13 +1955,13 @@ namespace sw
 			if(d <= 0) return 0;
 		}
 
-		// Copy attributes
-		triangle[1].v0 = v1;
-		triangle[2].v0 = v2;
+		// Points
+		triangle[1].v0 = triangle[0].v1;
+		triangle[2].v0 = triangle[0].v2;
 
 		for(int i = 0; i < 3; i++)
 		{
-			if(setupPoint(*primitive, *triangle, draw))
+			if(setupPoint(*primitive, *triangle, vertex, draw))
 			{
 				primitive->area = 0.5f * d;
 
@@ -1643,19 +1978,17 @@ namespace sw
 	int Renderer::setupLines(int unit, int count)
 	{
 		Triangle *triangle = triangleBatch[unit];
+		Vertex *vertex = vertexBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
 		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall % DRAW_COUNT];
-		SetupProcessor::State &state = draw.setupState;
-
-		int ms = state.multiSample;
 
 		for(int i = 0; i < count; i++)
 		{
-			if(setupLine(*primitive, *triangle, draw))
+			if(setupLine(*primitive, *triangle, vertex, draw))
 			{
-				primitive += ms;
+				primitive++;
 				visible++;
 			}
 
@@ -1668,19 +2001,17 @@ namespace sw
 	int Renderer::setupPoints(int unit, int count)
 	{
 		Triangle *triangle = triangleBatch[unit];
+		Vertex *vertex = vertexBatch[unit];
 		Primitive *primitive = primitiveBatch[unit];
 		int visible = 0;
 
 		DrawCall &draw = *drawList[primitiveProgress[unit].drawCall % DRAW_COUNT];
-		SetupProcessor::State &state = draw.setupState;
-
-		int ms = state.multiSample;
 
 		for(int i = 0; i < count; i++)
 		{
-			if(setupPoint(*primitive, *triangle, draw))
+			if(setupPoint(*primitive, *triangle, vertex, draw))
 			{
-				primitive += ms;
+				primitive++;
 				visible++;
 			}
 
@@ -1690,7 +2021,7 @@ namespace sw
 		return visible;
 	}
 
-	bool Renderer::setupLine(Primitive &primitive, Triangle &triangle, const DrawCall &draw)
+	bool Renderer::setupLine(Primitive &primitive, Triangle &triangle, Vertex *vertex, const DrawCall &draw)
 	{
 		const SetupProcessor::RoutinePointer &setupRoutine = draw.setupPointer;
 		const SetupProcessor::State &state = draw.setupState;
@@ -1698,8 +2029,8 @@ namespace sw
 
 		float lineWidth = data.lineWidth;
 
-		Vertex &v0 = triangle.v0;
-		Vertex &v1 = triangle.v1;
+		Vertex &v0 = vertex[triangle.v0];
+		Vertex &v1 = vertex[triangle.v1];
 
 		int pos = state.positionRegister;
 
@@ -1777,7 +2108,7 @@ namespace sw
 					}
 				}
 
-				return setupRoutine(&primitive, &triangle, &polygon, &data);
+				return setupRoutine(&primitive, &triangle, vertex, &polygon, &data);
 			}
 		}
 		else   // Diamond test convention
@@ -1883,20 +2214,20 @@ namespace sw
 					}
 				}
 
-				return setupRoutine(&primitive, &triangle, &polygon, &data);
+				return setupRoutine(&primitive, &triangle, vertex, &polygon, &data);
 			}
 		}
 
 		return false;
 	}
 
-	bool Renderer::setupPoint(Primitive &primitive, Triangle &triangle, const DrawCall &draw)
+	bool Renderer::setupPoint(Primitive &primitive, Triangle &triangle, Vertex *vertex, const DrawCall &draw)
 	{
 		const SetupProcessor::RoutinePointer &setupRoutine = draw.setupPointer;
 		const SetupProcessor::State &state = draw.setupState;
 		const DrawData &data = *draw.data;
 
-		Vertex &v = triangle.v0;
+		Vertex &v = vertex[triangle.v0];
 
 		float pSize;
 
@@ -1942,11 +2273,12 @@ namespace sw
 		P[3].y -= Y;
 		C[3] = clipper->computeClipFlags(P[3]);
 
-		triangle.v1 = triangle.v0;
-		triangle.v2 = triangle.v0;
+		// The center vertex may be shared with other points, so the corners are copies
+		Vertex corner[3] = {v, v, v};
+		Triangle sprite = {0, 1, 2};
 
-		triangle.v1.X += iround(16 * 0.5f * pSize);
-		triangle.v2.Y -= iround(16 * 0.5f * pSize) * (data.Hx16[0] > 0.0f ? 1 : -1);   // Both Direct3D and OpenGL expect (0, 0) in the top-left corner
+		corner[1].X += iround(16 * 0.5f * pSize);
+		corner[2].Y -= iround(16 * 0.5f * pSize) * (data.Hx16[0] > 0.0f ? 1 : -1);   // Both Direct3D and OpenGL expect (0, 0) in the top-left corner
 
 		Polygon polygon(P, 4);
 
@@ -1962,7 +2294,7 @@ namespace sw
 				}
 			}
 
-			return setupRoutine(&primitive, &triangle, &polygon, &data);
+			return setupRoutine(&primitive, &sprite, corner, &polygon, &data);
 		}
 
 		return false;
@@ -1976,12 +2308,14 @@ namespace sw
 		for(int i = 0; i < unitCount; i++)
 		{
 			triangleBatch[i] = (Triangle*)allocate(batchSize * sizeof(Triangle));
+			vertexBatch[i] = (Vertex*)allocate(batchSize * 3 * sizeof(Vertex));
 			primitiveBatch[i] = (Primitive*)allocate(batchSize * sizeof(Primitive));
 		}
 
 		for(int i = 0; i < threadCount; i++)
 		{
 			vertexTask[i] = (VertexTask*)allocate(sizeof(VertexTask));
+			vertexTask[i]->vertexCache.initialize(vertexCacheSize);
 			vertexTask[i]->vertexCache.drawCall = -1;
 
 			task[i].type = Task::SUSPEND;
@@ -2024,6 +2358,11 @@ namespace sw
 				suspend[thread] = 0;
 			}
 
+			if(vertexTask[thread])
+			{
+				vertexTask[thread]->vertexCache.release();
+			}
+
 			deallocate(vertexTask[thread]);
 			vertexTask[thread] = 0;
 		}
@@ -2033,6 +2372,9 @@ namespace sw
 			deallocate(triangleBatch[i]);
 			triangleBatch[i] = 0;
 
+			deallocate(vertexBatch[i]);
+			vertexBatch[i] = 0;
+
 			deallocate(primitiveBatch[i]);
 			primitiveBatch[i] = 0;
 		}
@@ -2159,6 +2501,26 @@ namespace sw
 		return false;
 	}
 
+	void Renderer::updateTextureData(DrawCall *draw, int sampler)
+	{
+		unsigned int version = context->sampler[sampler].getTextureVersion();
+
+		// Each draw call keeps its copy of the descriptor, so only copy it again after it changed
+		if(draw->textureVersion[sampler] != version)
+		{
+			draw->data->mipmap[sampler] = context->sampler[sampler].getTextureData();
+			draw->textureVersion[sampler] = version;
+		}
+
+		#if PERF_PROFILE
+			if(textureVersion[sampler] != version)
+			{
+				textureVersion[sampler] = version;
+				atomicAdd(&profiler.textureDescriptors, 1);
+			}
+		#endif
+	}
+
 	void Renderer::updateClipper()
 	{
 		if(updateClipPlanes)
@@ -2609,6 +2971,54 @@ namespace sw
 		queries.remove(query);
 	}
 
+	void Renderer::addFence(Fence *fence)
+	{
+		retireMutex.lock();
+
+		for(int i = 0; i < DRAW_COUNT; i++)
+		{
+			DrawCall *draw = drawCall[i];
+
+			if(draw->references > 0)   // Still drawing
+			{
+				if(!draw->fences)
+				{
+					draw->fences = new std::list<Fence*>();
+				}
+
+				draw->fences->push_back(fence);
+				fence->issue();
+			}
+		}
+
+		retireMutex.unlock();
+	}
+
+	void Renderer::addTimestamp(Query *query)
+	{
+		retireMutex.lock();
+
+		query->endTime = Timer::counter();   // When no draw calls are in flight
+
+		for(int i = 0; i < DRAW_COUNT; i++)
+		{
+			DrawCall *draw = drawCall[i];
+
+			if(draw->references > 0)   // Still drawing
+			{
+				if(!draw->queries)
+				{
+					draw->queries = new std::list<Query*>();
+				}
+
+				draw->queries->push_back(query);
+				query->issue();
+			}
+		}
+
+		retireMutex.unlock();
+	}
+
 	#if PERF_HUD
 		int Renderer::getThreadCount()
 		{
@@ -2686,6 +3096,10 @@ namespace sw
 			PixelProcessor::setRoutineCacheSize(configuration.pixelRoutineCacheSize);
 			SetupProcessor::setRoutineCacheSize(configuration.setupRoutineCacheSize);
 
+			// Well-ordered meshes have about half as many vertices as triangles, so this fills the cache
+			vertexCacheSize = clamp(ceilPow2(configuration.vertexCacheSize), 16, 4096);
+			batchSize = clamp(2 * vertexCacheSize, 128, (int)MAX_BATCH_SIZE);
+
 			switch(configuration.textureSampleQuality)
 			{
 			case 0:  Sampler::setFilterQuality(FILTER_POINT);       break;
@@ -2773,6 +3187,8 @@ namespace sw
 			postBlendSRGB = configuration.postBlendSRGB;
 			exactColorRounding = configuration.exactColorRounding;
 			forceClearRegisters = configuration.forceClearRegisters;
+			uniformSpecialization = configuration.uniformSpecialization;
+			textureTiling = configuration.textureTiling;
 
 		#ifndef NDEBUG
 			minPrimitives = configuration.minPrimitives;
@@ -20,6 +20,7 @@
 #include "SetupProcessor.hpp"
 #include "Plane.hpp"
 #include "Blitter.hpp"
+#include "Fence.hpp"
 #include "Common/MutexLock.hpp"
 #include "Common/Thread.hpp"
 #include "Main/Config.hpp"
@@ -90,11 +91,13 @@ namespace sw
 		false,   // colorsDefaultToZero
 	};
 
-	struct Query
+	// Signaled once the draw calls it was issued to have completed, and released
+	// with the same reference counting as a fence
+	struct Query : public Fence
 	{
-		enum Type { FRAGMENTS_PASSED, TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN };
+		enum Type { FRAGMENTS_PASSED, TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, TIME_ELAPSED, TIMESTAMP };
 
-		Query(Type type) : building(false), reference(0), data(0), type(type)
+		Query(Type type) : building(false), data(0), startTime(0), endTime(0), type(type)
 		{
 		}
 
@@ -102,6 +105,8 @@ namespace sw
 		{
 			building = true;
 			data = 0;
+			startTime = 0;
+			endTime = 0;
 		}
 
 		void end()
@@ -110,9 +115,14 @@ namespace sw
 		}
 
 		bool building;
-		volatile int reference;
 		volatile unsigned int data;
 
+		// Timer::counter() values of timer queries. The time elapsed spans from when the first
+		// of their draw calls started to when the last one completed, or is zero without any.
+		// A timestamp is when the draw calls before it have all completed.
+		int64_t startTime;
+		int64_t endTime;
+
 		const Type type;
 	};
 
@@ -184,6 +194,8 @@ namespace sw
 		float slopeDepthBias;
 		float depthRange;
 		float depthNear;
+		float guardBandX;   // Clip-space extent of the guard band
+		float guardBandY;
 		Plane clipPlane[6];
 
 		unsigned int *colorBuffer[RENDERTARGETS];
@@ -192,6 +204,8 @@ namespace sw
 		float *depthBuffer;
 		int depthPitchB;
 		int depthSliceB;
+		float *hierarchicalDepth;
+		int hierarchicalDepthPitchB;
 		unsigned char *stencilBuffer;
 		int stencilPitchB;
 		int stencilSliceB;
@@ -245,7 +259,11 @@ namespace sw
 		unsigned int psDirtyConstI;
 		unsigned int psDirtyConstB;
 
+		unsigned int textureVersion[TOTAL_IMAGE_UNITS];   // Sampler descriptor versions copied into the draw data
+
 		std::list<Query*> *queries;
+		std::list<Fence*> *fences;   // Fences issued after this draw call
+		int64_t startTime;           // Timer::counter() when the first batch got scheduled, for timer queries
 
 		int clipFlags;
 
@@ -394,6 +412,9 @@ namespace sw
 		void addQuery(Query *query);
 		void removeQuery(Query *query);
 
+		void addFence(Fence *fence);   // Signaled once all draw calls issued so far have completed
+		void addTimestamp(Query *query);   // Completed along with all draw calls issued so far
+
 		void synchronize();
 
 		#if PERF_HUD
@@ -417,15 +438,18 @@ namespace sw
 		void processPrimitiveVertices(int unit, unsigned int start, unsigned int count, unsigned int loop, int thread);
 
 		int setupSolidTriangles(int batch, int count);
+		int rejectTriangle(const Triangle &triangle, const Vertex *vertex, const DrawCall &draw);
+		int cullTriangles(const Triangle *triangle, const Vertex *vertex, int count, const DrawCall &draw, int *survivor);
 		int setupWireframeTriangle(int batch, int count);
 		int setupVertexTriangle(int batch, int count);
 		int setupLines(int batch, int count);
 		int setupPoints(int batch, int count);
 
-		bool setupLine(Primitive &primitive, Triangle &triangle, const DrawCall &draw);
-		bool setupPoint(Primitive &primitive, Triangle &triangle, const DrawCall &draw);
+		bool setupLine(Primitive &primitive, Triangle &triangle, Vertex *vertex, const DrawCall &draw);
+		bool setupPoint(Primitive &primitive, Triangle &triangle, Vertex *vertex, const DrawCall &draw);
 
 		bool isReadWriteTexture(int sampler);
+		void updateTextureData(DrawCall *draw, int sampler);
 		void updateClipper();
 		void updateConfiguration(bool initialUpdate = false);
 		void initializeThreads();
@@ -442,6 +466,7 @@ namespace sw
 		int clipFlags;
 
 		Triangle *triangleBatch[16];
+		Vertex *vertexBatch[16];
 		Primitive *primitiveBatch[16];
 
 		// User-defined clipping planes
@@ -472,6 +497,7 @@ namespace sw
 		unsigned int qSize;
 
 		MutexLock schedulerMutex;
+		MutexLock retireMutex;   // Guards the queries and fences of draw calls in flight
 
 		#if PERF_HUD
 			int64_t vertexTime[16];
@@ -481,6 +507,10 @@ namespace sw
 
 		VertexTask *vertexTask[16];
 
+		#if PERF_PROFILE
+			unsigned int textureVersion[TOTAL_IMAGE_UNITS];   // Latest descriptor versions drawn with
+		#endif
+
 		SwiftConfig *swiftConfig;
 
 		std::list<Query*> queries;
@@ -24,6 +24,8 @@
 
 namespace sw
 {
+	extern bool textureTiling;
+
 	FilterType Sampler::maximumTextureFilterQuality = FILTER_LINEAR;
 	MipmapType Sampler::maximumMipmapFilterQuality = MIPMAP_POINT;
 
@@ -47,8 +49,12 @@ namespace sw
 			{
 				mipmap.buffer[face] = &zero;
 			}
+
+			levelFormat[level] = FORMAT_NULL;
 		}
 
+		textureVersion = 1;
+
 		externalTextureFormat = FORMAT_NULL;
 		internalTextureFormat = FORMAT_NULL;
 		textureType = TEXTURE_NULL;
@@ -61,6 +67,7 @@ namespace sw
 		sRGB = false;
 		gather = false;
 		highPrecisionFiltering = false;
+		tiledLayout = false;
 
 		swizzleR = SWIZZLE_RED;
 		swizzleG = SWIZZLE_GREEN;
@@ -99,6 +106,7 @@ namespace sw
 			state.swizzleB = swizzleB;
 			state.swizzleA = swizzleA;
 			state.highPrecisionFiltering = highPrecisionFiltering;
+			state.tiledLayout = tiledLayout;
 
 			#if PERF_PROFILE
 				state.compressedFormat = Surface::isCompressed(externalTextureFormat);
@@ -114,18 +122,42 @@ namespace sw
 		{
 			Mipmap &mipmap = texture.mipmap[level];
 
-			mipmap.buffer[face] = surface->lockInternal(0, 0, 0, LOCK_UNLOCKED, PRIVATE);
+			bool tiled = textureTiling && type == TEXTURE_2D && surface->isTileable();
+
+			const void *buffer = tiled ? surface->getTiled() : surface->lockInternal(0, 0, 0, LOCK_UNLOCKED, PRIVATE);
+
+			if(face != 0 && mipmap.buffer[face] != buffer)
+			{
+				mipmap.buffer[face] = buffer;
+				textureVersion++;
+			}
 
 			if(face == 0)
 			{
 				externalTextureFormat = surface->getExternalFormat();
 				internalTextureFormat = surface->getInternalFormat();
+				tiledLayout = tiled;
 
 				int width = surface->getWidth();
 				int height = surface->getHeight();
 				int depth = surface->getDepth();
-				int pitchP = surface->getInternalPitchP();
-				int sliceP = surface->getInternalSliceP();
+				int pitchP = tiled ? surface->getTiledPitchP() : surface->getInternalPitchP();
+				int sliceP = tiled ? surface->getTiledSliceP() : surface->getInternalSliceP();
+
+				// The level's descriptor is derived from these alone, so it is only rebuilt when one of them changes
+				if(mipmap.buffer[0] == buffer && levelFormat[level] == internalTextureFormat &&
+				   mipmap.width[0] == width && mipmap.height[0] == height && mipmap.depth[0] == depth &&
+				   mipmap.pitchP[0] == pitchP && mipmap.sliceP[0] == sliceP &&
+				   (level != 0 || (texture.widthLOD[0] == width * exp2LOD && texture.heightLOD[0] == height * exp2LOD && texture.depthLOD[0] == depth * exp2LOD)))
+				{
+					textureType = type;
+
+					return;
+				}
+
+				mipmap.buffer[0] = buffer;
+				levelFormat[level] = internalTextureFormat;
+				textureVersion++;
 
 				if(level == 0)
 				{
@@ -291,6 +323,12 @@ namespace sw
 		short b = iround(0xFFFF * borderColor.b);
 		short a = iround(0xFFFF * borderColor.a);
 
+		if(texture.borderColorF[0][0] == borderColor.r && texture.borderColorF[1][0] == borderColor.g &&
+		   texture.borderColorF[2][0] == borderColor.b && texture.borderColorF[3][0] == borderColor.a)
+		{
+			return;
+		}
+
 		texture.borderColor4[0][0] = texture.borderColor4[0][1] = texture.borderColor4[0][2] = texture.borderColor4[0][3] = r;
 		texture.borderColor4[1][0] = texture.borderColor4[1][1] = texture.borderColor4[1][2] = texture.borderColor4[1][3] = g;
 		texture.borderColor4[2][0] = texture.borderColor4[2][1] = texture.borderColor4[2][2] = texture.borderColor4[2][3] = b;
@@ -300,11 +338,13 @@ namespace sw
 		texture.borderColorF[1][0] = texture.borderColorF[1][1] = texture.borderColorF[1][2] = texture.borderColorF[1][3] = borderColor.g;
 		texture.borderColorF[2][0] = texture.borderColorF[2][1] = texture.borderColorF[2][2] = texture.borderColorF[2][3] = borderColor.b;
 		texture.borderColorF[3][0] = texture.borderColorF[3][1] = texture.borderColorF[3][2] = texture.borderColorF[3][3] = borderColor.a;
+
+		textureVersion++;
 	}
 
 	void Sampler::setMaxAnisotropy(float maxAnisotropy)
 	{
-		texture.maxAnisotropy = maxAnisotropy;
+		setTextureParameter(texture.maxAnisotropy, maxAnisotropy);
 	}
 
 	void Sampler::setHighPrecisionFiltering(bool highPrecisionFiltering)
@@ -334,22 +374,22 @@ namespace sw
 
 	void Sampler::setBaseLevel(int baseLevel)
 	{
-		texture.baseLevel = baseLevel;
+		setTextureParameter(texture.baseLevel, baseLevel);
 	}
 
 	void Sampler::setMaxLevel(int maxLevel)
 	{
-		texture.maxLevel = maxLevel;
+		setTextureParameter(texture.maxLevel, maxLevel);
 	}
 
 	void Sampler::setMinLod(float minLod)
 	{
-		texture.minLod = clamp(minLod, 0.0f, (float)(MIPMAP_LEVELS - 2));
+		setTextureParameter(texture.minLod, clamp(minLod, 0.0f, (float)(MIPMAP_LEVELS - 2)));
 	}
 
 	void Sampler::setMaxLod(float maxLod)
 	{
-		texture.maxLod = clamp(maxLod, 0.0f, (float)(MIPMAP_LEVELS - 2));
+		setTextureParameter(texture.maxLod, clamp(maxLod, 0.0f, (float)(MIPMAP_LEVELS - 2)));
 	}
 
 	void Sampler::setFilterQuality(FilterType maximumFilterQuality)
@@ -364,7 +404,7 @@ namespace sw
 
 	void Sampler::setMipmapLOD(float LOD)
 	{
-		texture.LOD = LOD;
+		setTextureParameter(texture.LOD, LOD);
 		exp2LOD = exp2(LOD);
 	}
 
@@ -396,6 +436,21 @@ namespace sw
 		return texture;
 	}
 
+	unsigned int Sampler::getTextureVersion() const
+	{
+		return textureVersion;
+	}
+
+	template<class T>
+	void Sampler::setTextureParameter(T &parameter, T value)
+	{
+		if(parameter != value)
+		{
+			parameter = value;
+			textureVersion++;
+		}
+	}
+
 	MipmapType Sampler::mipmapFilter() const
 	{
 		if(mipmapFilterState != MIPMAP_NONE)
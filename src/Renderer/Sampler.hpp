@@ -142,6 +142,7 @@ namespace sw
 			SwizzleType swizzleB           : BITS(SWIZZLE_LAST);
 			SwizzleType swizzleA           : BITS(SWIZZLE_LAST);
 			bool highPrecisionFiltering    : 1;
+			bool tiledLayout               : 1;
 
 			#if PERF_PROFILE
 			bool compressedFormat          : 1;
@@ -185,6 +186,7 @@ namespace sw
 		bool hasVolumeTexture() const;
 
 		const Texture &getTextureData();
+		unsigned int getTextureVersion() const;
 
 	private:
 		MipmapType mipmapFilter() const;
@@ -193,6 +195,8 @@ namespace sw
 		AddressingMode getAddressingModeU() const;
 		AddressingMode getAddressingModeV() const;
 		AddressingMode getAddressingModeW() const;
+		template<class T>
+		void setTextureParameter(T &parameter, T value);
 
 		Format externalTextureFormat;
 		Format internalTextureFormat;
@@ -206,6 +210,7 @@ namespace sw
 		bool sRGB;
 		bool gather;
 		bool highPrecisionFiltering;
+		bool tiledLayout;   // Levels are sampled from 4x4 tiled copies
 
 		SwizzleType swizzleR;
 		SwizzleType swizzleG;
@@ -214,6 +219,9 @@ namespace sw
 		Texture texture;
 		float exp2LOD;
 
+		unsigned int textureVersion;   // Incremented whenever the texture descriptor changes
+		Format levelFormat[MIPMAP_LEVELS];
+
 		static FilterType maximumTextureFilterQuality;
 		static MipmapType maximumMipmapFilterQuality;
 	};
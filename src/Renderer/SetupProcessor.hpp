@@ -83,7 +83,7 @@ namespace sw
 			unsigned int hash;
 		};
 
-		typedef bool (*RoutinePointer)(Primitive *primitive, const Triangle *triangle, const Polygon *polygon, const DrawData *draw);
+		typedef bool (*RoutinePointer)(Primitive *primitive, const Triangle *triangle, const Vertex *vertex, const Polygon *polygon, const DrawData *draw);
 
 		SetupProcessor(Context *context);
 
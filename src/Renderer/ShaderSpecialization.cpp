@@ -0,0 +1,107 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ShaderSpecialization.hpp"
+
+#include "Common/Debug.hpp"
+
+#include <string.h>
+
+namespace sw
+{
+	ShaderSpecialization::ShaderSpecialization()
+	{
+		for(int i = 0; i < HISTORY_SIZE; i++)
+		{
+			history[i].shaderID = 0;   // Serial IDs start at 1
+		}
+	}
+
+	bool ShaderSpecialization::specialize(const Shader *shader, const float4 *c, unsigned int constantCount, const int4 *i, const bool *b, int value[Shader::MAX_BRANCH_CONSTANTS])
+	{
+		const int count = shader->getBranchConstantCount();
+
+		if(count == 0)
+		{
+			return false;
+		}
+
+		int current[Shader::MAX_BRANCH_CONSTANTS] = {0};
+
+		for(int n = 0; n < count; n++)
+		{
+			const Shader::BranchConstant &constant = shader->getBranchConstant(n);
+
+			switch(constant.type)
+			{
+			case Shader::PARAMETER_CONST:
+				if(constant.index >= constantCount)
+				{
+					return false;
+				}
+
+				memcpy(&current[n], &c[constant.index][constant.component], sizeof(int));
+				break;
+			case Shader::PARAMETER_CONSTINT:
+				if(constant.index >= 16)
+				{
+					return false;
+				}
+
+				current[n] = i[constant.index][constant.component];
+				break;
+			case Shader::PARAMETER_CONSTBOOL:
+				if(constant.index >= 16)
+				{
+					return false;
+				}
+
+				current[n] = b[constant.index] ? 1 : 0;
+				break;
+			default:
+				ASSERT(false);
+			}
+		}
+
+		History &entry = history[shader->getSerialID() % HISTORY_SIZE];
+
+		if(entry.shaderID != shader->getSerialID())
+		{
+			entry.shaderID = shader->getSerialID();
+			entry.changes = 0;
+			entry.draws = 0;
+		}
+		else if(memcmp(entry.value, current, sizeof(current)) != 0)
+		{
+			entry.changes++;
+		}
+
+		memcpy(entry.value, current, sizeof(current));
+
+		if(++entry.draws == DECAY_PERIOD)
+		{
+			entry.changes /= 2;
+			entry.draws = 0;
+		}
+
+		if(entry.changes > MAX_CHANGES)
+		{
+			return false;
+		}
+
+		memcpy(value, current, sizeof(current));
+
+		return true;
+	}
+}
@@ -0,0 +1,53 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef sw_ShaderSpecialization_hpp
+#define sw_ShaderSpecialization_hpp
+
+#include "Shader/Shader.hpp"
+#include "Common/Types.hpp"
+
+namespace sw
+{
+	extern bool uniformSpecialization;
+
+	// Decides whether to specialize a shader's routine on the current values of its
+	// branch constants. Shaders whose values keep changing get the generic routine,
+	// instead of generating a new routine for most of their draws.
+	class ShaderSpecialization
+	{
+	public:
+		ShaderSpecialization();
+
+		// Returns true and the values to compile into the routine, or false for the generic routine
+		bool specialize(const Shader *shader, const float4 *c, unsigned int constantCount, const int4 *i, const bool *b, int value[Shader::MAX_BRANCH_CONSTANTS]);
+
+	private:
+		enum {HISTORY_SIZE = 64};   // Shaders tracked, direct mapped on serial ID
+		enum {DECAY_PERIOD = 64};   // Draws after which the count of value changes is halved
+		enum {MAX_CHANGES = 4};     // Count of value changes above which values are considered unstable
+
+		struct History
+		{
+			int shaderID;
+			int value[Shader::MAX_BRANCH_CONSTANTS];
+			int changes;
+			int draws;
+		};
+
+		History history[HISTORY_SIZE];
+	};
+}
+
+#endif   // sw_ShaderSpecialization_hpp
@@ -18,13 +18,17 @@
 #include "Context.hpp"
 #include "ETC_Decoder.hpp"
 #include "Renderer.hpp"
+#include "Common/Convert.hpp"
 #include "Common/Half.hpp"
 #include "Common/Memory.hpp"
 #include "Common/CPUID.hpp"
 #include "Common/Resource.hpp"
+#include "Common/WorkerPool.hpp"
 #include "Common/Debug.hpp"
 #include "Reactor/Reactor.hpp"
 
+#include <float.h>
+
 #if defined(__i386__) || defined(__x86_64__)
 	#include <xmmintrin.h>
 	#include <emmintrin.h>
@@ -41,6 +45,7 @@ namespace sw
 
 	unsigned int *Surface::palette = 0;
 	unsigned int Surface::paletteID = 0;
+	int Surface::decodeBandCount = 0;
 
 	void Rect::clip(int minX, int minY, int maxX, int maxY)
 	{
@@ -1243,8 +1248,23 @@ namespace sw
 		stencil.lock = LOCK_UNLOCKED;
 		stencil.dirty = false;
 
+		tiled.buffer = 0;
+		tiled.width = align(width, 4);
+		tiled.height = align(height, 4);
+		tiled.depth = 1;
+		tiled.format = internal.format;
+		tiled.bytes = internal.bytes;
+		tiled.pitchB = tiled.width * tiled.bytes;
+		tiled.pitchP = tiled.width;
+		tiled.sliceB = tiled.pitchB * tiled.height;
+		tiled.sliceP = tiled.pitchP * tiled.height;
+		tiled.lock = LOCK_UNLOCKED;
+		tiled.dirty = true;
+
 		dirtyMipmaps = true;
 		paletteUsed = 0;
+
+		hierarchicalDepth = 0;
 	}
 
 	Surface::Surface(Resource *texture, int width, int height, int depth, Format format, bool lockable, bool renderTarget, int pitchPprovided) : lockable(lockable), renderTarget(renderTarget)
@@ -1293,8 +1313,23 @@ namespace sw
 		stencil.lock = LOCK_UNLOCKED;
 		stencil.dirty = false;
 
+		tiled.buffer = 0;
+		tiled.width = align(width, 4);
+		tiled.height = align(height, 4);
+		tiled.depth = 1;
+		tiled.format = internal.format;
+		tiled.bytes = internal.bytes;
+		tiled.pitchB = tiled.width * tiled.bytes;
+		tiled.pitchP = tiled.width;
+		tiled.sliceB = tiled.pitchB * tiled.height;
+		tiled.sliceP = tiled.pitchP * tiled.height;
+		tiled.lock = LOCK_UNLOCKED;
+		tiled.dirty = true;
+
 		dirtyMipmaps = true;
 		paletteUsed = 0;
+
+		hierarchicalDepth = 0;
 	}
 
 	Surface::~Surface()
@@ -1319,10 +1354,13 @@ namespace sw
 		}
 
 		deallocate(stencil.buffer);
+		deallocate(tiled.buffer);
+		deallocate(hierarchicalDepth);
 
 		external.buffer = 0;
 		internal.buffer = 0;
 		stencil.buffer = 0;
+		tiled.buffer = 0;
 	}
 
 	void *Surface::lockExternal(int x, int y, int z, Lock lock, Accessor client)
@@ -1423,6 +1461,8 @@ namespace sw
 			if(lock != LOCK_DISCARD)
 			{
 				update(internal, external);
+				invalidateHierarchicalDepth();
+				tiled.dirty = true;
 			}
 
 			external.dirty = false;
@@ -1438,6 +1478,13 @@ namespace sw
 		case LOCK_READWRITE:
 		case LOCK_DISCARD:
 			dirtyMipmaps = true;
+			tiled.dirty = true;
+
+			// Only the renderer keeps the tile bounds up to date
+			if(client == PUBLIC)
+			{
+				invalidateHierarchicalDepth();
+			}
 			break;
 		default:
 			ASSERT(false);
@@ -1874,6 +1921,10 @@ namespace sw
 		int width = min(destination.width, source.width);
 		int rowBytes = width * source.bytes;
 
+		// Half precision float formats with the same channels as the single precision ones are converted in bulk
+		int halfToFloatChannels = halfFloatChannels(source.format, destination.format);
+		int floatToHalfChannels = halfFloatChannels(destination.format, source.format);
+
 		for(int z = 0; z < depth; z++)
 		{
 			unsigned char *sourceRow = sourceSlice;
@@ -1885,6 +1936,14 @@ namespace sw
 				{
 					memcpy(destinationRow, sourceRow, rowBytes);
 				}
+				else if(halfToFloatChannels)
+				{
+					halfToFloat((float*)destinationRow, (unsigned short*)sourceRow, width * halfToFloatChannels);
+				}
+				else if(floatToHalfChannels)
+				{
+					floatToHalf((unsigned short*)destinationRow, (float*)sourceRow, width * floatToHalfChannels);
+				}
 				else
 				{
 					unsigned char *sourceElement = sourceRow;
@@ -1913,6 +1972,7 @@ namespace sw
 	{
 		unsigned char *sourceSlice = (unsigned char*)source.buffer;
 		unsigned char *destinationSlice = (unsigned char*)destination.buffer;
+		int width = min(destination.width, source.width);
 
 		for(int z = 0; z < destination.depth && z < source.depth; z++)
 		{
@@ -1921,20 +1981,7 @@ namespace sw
 
 			for(int y = 0; y < destination.height && y < source.height; y++)
 			{
-				unsigned char *sourceElement = sourceRow;
-				unsigned char *destinationElement = destinationRow;
-
-				for(int x = 0; x < destination.width && x < source.width; x++)
-				{
-					unsigned int b = sourceElement[0];
-					unsigned int g = sourceElement[1];
-					unsigned int r = sourceElement[2];
-
-					*(unsigned int*)destinationElement = 0xFF000000 | (r << 16) | (g << 8) | (b << 0);
-
-					sourceElement += source.bytes;
-					destinationElement += destination.bytes;
-				}
+				unpackR8G8B8(destinationRow, sourceRow, width);
 
 				sourceRow += source.pitchB;
 				destinationRow += destination.pitchB;
@@ -1949,6 +1996,7 @@ namespace sw
 	{
 		unsigned char *sourceSlice = (unsigned char*)source.buffer;
 		unsigned char *destinationSlice = (unsigned char*)destination.buffer;
+		int width = min(destination.width, source.width);
 
 		for(int z = 0; z < destination.depth && z < source.depth; z++)
 		{
@@ -1957,22 +2005,7 @@ namespace sw
 
 			for(int y = 0; y < destination.height && y < source.height; y++)
 			{
-				unsigned char *sourceElement = sourceRow;
-				unsigned char *destinationElement = destinationRow;
-
-				for(int x = 0; x < destination.width && x < source.width; x++)
-				{
-					unsigned int xrgb = *(unsigned short*)sourceElement;
-
-					unsigned int r = (((xrgb & 0x7C00) * 134771 + 0x800000) >> 8) & 0x00FF0000;
-					unsigned int g = (((xrgb & 0x03E0) * 16846 + 0x8000) >> 8) & 0x0000FF00;
-					unsigned int b = (((xrgb & 0x001F) * 2106  + 0x80) >> 8);
-
-					*(unsigned int*)destinationElement = 0xFF000000 | r | g | b;
-
-					sourceElement += source.bytes;
-					destinationElement += destination.bytes;
-				}
+				unpackX1R5G5B5(destinationRow, sourceRow, width);
 
 				sourceRow += source.pitchB;
 				destinationRow += destination.pitchB;
@@ -1987,6 +2020,7 @@ namespace sw
 	{
 		unsigned char *sourceSlice = (unsigned char*)source.buffer;
 		unsigned char *destinationSlice = (unsigned char*)destination.buffer;
+		int width = min(destination.width, source.width);
 
 		for(int z = 0; z < destination.depth && z < source.depth; z++)
 		{
@@ -1995,23 +2029,7 @@ namespace sw
 
 			for(int y = 0; y < destination.height && y < source.height; y++)
 			{
-				unsigned char *sourceElement = sourceRow;
-				unsigned char *destinationElement = destinationRow;
-
-				for(int x = 0; x < destination.width && x < source.width; x++)
-				{
-					unsigned int argb = *(unsigned short*)sourceElement;
-
-					unsigned int a =   (argb & 0x8000) * 130560;
-					unsigned int r = (((argb & 0x7C00) * 134771 + 0x800000) >> 8) & 0x00FF0000;
-					unsigned int g = (((argb & 0x03E0) * 16846  + 0x8000) >> 8) & 0x0000FF00;
-					unsigned int b = (((argb & 0x001F) * 2106   + 0x80) >> 8);
-
-					*(unsigned int*)destinationElement = a | r | g | b;
-
-					sourceElement += source.bytes;
-					destinationElement += destination.bytes;
-				}
+				unpackA1R5G5B5(destinationRow, sourceRow, width);
 
 				sourceRow += source.pitchB;
 				destinationRow += destination.pitchB;
@@ -2026,6 +2044,7 @@ namespace sw
 	{
 		unsigned char *sourceSlice = (unsigned char*)source.buffer;
 		unsigned char *destinationSlice = (unsigned char*)destination.buffer;
+		int width = min(destination.width, source.width);
 
 		for(int z = 0; z < destination.depth && z < source.depth; z++)
 		{
@@ -2034,22 +2053,7 @@ namespace sw
 
 			for(int y = 0; y < destination.height && y < source.height; y++)
 			{
-				unsigned char *sourceElement = sourceRow;
-				unsigned char *destinationElement = destinationRow;
-
-				for(int x = 0; x < destination.width && x < source.width; x++)
-				{
-					unsigned int xrgb = *(unsigned short*)sourceElement;
-
-					unsigned int r = ((xrgb & 0x0F00) * 0x00001100) & 0x00FF0000;
-					unsigned int g = ((xrgb & 0x00F0) * 0x00000110) & 0x0000FF00;
-					unsigned int b =  (xrgb & 0x000F) * 0x00000011;
-
-					*(unsigned int*)destinationElement = 0xFF000000 | r | g | b;
-
-					sourceElement += source.bytes;
-					destinationElement += destination.bytes;
-				}
+				unpackX4R4G4B4(destinationRow, sourceRow, width);
 
 				sourceRow += source.pitchB;
 				destinationRow += destination.pitchB;
@@ -2064,6 +2068,7 @@ namespace sw
 	{
 		unsigned char *sourceSlice = (unsigned char*)source.buffer;
 		unsigned char *destinationSlice = (unsigned char*)destination.buffer;
+		int width = min(destination.width, source.width);
 
 		for(int z = 0; z < destination.depth && z < source.depth; z++)
 		{
@@ -2072,23 +2077,7 @@ namespace sw
 
 			for(int y = 0; y < destination.height && y < source.height; y++)
 			{
-				unsigned char *sourceElement = sourceRow;
-				unsigned char *destinationElement = destinationRow;
-
-				for(int x = 0; x < destination.width && x < source.width; x++)
-				{
-					unsigned int argb = *(unsigned short*)sourceElement;
-
-					unsigned int a = ((argb & 0xF000) * 0x00011000) & 0xFF000000;
-					unsigned int r = ((argb & 0x0F00) * 0x00001100) & 0x00FF0000;
-					unsigned int g = ((argb & 0x00F0) * 0x00000110) & 0x0000FF00;
-					unsigned int b =  (argb & 0x000F) * 0x00000011;
-
-					*(unsigned int*)destinationElement = a | r | g | b;
-
-					sourceElement += source.bytes;
-					destinationElement += destination.bytes;
-				}
+				unpackA4R4G4B4(destinationRow, sourceRow, width);
 
 				sourceRow += source.pitchB;
 				destinationRow += destination.pitchB;
@@ -2103,6 +2092,21 @@ namespace sw
 	{
 		unsigned char *sourceSlice = (unsigned char*)source.buffer;
 		unsigned char *destinationSlice = (unsigned char*)destination.buffer;
+		int width = min(destination.width, source.width);
+
+		unsigned int argbPalette[256];
+
+		for(int i = 0; i < 256; i++)
+		{
+			unsigned int abgr = palette[i];
+
+			unsigned int r = (abgr & 0x000000FF) << 16;
+			unsigned int g = (abgr & 0x0000FF00) << 0;
+			unsigned int b = (abgr & 0x00FF0000) >> 16;
+			unsigned int a = (abgr & 0xFF000000) >> 0;
+
+			argbPalette[i] = a | r | g | b;
+		}
 
 		for(int z = 0; z < destination.depth && z < source.depth; z++)
 		{
@@ -2111,23 +2115,7 @@ namespace sw
 
 			for(int y = 0; y < destination.height && y < source.height; y++)
 			{
-				unsigned char *sourceElement = sourceRow;
-				unsigned char *destinationElement = destinationRow;
-
-				for(int x = 0; x < destination.width && x < source.width; x++)
-				{
-					unsigned int abgr = palette[*(unsigned char*)sourceElement];
-
-					unsigned int r = (abgr & 0x000000FF) << 16;
-					unsigned int g = (abgr & 0x0000FF00) << 0;
-					unsigned int b = (abgr & 0x00FF0000) >> 16;
-					unsigned int a = (abgr & 0xFF000000) >> 0;
-
-					*(unsigned int*)destinationElement = a | r | g | b;
-
-					sourceElement += source.bytes;
-					destinationElement += destination.bytes;
-				}
+				unpackP8(destinationRow, sourceRow, argbPalette, width);
 
 				sourceRow += source.pitchB;
 				destinationRow += destination.pitchB;
@@ -2453,23 +2441,92 @@ namespace sw
 		}
 	}
 
+	struct Surface::Band
+	{
+		BandDecoder decode;
+		Buffer internal;
+		Buffer external;
+		int parameter;
+		bool flag;
+	};
+
+	void Surface::decodeBands(BandDecoder decodeBand, Buffer &internal, const Buffer &external, int parameter, bool flag)
+	{
+		// Only split when each band has enough blocks to amortize handing it to a worker
+		const int blockRows = (external.height + 3) / 4;
+		const int blockColumns = (external.width + 3) / 4;
+		int bandCount = (decodeBandCount > 0) ? decodeBandCount : min(CPUID::processAffinity(), blockRows * blockColumns / 4096);
+		bandCount = min(bandCount, min(blockRows, (int)MAX_DECODE_BANDS));
+
+		if(bandCount <= 1)
+		{
+			decodeBand(internal, external, parameter, flag);
+			return;
+		}
+
+		Band band[MAX_DECODE_BANDS];
+
+		for(int i = 0; i < bandCount; i++)
+		{
+			int y0 = 4 * (blockRows * i / bandCount);
+			int y1 = 4 * (blockRows * (i + 1) / bandCount);
+
+			band[i].decode = decodeBand;
+			band[i].internal = internal;
+			band[i].internal.buffer = (byte*)internal.buffer + y0 * internal.pitchB;
+			band[i].internal.height = max(min(y1, internal.height) - y0, 0);
+			band[i].external = external;
+			band[i].external.buffer = (byte*)external.buffer + (y0 / 4) * external.pitchB;
+			band[i].external.height = min(y1, external.height) - y0;
+			band[i].parameter = parameter;
+			band[i].flag = flag;
+		}
+
+		// Shared by all uploads, so that its threads outlive each decode
+		static WorkerPool decodePool;
+
+		std::shared_ptr<Task> task[MAX_DECODE_BANDS];
+
+		for(int i = 1; i < bandCount; i++)
+		{
+			Band *b = &band[i];
+
+			task[i] = decodePool.enqueue([b]() { b->decode(b->internal, b->external, b->parameter, b->flag); });
+		}
+
+		decodeBand(band[0].internal, band[0].external, parameter, flag);
+
+		for(int i = 1; i < bandCount; i++)
+		{
+			task[i]->wait();
+		}
+	}
+
 	void Surface::decodeETC2(Buffer &internal, const Buffer &external, int nbAlphaBits, bool isSRGB)
+	{
+		decodeBands(decodeETC2Band, internal, external, nbAlphaBits, isSRGB);
+	}
+
+	void Surface::decodeETC2Band(Buffer &internal, const Buffer &external, int nbAlphaBits, bool isSRGB)
 	{
 		ETC_Decoder::Decode((const byte*)external.buffer, (byte*)internal.buffer, external.width, external.height, internal.width, internal.height, internal.pitchB, internal.bytes,
 		                    (nbAlphaBits == 8) ? ETC_Decoder::ETC_RGBA : ((nbAlphaBits == 1) ? ETC_Decoder::ETC_RGB_PUNCHTHROUGH_ALPHA : ETC_Decoder::ETC_RGB));
 
 		if(isSRGB)
 		{
-			static byte sRGBtoLinearTable[256];
-			static bool sRGBtoLinearTableDirty = true;
-			if(sRGBtoLinearTableDirty)
+			// Initialized once, even when bands get decoded concurrently
+			static const struct SRGBtoLinearTable
 			{
-				for(int i = 0; i < 256; i++)
+				SRGBtoLinearTable()
 				{
-					sRGBtoLinearTable[i] = static_cast<byte>(sRGBtoLinear(static_cast<float>(i) / 255.0f) * 255.0f + 0.5f);
+					for(int i = 0; i < 256; i++)
+					{
+						value[i] = static_cast<byte>(sRGBtoLinear(static_cast<float>(i) / 255.0f) * 255.0f + 0.5f);
+					}
 				}
-				sRGBtoLinearTableDirty = false;
-			}
+
+				byte value[256];
+			} sRGBtoLinearTable;
 
 			// Perform sRGB conversion in place after decoding
 			byte* src = (byte*)internal.buffer;
@@ -2481,7 +2538,7 @@ namespace sw
 					byte* srcPix = srcRow + x * internal.bytes;
 					for(int i = 0; i < 3; i++)
 					{
-						srcPix[i] = sRGBtoLinearTable[srcPix[i]];
+						srcPix[i] = sRGBtoLinearTable.value[srcPix[i]];
 					}
 				}
 			}
@@ -2489,6 +2546,11 @@ namespace sw
 	}
 
 	void Surface::decodeEAC(Buffer &internal, const Buffer &external, int nbChannels, bool isSigned)
+	{
+		decodeBands(decodeEACBand, internal, external, nbChannels, isSigned);
+	}
+
+	void Surface::decodeEACBand(Buffer &internal, const Buffer &external, int nbChannels, bool isSigned)
 	{
 		ASSERT(nbChannels == 1 || nbChannels == 2);
 
@@ -3107,6 +3169,21 @@ namespace sw
 		return 1;
 	}
 
+	int Surface::halfFloatChannels(Format half, Format single)
+	{
+		switch(half)
+		{
+		case FORMAT_R16F:          return (single == FORMAT_R32F) ? 1 : 0;
+		case FORMAT_A16F:          return (single == FORMAT_A32F) ? 1 : 0;
+		case FORMAT_L16F:          return (single == FORMAT_L32F) ? 1 : 0;
+		case FORMAT_G16R16F:       return (single == FORMAT_G32R32F) ? 2 : 0;
+		case FORMAT_A16L16F:       return (single == FORMAT_A32L32F) ? 2 : 0;
+		case FORMAT_B16G16R16F:    return (single == FORMAT_B32G32R32F) ? 3 : 0;
+		case FORMAT_A16B16G16R16F: return (single == FORMAT_A32B32G32R32F) ? 4 : 0;
+		default:                   return 0;
+		}
+	}
+
 	void *Surface::allocateBuffer(int width, int height, int depth, Format format)
 	{
 		// Render targets require 2x2 quads
@@ -3119,7 +3196,7 @@ namespace sw
 		return allocate(size(width2, height2, depth, format) + 4);
 	}
 
-	void Surface::memfill4(void *buffer, int pattern, int bytes)
+	void Surface::memfill4(void *buffer, int pattern, int bytes, bool streaming)
 	{
 		while((size_t)buffer & 0x1 && bytes >= 1)
 		{
@@ -3151,14 +3228,29 @@ namespace sw
 				int qxwords = bytes / 64;
 				bytes -= qxwords * 64;
 
-				while(qxwords--)
+				if(streaming)   // Don't evict the working set for data which won't be read soon
 				{
-					_mm_stream_ps(pointer + 0, quad);
-					_mm_stream_ps(pointer + 4, quad);
-					_mm_stream_ps(pointer + 8, quad);
-					_mm_stream_ps(pointer + 12, quad);
+					while(qxwords--)
+					{
+						_mm_stream_ps(pointer + 0, quad);
+						_mm_stream_ps(pointer + 4, quad);
+						_mm_stream_ps(pointer + 8, quad);
+						_mm_stream_ps(pointer + 12, quad);
 
-					pointer += 16;
+						pointer += 16;
+					}
+				}
+				else
+				{
+					while(qxwords--)
+					{
+						_mm_store_ps(pointer + 0, quad);
+						_mm_store_ps(pointer + 4, quad);
+						_mm_store_ps(pointer + 8, quad);
+						_mm_store_ps(pointer + 12, quad);
+
+						pointer += 16;
+					}
 				}
 
 				buffer = pointer;
@@ -3187,6 +3279,63 @@ namespace sw
 		}
 	}
 
+	bool Surface::isTileable() const
+	{
+		return internal.depth == 1 && internal.bytes > 0 &&
+		       !isCompressed(internal.format) && !hasQuadLayout(internal.format) &&
+		       internal.format != FORMAT_YV12_BT601 &&
+		       internal.format != FORMAT_YV12_BT709 &&
+		       internal.format != FORMAT_YV12_JFIF;
+	}
+
+	const void *Surface::getTiled()
+	{
+		ASSERT(isTileable());
+
+		if(!tiled.buffer)
+		{
+			tiled.buffer = allocate(tiled.sliceB + 4, 64);   // Tiles of 4-byte texels are whole cache lines
+		}
+
+		lockInternal(0, 0, 0, LOCK_UNLOCKED, PRIVATE);   // Applies external changes
+
+		if(tiled.dirty)
+		{
+			// Waits for draws which write the internal buffer, or read the tiled copy
+			const byte *source = (const byte*)lockInternal(0, 0, 0, LOCK_READONLY, PUBLIC);
+			int bytes = tiled.bytes;
+
+			// Each column of a 4x4 tile is four contiguous texels, so texel (x, y)
+			// is at (y & ~3) * pitchP + x * 4 + (y & 3).
+			for(int y = 0; y < internal.height; y++)
+			{
+				const byte *row = source + y * internal.pitchB;
+				byte *column = (byte*)tiled.buffer + ((y & ~3) * tiled.pitchP + (y & 3)) * bytes;
+
+				if(bytes == 4)
+				{
+					for(int x = 0; x < internal.width; x++)
+					{
+						((dword*)column)[x * 4] = ((const dword*)row)[x];
+					}
+				}
+				else
+				{
+					for(int x = 0; x < internal.width; x++)
+					{
+						memcpy(column + x * 4 * bytes, row + x * bytes, bytes);
+					}
+				}
+			}
+
+			unlockInternal();
+
+			tiled.dirty = false;
+		}
+
+		return tiled.buffer;
+	}
+
 	void Surface::sync()
 	{
 		resource->lock(EXCLUSIVE);
@@ -3232,16 +3381,19 @@ namespace sw
 		   internal.format == FORMAT_D32FS8_SHADOW)
 		{
 			float *target = (float*)lockInternal(0, 0, 0, lock, PUBLIC) + x0 + width2 * y0;
+			bool streaming = 4 * width * height * internal.depth >= NON_TEMPORAL_THRESHOLD;
 
 			for(int z = 0; z < internal.depth; z++)
 			{
 				for(int y = y0; y < y1; y++)
 				{
-					memfill4(target, (int&)depth, 4 * width);
+					memfill4(target, (int&)depth, 4 * width, streaming);
 					target += width2;
 				}
 			}
 
+			if(streaming) storeFence();
+
 			unlockInternal();
 		}
 		else   // Quad layout
@@ -3257,6 +3409,7 @@ namespace sw
 			int oddX1 = (x1 & ~1) * 2;
 			int evenX0 = ((x0 + 1) & ~1) * 2;
 			int evenBytes = (oddX1 - evenX0) * sizeof(float);
+			bool streaming = evenBytes * (height / 2) * internal.depth >= NON_TEMPORAL_THRESHOLD;
 
 			for(int z = 0; z < internal.depth; z++)
 			{
@@ -3302,7 +3455,7 @@ namespace sw
 					//	qEnd:
 					//	}
 
-						memfill4(&target[evenX0], (int&)depth, evenBytes);
+						memfill4(&target[evenX0], (int&)depth, evenBytes, streaming);
 
 						if((x1 & 1) != 0)
 						{
@@ -3324,8 +3477,28 @@ namespace sw
 				buffer += internal.sliceP;
 			}
 
+			if(streaming) storeFence();
+
 			unlockInternal();
 		}
+
+		if(hierarchicalDepth)   // Partially covered tiles were invalidated by the lock
+		{
+			const int W = HIERARCHICAL_DEPTH_TILE_WIDTH;
+			int tileX0 = (x0 + W - 1) / W;
+			int tileX1 = (x1 == internal.width) ? (x1 + W - 1) / W : x1 / W;
+			int tileY0 = (y0 + 1) / 2;
+			int tileY1 = (y1 == internal.height) ? (y1 + 1) / 2 : y1 / 2;
+			int pitch = getHierarchicalDepthPitchB() / sizeof(float);
+
+			for(int y = tileY0; y < tileY1; y++)
+			{
+				for(int x = tileX0; x < tileX1; x++)
+				{
+					hierarchicalDepth[y * pitch + x] = depth;
+				}
+			}
+		}
 	}
 
 	void Surface::clearStencil(unsigned char s, unsigned char mask, int x0, int y0, int width, int height)
@@ -3353,6 +3526,7 @@ namespace sw
 		int oddX1 = (x1 & ~1) * 2;
 		int evenX0 = ((x0 + 1) & ~1) * 2;
 		int evenBytes = oddX1 - evenX0;
+		bool streaming = evenBytes * (height / 2) * stencil.depth >= NON_TEMPORAL_THRESHOLD;
 
 		unsigned char maskedS = s & mask;
 		unsigned char invMask = ~mask;
@@ -3376,7 +3550,7 @@ namespace sw
 						target[oddX0 + 2] = fill;
 					}
 
-					memfill4(&target[evenX0], fill, evenBytes);
+					memfill4(&target[evenX0], fill, evenBytes, streaming);
 
 					if((x1 & 1) != 0)
 					{
@@ -3398,6 +3572,8 @@ namespace sw
 			buffer += stencil.sliceP;
 		}
 
+		if(streaming) storeFence();
+
 		unlockStencil();
 	}
 
@@ -3425,12 +3601,16 @@ namespace sw
 			if(buffer->bytes <= 1) c = (c << 8)  | c;
 			if(buffer->bytes <= 2) c = (c << 16) | c;
 
+			bool streaming = width * height * buffer->bytes >= NON_TEMPORAL_THRESHOLD;
+
 			for(int y = 0; y < height; y++)
 			{
-				memfill4(row, c, width * buffer->bytes);
+				memfill4(row, c, width * buffer->bytes, streaming);
 
 				row += buffer->pitchB;
 			}
+
+			if(streaming) storeFence();
 		}
 		else   // Generic
 		{
@@ -3775,6 +3955,40 @@ namespace sw
 		Surface::paletteID++;
 	}
 
+	void Surface::setDecodeBandCount(int count)
+	{
+		Surface::decodeBandCount = count;
+	}
+
+	bool Surface::hasHierarchicalDepth() const
+	{
+		return isDepth(internal.format) && internal.depth == 1;
+	}
+
+	float *Surface::getHierarchicalDepth()
+	{
+		if(!hierarchicalDepth && hasHierarchicalDepth())
+		{
+			hierarchicalDepth = (float*)allocate(getHierarchicalDepthPitchB() * ((internal.height + 1) / 2));
+			invalidateHierarchicalDepth();
+		}
+
+		return hierarchicalDepth;
+	}
+
+	void Surface::invalidateHierarchicalDepth()
+	{
+		if(hierarchicalDepth)
+		{
+			int tiles = getHierarchicalDepthPitchB() / sizeof(float) * ((internal.height + 1) / 2);
+
+			for(int i = 0; i < tiles; i++)
+			{
+				hierarchicalDepth[i] = FLT_MAX;
+			}
+		}
+	}
+
 	void Surface::resolve()
 	{
 		if(internal.depth <= 1 || !internal.dirty || !renderTarget || internal.format == FORMAT_NULL)
@@ -293,12 +293,23 @@ namespace sw
 		inline int getStencilPitchB() const;
 		inline int getStencilSliceB() const;
 
+		// Copy of the internal buffer stored in 4x4 texel tiles, for sampling. It is updated
+		// when the internal buffer changed, after the renderer finished accessing it.
+		bool isTileable() const;
+		const void *getTiled();
+		inline int getTiledPitchP() const;
+		inline int getTiledSliceP() const;
+
 		void sync();                      // Wait for lock(s) to be released.
 		inline bool isUnlocked() const;   // Only reliable after sync().
 
 		inline int getMultiSampleCount() const;
 		inline int getSuperSampleCount() const;
 
+		bool hasHierarchicalDepth() const;
+		float *getHierarchicalDepth();   // Upper bound of the depth values of each tile, or null when not available
+		inline int getHierarchicalDepthPitchB() const;
+
 		bool isEntire(const Rect& rect) const;
 		Rect getRect() const;
 		void clearDepth(float depth, int x0, int y0, int width, int height);
@@ -347,8 +358,15 @@ namespace sw
 		static bool isNonNormalizedInteger(Format format);
 		static bool isNormalizedInteger(Format format);
 		static int componentCount(Format format);
+		static int halfFloatChannels(Format half, Format single);   // Channel count if the formats only differ in float precision, otherwise 0
 
 		static void setTexturePalette(unsigned int *palette);
+		static void setDecodeBandCount(int count);   // Forces the number of bands ETC2 and EAC images get decoded in, or 0 to pick by size
+
+		// Fills with a repeated 32-bit pattern. Streaming stores bypass the caches, for large
+		// regions which won't be read again before they'd be evicted anyway, and must be
+		// followed by a storeFence() before the memory is handed to other threads.
+		static void memfill4(void *buffer, int pattern, int bytes, bool streaming = false);
 
 	private:
 		sw::Resource *resource;
@@ -451,19 +469,30 @@ namespace sw
 		static void decodeETC2(Buffer &internal, const Buffer &external, int nbAlphaBits, bool isSRGB);
 		static void decodeASTC(Buffer &internal, const Buffer &external, int xSize, int ySize, int zSize, bool isSRGB);
 
+		// Large images get split into bands of block rows, decoded on separate threads
+		enum {MAX_DECODE_BANDS = 16};
+		struct Band;
+		typedef void (*BandDecoder)(Buffer &internal, const Buffer &external, int parameter, bool flag);
+		static void decodeBands(BandDecoder decodeBand, Buffer &internal, const Buffer &external, int parameter, bool flag);
+		static void decodeEACBand(Buffer &internal, const Buffer &external, int nbChannels, bool isSigned);
+		static void decodeETC2Band(Buffer &internal, const Buffer &external, int nbAlphaBits, bool isSRGB);
+
 		static void update(Buffer &destination, Buffer &source);
 		static void genericUpdate(Buffer &destination, Buffer &source);
 		static void *allocateBuffer(int width, int height, int depth, Format format);
-		static void memfill4(void *buffer, int pattern, int bytes);
 
 		bool identicalFormats() const;
 		Format selectInternalFormat(Format format) const;
 
 		void resolve();
+		void invalidateHierarchicalDepth();
 
 		Buffer external;
 		Buffer internal;
 		Buffer stencil;
+		Buffer tiled;
+
+		float *hierarchicalDepth;   // One float per HIERARCHICAL_DEPTH_TILE_WIDTH x 2 tile
 
 		const bool lockable;
 		const bool renderTarget;
@@ -473,6 +502,7 @@ namespace sw
 
 		static unsigned int *palette;   // FIXME: Not multi-device safe
 		static unsigned int paletteID;
+		static int decodeBandCount;
 
 		bool hasParent;
 		bool ownExternal;
@@ -584,6 +614,16 @@ namespace sw
 		return internal.sliceP;
 	}
 
+	int Surface::getTiledPitchP() const
+	{
+		return tiled.pitchP;
+	}
+
+	int Surface::getTiledSliceP() const
+	{
+		return tiled.sliceP;
+	}
+
 	Format Surface::getStencilFormat() const
 	{
 		return stencil.format;
@@ -609,6 +649,11 @@ namespace sw
 		return internal.depth > 4 ? internal.depth / 4 : 1;
 	}
 
+	int Surface::getHierarchicalDepthPitchB() const
+	{
+		return (internal.width + HIERARCHICAL_DEPTH_TILE_WIDTH - 1) / HIERARCHICAL_DEPTH_TILE_WIDTH * sizeof(float);
+	}
+
 	bool Surface::isUnlocked() const
 	{
 		return external.lock == LOCK_UNLOCKED &&
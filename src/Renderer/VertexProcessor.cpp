@@ -20,6 +20,7 @@
 #include "VertexShader.hpp"
 #include "PixelShader.hpp"
 #include "Constants.hpp"
+#include "Memory.hpp"
 #include "Debug.hpp"
 
 #include <string.h>
@@ -28,11 +29,151 @@ namespace sw
 {
 	bool precacheVertex = false;
 
+	void VertexCache::initialize(int size)
+	{
+		int sets = max(size / VERTEX_CACHE_WAYS, 1);
+
+		vertex = (Vertex*)allocate(sets * VERTEX_CACHE_WAYS * sizeof(Vertex));
+		tag = (unsigned int*)allocate(sets * VERTEX_CACHE_WAYS * sizeof(unsigned int));
+		next = (unsigned int*)allocate(sets * sizeof(unsigned int));
+		slot = (unsigned int*)allocate(sets * VERTEX_CACHE_WAYS * sizeof(unsigned int));
+		entry = (unsigned int*)allocate(MAX_BATCH_SIZE * 3 * sizeof(unsigned int));
+		setMask = sets - 1;
+
+		clear();
+	}
+
+	void VertexCache::release()
+	{
+		deallocate(vertex);
+		deallocate(tag);
+		deallocate(next);
+		deallocate(slot);
+		deallocate(entry);
+	}
+
 	void VertexCache::clear()
 	{
-		for(int i = 0; i < 16; i++)
+		for(unsigned int i = 0; i < (setMask + 1) * VERTEX_CACHE_WAYS; i++)
 		{
 			tag[i] = 0x80000000;
+			slot[i] = 0xFFFFFFFF;
+		}
+
+		for(unsigned int i = 0; i <= setMask; i++)
+		{
+			next[i] = 0;
+		}
+	}
+
+	void VertexTask::assignVertices(unsigned int *batch, bool indexed)
+	{
+		VertexCache &cache = vertexCache;
+		unsigned int vertexSlots = 0;   // Vertices written to the batch
+		unsigned int base = batch[0];
+
+		shadeCount = 0;
+		copyCount = 0;
+		fillCount = 0;
+
+		for(unsigned int i = 0; i < vertexCount; i++)
+		{
+			unsigned int index = batch[i];
+			unsigned int offset = index - base;
+			bool near = offset < MAX_BATCH_SIZE * 3;
+			unsigned int slot;
+
+			if(near)
+			{
+				slot = offsetSlot[offset];
+
+				if(slot < vertexSlots && slotIndex[slot] == index)   // Already in this batch
+				{
+					batch[i] = slot;
+
+					continue;
+				}
+
+				if(!indexed)
+				{
+					slot = vertexSlots++;
+					offsetSlot[offset] = slot;
+					slotIndex[slot] = index;
+
+					shadeIndex[shadeCount] = index;
+					shadeSlot[shadeCount] = slot;
+					shadeCount++;
+
+					batch[i] = slot;
+
+					continue;
+				}
+			}
+
+			unsigned int set = index & cache.setMask;
+			unsigned int *tags = &cache.tag[set * VERTEX_CACHE_WAYS];
+			unsigned int way = VERTEX_CACHE_WAYS;
+
+			for(unsigned int w = 0; w < VERTEX_CACHE_WAYS; w++)
+			{
+				if(tags[w] == index)
+				{
+					way = w;
+				}
+			}
+
+			if(way == VERTEX_CACHE_WAYS)   // Miss, replace entries round-robin
+			{
+				way = cache.next[set];
+				cache.next[set] = (way + 1) & (VERTEX_CACHE_WAYS - 1);
+				tags[way] = index;
+
+				unsigned int cacheIndex = set * VERTEX_CACHE_WAYS + way;
+				slot = vertexSlots++;
+
+				shadeIndex[shadeCount] = index;
+				shadeSlot[shadeCount] = slot;
+				shadeCount++;
+
+				fillSlot[fillCount] = slot;
+				fillEntry[fillCount] = cacheIndex;
+				fillCount++;
+
+				cache.slot[cacheIndex] = slot;
+				cache.entry[slot] = cacheIndex;
+				slotIndex[slot] = index;
+			}
+			else
+			{
+				unsigned int cacheIndex = set * VERTEX_CACHE_WAYS + way;
+				slot = cache.slot[cacheIndex];
+
+				if(slot >= vertexSlots || cache.entry[slot] != cacheIndex)   // Not in this batch yet
+				{
+					slot = vertexSlots++;
+
+					copySlot[copyCount] = slot;
+					copyEntry[copyCount] = cacheIndex;
+					copyCount++;
+
+					cache.slot[cacheIndex] = slot;
+					cache.entry[slot] = cacheIndex;
+					slotIndex[slot] = index;
+				}
+			}
+
+			if(near)
+			{
+				offsetSlot[offset] = slot;
+			}
+
+			batch[i] = slot;
+		}
+
+		for(unsigned int i = shadeCount; i % 4 != 0; i++)
+		{
+			shadeIndex[i] = shadeIndex[i - 1];
+			shadeSlot[i] = shadeSlot[i - 1];
 		}
 	}
 
@@ -921,6 +1062,11 @@ namespace sw
 		state.positionRegister = context->vertexShader ? context->vertexShader->getPositionRegister() : Pos;
 		state.pointSizeRegister = context->vertexShader ? context->vertexShader->getPointSizeRegister() : Pts;
 
+		if(uniformSpecialization && context->vertexShader)
+		{
+			state.specialized = specialization.specialize(context->vertexShader, c, VERTEX_UNIFORM_VECTORS, i, b, state.branchConstant);
+		}
+
 		state.vertexBlendMatrixCount = context->vertexBlendMatrixCountActive();
 		state.indexedVertexBlendEnable = context->indexedVertexBlendActive();
 		state.vertexNormalActive = context->vertexNormalActive();
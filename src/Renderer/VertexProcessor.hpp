@@ -18,27 +18,66 @@
 #include "Matrix.hpp"
 #include "Context.hpp"
 #include "RoutineCache.hpp"
+#include "ShaderSpecialization.hpp"
 #include "Shader/VertexShader.hpp"
 
 namespace sw
 {
 	struct DrawData;
 
-	struct VertexCache   // FIXME: Variable size
+	// Set-associative cache of transformed vertices, which keeps them across batches.
+	// Each set holds VERTEX_CACHE_WAYS vertices.
+	struct VertexCache
 	{
+		void initialize(int size);   // Number of vertices, a power of two
+		void release();
 		void clear();
 
-		Vertex vertex[16][4];
-		unsigned int tag[16];
+		Vertex *vertex;        // [sets][VERTEX_CACHE_WAYS]
+		unsigned int *tag;     // [sets][VERTEX_CACHE_WAYS] Index of the vertex
+		unsigned int *next;    // [sets] Way to be replaced next
+		unsigned int setMask;
+
+		// Each transformed vertex is written to a batch only once. These map between the cache
+		// entries and the vertices of the current batch, in both directions, so a mapping is
+		// valid only when it's mutual and doesn't need to be cleared between batches.
+		unsigned int *slot;    // [sets][VERTEX_CACHE_WAYS] Batch vertex holding the entry
+		unsigned int *entry;   // [MAX_BATCH_SIZE * 3] Cache entry held by the batch vertex
 
 		int drawCall;
 	};
 
 	struct VertexTask
 	{
+		// Replaces the batch's vertex indices with the batch vertices holding them, and lists
+		// which of those have to be shaded and which can be copied from the vertex cache.
+		void assignVertices(unsigned int *batch, bool indexed);
+
 		unsigned int vertexCount;
 		unsigned int primitiveStart;
+		unsigned int vertexLanes;   // Only written when profiling
 		VertexCache vertexCache;
+
+		// Vertices to shade, four at a time. The last group is padded by repeating its last vertex.
+		unsigned int shadeCount;
+		unsigned int shadeIndex[MAX_BATCH_SIZE * 3 + 3];
+		unsigned int shadeSlot[MAX_BATCH_SIZE * 3 + 3];
+
+		// Cache hits, copied to the batch before the shaded vertices replace cache entries
+		unsigned int copyCount;
+		unsigned int copySlot[MAX_BATCH_SIZE * 3];
+		unsigned int copyEntry[MAX_BATCH_SIZE * 3];
+
+		// Shaded vertices to keep in the cache for the next batches
+		unsigned int fillCount;
+		unsigned int fillSlot[MAX_BATCH_SIZE * 3];
+		unsigned int fillEntry[MAX_BATCH_SIZE * 3];
+
+		// Non-indexed draws only share vertices within a batch, except for the first vertex of
+		// fans and loops, so they're found by their offset from the batch's first index instead
+		// of through the cache. Like the cache's mapping, it's valid only when it's mutual.
+		unsigned int offsetSlot[MAX_BATCH_SIZE * 3];   // Batch vertex holding the index at the offset
+		unsigned int slotIndex[MAX_BATCH_SIZE * 3];    // Index held by the batch vertex
 	};
 
 	class VertexProcessor
@@ -52,6 +91,7 @@ namespace sw
 
 			bool fixedFunction             : 1;
 			bool textureSampling           : 1;
+			bool specialized               : 1;   // Branch constants are compiled in
 			unsigned int positionRegister  : BITS(MAX_VERTEX_OUTPUTS);
 			unsigned int pointSizeRegister : BITS(MAX_VERTEX_OUTPUTS);
 
@@ -137,6 +177,8 @@ namespace sw
 
 			Input input[MAX_VERTEX_INPUTS];
 			Output output[MAX_VERTEX_OUTPUTS];
+
+			int branchConstant[Shader::MAX_BRANCH_CONSTANTS];
 		};
 
 		struct State : States
@@ -327,6 +369,7 @@ namespace sw
 		Context *const context;
 
 		RoutineCache<State> *routineCache;
+		ShaderSpecialization specialization;
 
 	protected:
 		Matrix M[12];      // Model/Geometry/World matrix
@@ -1042,6 +1042,42 @@ namespace sw
 		return 0;
 	}
 
+	bool PixelProgram::specializedConstant(const Src &src, unsigned int component, int &value) const
+	{
+		if(!state.specialized)
+		{
+			return false;
+		}
+
+		int index = shader->findBranchConstant(src, component);
+
+		if(index == -1)
+		{
+			return false;
+		}
+
+		value = state.branchConstant[index];
+
+		if(src.modifier == Shader::MODIFIER_NOT)
+		{
+			value = (src.type == Shader::PARAMETER_CONSTBOOL) ? !value : ~value;
+		}
+
+		return true;
+	}
+
+	Int PixelProgram::integerConstant(const Src &integerRegister, unsigned int component)
+	{
+		int value;
+
+		if(specializedConstant(integerRegister, component, value))
+		{
+			return Int(value);
+		}
+
+		return *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][component]));
+	}
+
 	Float4 PixelProgram::linearToSRGB(const Float4 &x)   // Approximates x^(1.0/2.2)
 	{
 		Float4 sqrtx = Rcp_pp(RcpSqrt_pp(x));
@@ -1352,6 +1388,23 @@ namespace sw
 
 	void PixelProgram::CALLNZb(int labelIndex, int callSiteIndex, const Src &boolRegister)
 	{
+		int value;
+
+		if(specializedConstant(boolRegister, 0, value))
+		{
+			if(value != 0)
+			{
+				CALL(labelIndex, callSiteIndex);
+			}
+			else
+			{
+				Nucleus::createBr(callRetBlock[labelIndex][callSiteIndex]);
+				Nucleus::setInsertBlock(callRetBlock[labelIndex][callSiteIndex]);
+			}
+
+			return;
+		}
+
 		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData, ps.b[boolRegister.index])) != Byte(0));   // FIXME
 
 		if(boolRegister.modifier == Shader::MODIFIER_NOT)
@@ -1523,8 +1576,17 @@ namespace sw
 		}
 		else
 		{
-			Int4 condition = As<Int4>(fetchRegister(src).x);
-			IF(condition);
+			int value;
+
+			if(specializedConstant(src, src.swizzle & 0x3, value) && (value == 0 || value == -1))
+			{
+				IF(value != 0);
+			}
+			else
+			{
+				Int4 condition = As<Int4>(fetchRegister(src).x);
+				IF(condition);
+			}
 		}
 	}
 
@@ -1532,6 +1594,14 @@ namespace sw
 	{
 		ASSERT(ifDepth < 24 + 4);
 
+		int value;
+
+		if(specializedConstant(boolRegister, 0, value))
+		{
+			IF(value != 0);
+			return;
+		}
+
 		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData, ps.b[boolRegister.index])) != Byte(0));   // FIXME
 
 		if(boolRegister.modifier == Shader::MODIFIER_NOT)
@@ -1602,6 +1672,23 @@ namespace sw
 		breakDepth++;
 	}
 
+	void PixelProgram::IF(bool condition)
+	{
+		ASSERT(ifDepth < 24 + 4);
+
+		BasicBlock *trueBlock = Nucleus::createBasicBlock();
+		BasicBlock *falseBlock = Nucleus::createBasicBlock();
+
+		// The other block is unreachable, so no code gets generated for it
+		Nucleus::createBr(condition ? trueBlock : falseBlock);
+		Nucleus::setInsertBlock(trueBlock);
+
+		isConditionalIf[ifDepth] = false;
+		ifFalseBlock[ifDepth] = falseBlock;
+
+		ifDepth++;
+	}
+
 	void PixelProgram::LABEL(int labelIndex)
 	{
 		if(!labelBlock[labelIndex])
@@ -1617,9 +1704,9 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][0]));
-		aL[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][1]));
-		increment[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][2]));
+		iteration[loopDepth] = integerConstant(integerRegister, 0);
+		aL[loopDepth] = integerConstant(integerRegister, 1);
+		increment[loopDepth] = integerConstant(integerRegister, 2);
 
 		//	If(increment[loopDepth] == 0)
 		//	{
@@ -1650,7 +1737,7 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData, ps.i[integerRegister.index][0]));
+		iteration[loopDepth] = integerConstant(integerRegister, 0);
 		aL[loopDepth] = aL[loopDepth - 1];
 
 		BasicBlock *loopBlock = Nucleus::createBasicBlock();
@@ -27,7 +27,7 @@ namespace sw
 			PixelRoutine(state, shader), r(shader && shader->dynamicallyIndexedTemporaries),
 			loopDepth(-1), ifDepth(0), loopRepDepth(0), breakDepth(0), currentLabel(-1), whileTest(false)
 		{
-			for(int i = 0; i < 2048; ++i)
+			for(int i = 0; i < Shader::MAX_LABELS; ++i)
 			{
 				labelBlock[i] = 0;
 			}
@@ -55,7 +55,7 @@ namespace sw
 
 	private:
 		// Temporary registers
-		RegisterArray<4096> r;
+		RegisterArray<Shader::MAX_TEMPORARY_REGISTERS> r;
 
 		// Color outputs
 		Vector4f c[RENDERTARGETS];
@@ -95,6 +95,8 @@ namespace sw
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index);
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index, Int& offset);
 		Int relativeAddress(const Shader::Parameter &var, int bufferIndex = -1);
+		bool specializedConstant(const Src &src, unsigned int component, int &value) const;
+		Int integerConstant(const Src &integerRegister, unsigned int component);
 
 		Float4 linearToSRGB(const Float4 &x);
 
@@ -142,6 +144,7 @@ namespace sw
 		void IFp(const Src &predicateRegister);
 		void IFC(Vector4f &src0, Vector4f &src1, Control);
 		void IF(Int4 &condition);
+		void IF(bool condition);   // Static branch on a specialized constant
 		void LABEL(int labelIndex);
 		void LOOP(const Src &integerRegister);
 		void REP(const Src &integerRegister);
@@ -159,8 +162,8 @@ namespace sw
 		BasicBlock *ifFalseBlock[24 + 24];
 		BasicBlock *loopRepTestBlock[4];
 		BasicBlock *loopRepEndBlock[4];
-		BasicBlock *labelBlock[2048];
-		std::vector<BasicBlock*> callRetBlock[2048];
+		BasicBlock *labelBlock[Shader::MAX_LABELS];
+		std::vector<BasicBlock*> callRetBlock[Shader::MAX_LABELS];
 		BasicBlock *returnBlock;
 		bool isConditionalIf[24 + 24];
 	};
@@ -15,6 +15,7 @@
 #include "PixelShader.hpp"
 
 #include "Debug.hpp"
+#include "Serialization.hpp"
 
 #include <string.h>
 
@@ -22,6 +23,7 @@ namespace sw
 {
 	PixelShader::PixelShader(const PixelShader *ps) : Shader()
 	{
+		shaderType = SHADER_PIXEL;
 		version = 0x0300;
 		vPosDeclared = false;
 		vFaceDeclared = false;
@@ -60,6 +62,35 @@ namespace sw
 	{
 	}
 
+	void PixelShader::serialize(Serializer &stream) const
+	{
+		Shader::serialize(stream);
+
+		stream.write(input);
+		stream.write(vPosDeclared);
+		stream.write(vFaceDeclared);
+		stream.write(zOverride);
+		stream.write(kill);
+		stream.write(centroid);
+	}
+
+	bool PixelShader::deserialize(Deserializer &stream)
+	{
+		if(!Shader::deserialize(stream))
+		{
+			return false;
+		}
+
+		stream.read(input);
+		stream.read(vPosDeclared);
+		stream.read(vFaceDeclared);
+		stream.read(zOverride);
+		stream.read(kill);
+		stream.read(centroid);
+
+		return !stream.failed() && shaderType == SHADER_PIXEL;
+	}
+
 	int PixelShader::validate(const unsigned long *const token)
 	{
 		if(!token)
@@ -158,6 +189,7 @@ namespace sw
 		analyzeInterpolants();
 		analyzeDirtyConstants();
 		analyzeDynamicBranching();
+		analyzeBranchConstants();
 		analyzeSamplers();
 		analyzeCallSites();
 		analyzeDynamicIndexing();
@@ -28,6 +28,9 @@ namespace sw
 
 		virtual ~PixelShader();
 
+		void serialize(Serializer &stream) const override;
+		bool deserialize(Deserializer &stream) override;
+
 		static int validate(const unsigned long *const token);   // Returns number of instructions if valid
 		bool depthOverride() const;
 		bool containsKill() const;
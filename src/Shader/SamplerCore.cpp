@@ -1260,7 +1260,8 @@ namespace sw
 		address(u, x0, x1, fu, mipmap, offset.x, filter, OFFSET(Mipmap, width), state.addressingModeU, function);
 
 		Int4 pitchP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, pitchP), 16);
-		y0 *= pitchP;
+		x0 = columnOffset(x0);
+		y0 = rowOffset(y0, pitchP);
 		if(hasThirdCoordinate())
 		{
 			Int4 sliceP = *Pointer<Int4>(mipmap + OFFSET(Mipmap, sliceP), 16);
@@ -1273,7 +1274,8 @@ namespace sw
 		}
 		else
 		{
-			y1 *= pitchP;
+			x1 = columnOffset(x1);
+			y1 = rowOffset(y1, pitchP);
 
 			Vector4f c0 = sampleTexel(x0, y0, z0, w, mipmap, buffer, function);
 			Vector4f c1 = sampleTexel(x1, y0, z0, w, mipmap, buffer, function);
@@ -1676,6 +1678,13 @@ namespace sw
 			vvvv = applyOffset(vvvv, offset.y, Int4(*Pointer<UShort4>(mipmap + OFFSET(Mipmap, height))), texelFetch ? ADDRESSING_TEXELFETCH : state.addressingModeV);
 		}
 
+		if(state.tiledLayout)
+		{
+			// Columns of 4x4 tiles are four texels, and rows of tiles are four rows of the pitch
+			uuuu = (uuuu << 2) | (vvvv & Short4(3));
+			vvvv = vvvv & Short4(~3);
+		}
+
 		Short4 uuu2 = uuuu;
 		uuuu = As<Short4>(UnpackLow(uuuu, vvvv));
 		uuu2 = As<Short4>(UnpackHigh(uuu2, vvvv));
@@ -1726,6 +1735,26 @@ namespace sw
 		}
 	}
 
+	Int4 SamplerCore::columnOffset(const Int4 &x)
+	{
+		if(state.tiledLayout)
+		{
+			return x << 2;
+		}
+
+		return x;
+	}
+
+	Int4 SamplerCore::rowOffset(const Int4 &y, const Int4 &pitchP)
+	{
+		if(state.tiledLayout)
+		{
+			return (y & Int4(~3)) * pitchP + (y & Int4(3));
+		}
+
+		return y * pitchP;
+	}
+
 	void SamplerCore::computeIndices(UInt index[4], Int4& uuuu, Int4& vvvv, Int4& wwww, const Pointer<Byte> &mipmap, SamplerFunction function)
 	{
 		UInt4 indices = uuuu + vvvv;
@@ -37,14 +37,13 @@ namespace sw
 
 	void SetupRoutine::generate()
 	{
-		Function<Bool(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Pointer<Byte>)> function;
+		Function<Bool(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Pointer<Byte>)> function;
 		{
 			Pointer<Byte> primitive(function.Arg<0>());
 			Pointer<Byte> tri(function.Arg<1>());
-			Pointer<Byte> polygon(function.Arg<2>());
-			Pointer<Byte> data(function.Arg<3>());
-
-			Pointer<Byte> constants = *Pointer<Pointer<Byte> >(data + OFFSET(DrawData,constants));
+			Pointer<Byte> vertex(function.Arg<2>());
+			Pointer<Byte> polygon(function.Arg<3>());
+			Pointer<Byte> data(function.Arg<4>());
 
 			const bool point = state.isDrawPoint;
 			const bool sprite = state.pointSprite;
@@ -58,9 +57,9 @@ namespace sw
 
 			int pos = state.positionRegister;
 
-			Pointer<Byte> v0 = tri + V0;
-			Pointer<Byte> v1 = tri + V1;
-			Pointer<Byte> v2 = tri + V2;
+			Pointer<Byte> v0 = vertex + *Pointer<UInt>(tri + V0) * UInt((int)sizeof(Vertex));
+			Pointer<Byte> v1 = vertex + *Pointer<UInt>(tri + V1) * UInt((int)sizeof(Vertex));
+			Pointer<Byte> v2 = vertex + *Pointer<UInt>(tri + V2) * UInt((int)sizeof(Vertex));
 
 			Array<Int> X(16);
 			Array<Int> Y(16);
@@ -197,81 +196,52 @@ namespace sw
 			yMin = Max(yMin, *Pointer<Int>(data + OFFSET(DrawData,scissorY0)));
 			yMax = Min(yMax, *Pointer<Int>(data + OFFSET(DrawData,scissorY1)));
 
-			For(Int q = 0, q < state.multiSample, q++)
+			If(yMin >= yMax)   // Outside of the scissor rectangle (e.g. in the guard band)
 			{
-				Array<Int> Xq(16);
-				Array<Int> Yq(16);
-
-				Int i = 0;
-
-				Do
-				{
-					Xq[i] = X[i];
-					Yq[i] = Y[i];
-
-					if(state.multiSample > 1)
-					{
-						Xq[i] = Xq[i] + *Pointer<Int>(constants + OFFSET(Constants,Xf) + q * sizeof(int));
-						Yq[i] = Yq[i] + *Pointer<Int>(constants + OFFSET(Constants,Yf) + q * sizeof(int));
-					}
-
-					i++;
-				}
-				Until(i >= n)
+				Return(false);
+			}
 
-				Pointer<Byte> leftEdge = Pointer<Byte>(primitive + OFFSET(Primitive,outline->left)) + q * sizeof(Primitive);
-				Pointer<Byte> rightEdge = Pointer<Byte>(primitive + OFFSET(Primitive,outline->right)) + q * sizeof(Primitive);
+			// Edges, oriented so that those going down bound the spans on the left
+			X[n] = X[0];
+			Y[n] = Y[0];
 
-				if(state.multiSample > 1)
-				{
-					Short x = Short((X[0] + 0xF) >> 4);
+			Pointer<Byte> edge = primitive + OFFSET(Primitive,edge);
+			Int edgeCount = 0;
 
-					For(Int y = yMin - 1, y < yMax + 1, y++)
-					{
-						*Pointer<Short>(leftEdge + y * sizeof(Primitive::Span)) = x;
-						*Pointer<Short>(rightEdge + y * sizeof(Primitive::Span)) = x;
-					}
-				}
+			i = 0;
 
-				Xq[n] = Xq[0];
-				Yq[n] = Yq[0];
+			Do
+			{
+				Int Xa = X[i + 1 - d];
+				Int Ya = Y[i + 1 - d];
+				Int Xb = X[i + d];
+				Int Yb = Y[i + d];
 
-				// Rasterize
+				If(Ya != Yb)   // Horizontal edges coincide with yMin or yMax
 				{
-					Int i = 0;
-
-					Do
-					{
-						edge(primitive, data, Xq[i + 1 - d], Yq[i + 1 - d], Xq[i + d], Yq[i + d], q);
-
-						i++;
-					}
-					Until(i >= n)
+					Bool swap = Yb < Ya;
+
+					Int X1 = IfThenElse(swap, Xb, Xa);
+					Int Y1 = IfThenElse(swap, Yb, Ya);
+					Int DX = IfThenElse(swap, Xa, Xb) - X1;
+					Int DY = IfThenElse(swap, Ya, Yb) - Y1;
+
+					*Pointer<Int>(edge + OFFSET(Primitive::Edge,X)) = X1;
+					*Pointer<Int>(edge + OFFSET(Primitive::Edge,Y)) = Y1;
+					*Pointer<Int>(edge + OFFSET(Primitive::Edge,DX)) = DX;
+					*Pointer<Int>(edge + OFFSET(Primitive::Edge,DY)) = DY;
+					*Pointer<Float>(edge + OFFSET(Primitive::Edge,rcpFDY)) = 1.0f / Float(DY << 4);
+					*Pointer<Int>(edge + OFFSET(Primitive::Edge,right)) = IfThenElse(swap, Int(-1), Int(0));
+
+					edge += sizeof(Primitive::Edge);
+					edgeCount++;
 				}
 
-				if(state.multiSample == 1)
-				{
-					For(, yMin < yMax && *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + yMin * sizeof(Primitive::Span)), yMin++)
-					{
-						// Increments yMin
-					}
-
-					For(, yMax > yMin && *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span)) == *Pointer<Short>(rightEdge + (yMax - 1) * sizeof(Primitive::Span)), yMax--)
-					{
-						// Decrements yMax
-					}
-
-					If(yMin == yMax)
-					{
-						Return(false);
-					}
-
-					*Pointer<Short>(leftEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
-					*Pointer<Short>(rightEdge + (yMin - 1) * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + yMin * sizeof(Primitive::Span));
-					*Pointer<Short>(leftEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
-					*Pointer<Short>(rightEdge + yMax * sizeof(Primitive::Span)) = *Pointer<Short>(leftEdge + (yMax - 1) * sizeof(Primitive::Span));
-				}
+				i++;
 			}
+			Until(i >= n)
+
+			*Pointer<Int>(primitive + OFFSET(Primitive,edgeCount)) = edgeCount;
 
 			*Pointer<Int>(primitive + OFFSET(Primitive,yMin)) = yMin;
 			*Pointer<Int>(primitive + OFFSET(Primitive,yMax)) = yMax;
@@ -451,6 +421,10 @@ namespace sw
 				*Pointer<Float4>(primitive + OFFSET(Primitive,z.C), 16) = C;
 			}
 
+			// Provides the flat shaded attributes
+			int leading = leadingVertexFirst ? OFFSET(Triangle,v0) : OFFSET(Triangle,v2);
+			Pointer<Byte> leadingVertex = vertex + *Pointer<UInt>(tri + leading) * UInt((int)sizeof(Vertex));
+
 			for(int interpolant = 0; interpolant < MAX_FRAGMENT_INPUTS; interpolant++)
 			{
 				for(int component = 0; component < 4; component++)
@@ -461,14 +435,14 @@ namespace sw
 
 					if(attribute != Unused)
 					{
-						setupGradient(primitive, tri, w012, M, v0, v1, v2, OFFSET(Vertex,v[attribute][component]), OFFSET(Primitive,V[interpolant][component]), flat, sprite, state.perspective, wrap, component);
+						setupGradient(primitive, leadingVertex, w012, M, v0, v1, v2, OFFSET(Vertex,v[attribute][component]), OFFSET(Primitive,V[interpolant][component]), flat, sprite, state.perspective, wrap, component);
 					}
 				}
 			}
 
 			if(state.fog.attribute == Fog)
 			{
-				setupGradient(primitive, tri, w012, M, v0, v1, v2, OFFSET(Vertex,f), OFFSET(Primitive,f), state.fog.flat, false, state.perspective, false, 0);
+				setupGradient(primitive, leadingVertex, w012, M, v0, v1, v2, OFFSET(Vertex,f), OFFSET(Primitive,f), state.fog.flat, false, state.perspective, false, 0);
 			}
 
 			Return(true);
@@ -477,7 +451,7 @@ namespace sw
 		routine = function(L"SetupRoutine");
 	}
 
-	void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &triangle, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool sprite, bool perspective, bool wrap, int component)
+	void SetupRoutine::setupGradient(Pointer<Byte> &primitive, Pointer<Byte> &leadingVertex, Float4 &w012, Float4 (&m)[3], Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2, int attribute, int planeEquation, bool flat, bool sprite, bool perspective, bool wrap, int component)
 	{
 		Float4 i;
 
@@ -546,8 +520,7 @@ namespace sw
 		}
 		else
 		{
-			int leadingVertex = leadingVertexFirst ? OFFSET(Triangle,v0) : OFFSET(Triangle,v2);
-			Float C = *Pointer<Float>(triangle + leadingVertex + attribute);
+			Float C = *Pointer<Float>(leadingVertex + attribute);
 
 			*Pointer<Float4>(primitive + planeEquation + 0, 16) = Float4(0, 0, 0, 0);
 			*Pointer<Float4>(primitive + planeEquation + 16, 16) = Float4(0, 0, 0, 0);
@@ -555,71 +528,6 @@ namespace sw
 		}
 	}
 
-	void SetupRoutine::edge(Pointer<Byte> &primitive, Pointer<Byte> &data, const Int &Xa, const Int &Ya, const Int &Xb, const Int &Yb, Int &q)
-	{
-		If(Ya != Yb)
-		{
-			Bool swap = Yb < Ya;
-
-			Int X1 = IfThenElse(swap, Xb, Xa);
-			Int X2 = IfThenElse(swap, Xa, Xb);
-			Int Y1 = IfThenElse(swap, Yb, Ya);
-			Int Y2 = IfThenElse(swap, Ya, Yb);
-
-			Int y1 = Max((Y1 + 0x0000000F) >> 4, *Pointer<Int>(data + OFFSET(DrawData,scissorY0)));
-			Int y2 = Min((Y2 + 0x0000000F) >> 4, *Pointer<Int>(data + OFFSET(DrawData,scissorY1)));
-
-			If(y1 < y2)
-			{
-				Int xMin = *Pointer<Int>(data + OFFSET(DrawData,scissorX0));
-				Int xMax = *Pointer<Int>(data + OFFSET(DrawData,scissorX1));
-
-				Pointer<Byte> leftEdge = primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->left);
-				Pointer<Byte> rightEdge = primitive + q * sizeof(Primitive) + OFFSET(Primitive,outline->right);
-				Pointer<Byte> edge = IfThenElse(swap, rightEdge, leftEdge);
-
-				// Deltas
-				Int DX12 = X2 - X1;
-				Int DY12 = Y2 - Y1;
-
-				Int FDX12 = DX12 << 4;
-				Int FDY12 = DY12 << 4;
-
-				Int X = DX12 * ((y1 << 4) - Y1) + (X1 & 0x0000000F) * DY12;
-				Int x = (X1 >> 4) + X / FDY12;   // Edge
-				Int d = X % FDY12;               // Error-term
-				Int ceil = -d >> 31;             // Ceiling division: remainder <= 0
-				x -= ceil;
-				d -= ceil & FDY12;
-
-				Int Q = FDX12 / FDY12;   // Edge-step
-				Int R = FDX12 % FDY12;   // Error-step
-				Int floor = R >> 31;     // Flooring division: remainder >= 0
-				Q += floor;
-				R += floor & FDY12;
-
-				Int D = FDY12;   // Error-overflow
-				Int y = y1;
-
-				Do
-				{
-					*Pointer<Short>(edge + y * sizeof(Primitive::Span)) = Short(Clamp(x, xMin, xMax));
-
-					x += Q;
-					d += R;
-
-					Int overflow = -d >> 31;
-
-					d -= D & overflow;
-					x -= overflow;
-
-					y++;
-				}
-				Until(y >= y2)
-			}
-		}
-	}
-
 	void SetupRoutine::conditionalRotate1(Bool condition, Pointer<Byte> &v0, Pointer<Byte> &v1, Pointer<Byte> &v2)
 	{
 		#if 0   // Rely on LLVM optimization
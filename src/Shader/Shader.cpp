@@ -18,15 +18,19 @@
 #include "PixelShader.hpp"
 #include "Math.hpp"
 #include "Debug.hpp"
+#include "Serialization.hpp"
+#include "Thread.hpp"
 
+#include <map>
 #include <set>
 #include <fstream>
 #include <sstream>
 #include <stdarg.h>
+#include <string.h>
 
 namespace sw
 {
-	volatile int Shader::serialCounter = 1;
+	volatile int Shader::serialCounter = 0;
 
 	Shader::Opcode Shader::OPCODE_DP(int i)
 	{
@@ -1114,9 +1118,10 @@ namespace sw
 		       analysisLeave;
 	}
 
-	Shader::Shader() : serialID(serialCounter++)
+	Shader::Shader() : serialID(atomicIncrement(&serialCounter))   // Also created by compiler threads
 	{
 		usedSamplers = 0;
+		branchConstantCount = 0;
 	}
 
 	Shader::~Shader()
@@ -1408,6 +1413,41 @@ namespace sw
 		return (usedSamplers & (1 << index)) != 0;
 	}
 
+	int Shader::getBranchConstantCount() const
+	{
+		return branchConstantCount;
+	}
+
+	const Shader::BranchConstant &Shader::getBranchConstant(int i) const
+	{
+		ASSERT(i < branchConstantCount);
+
+		return branchConstant[i];
+	}
+
+	int Shader::findBranchConstant(const SourceParameter &src, unsigned int component) const
+	{
+		if(!isBranchConstant(src))
+		{
+			return -1;
+		}
+
+		if(src.type == PARAMETER_CONSTBOOL)
+		{
+			component = 0;
+		}
+
+		for(int i = 0; i < branchConstantCount; i++)
+		{
+			if(branchConstant[i].type == src.type && branchConstant[i].index == src.index && branchConstant[i].component == component)
+			{
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
 	int Shader::getSerialID() const
 	{
 		return serialID;
@@ -1452,6 +1492,271 @@ namespace sw
 		file << instruction[index]->string(shaderType, version) << std::endl;
 	}
 
+	void Shader::serialize(Serializer &stream) const
+	{
+		stream.write(shaderType);
+		stream.write(version);
+		stream.write(static_cast<unsigned int>(instruction.size()));
+
+		for(const Instruction *inst : instruction)
+		{
+			stream.write(inst->opcode);
+			stream.write(inst->control);
+			stream.write(inst->predicate);
+			stream.write(inst->predicateNot);
+			stream.write(inst->predicateSwizzle);
+			stream.write(inst->coissue);
+			stream.write(inst->samplerType);
+			stream.write(inst->usage);
+			stream.write(inst->usageIndex);
+			stream.write(inst->dst);
+			stream.write(inst->src);
+			stream.write(inst->analysis);
+		}
+
+		stream.write(usedSamplers);
+		stream.write(dirtyConstantsF);
+		stream.write(dirtyConstantsI);
+		stream.write(dirtyConstantsB);
+		stream.write(dynamicallyIndexedTemporaries);
+		stream.write(dynamicallyIndexedInput);
+		stream.write(dynamicallyIndexedOutput);
+		stream.write(dynamicBranching);
+		stream.write(containsBreak);
+		stream.write(containsContinue);
+		stream.write(containsLeave);
+		stream.write(containsDefine);
+		stream.write(branchConstantCount);
+		stream.write(branchConstant);
+	}
+
+	bool Shader::deserialize(Deserializer &stream)
+	{
+		ASSERT(instruction.empty());
+
+		unsigned int length = 0;
+
+		stream.read(shaderType);
+		stream.read(version);
+		stream.read(length);
+
+		// Register limits depend on the stage, so check it before the instructions
+		if((shaderType != SHADER_VERTEX && shaderType != SHADER_PIXEL) || length > stream.remaining() / sizeof(Opcode))
+		{
+			stream.fail();
+		}
+
+		for(unsigned int i = 0; i < length && !stream.failed(); i++)
+		{
+			Instruction *inst = new Instruction(OPCODE_NOP);
+
+			stream.read(inst->opcode);
+			stream.read(inst->control);
+			stream.read(inst->predicate);
+			stream.read(inst->predicateNot);
+			stream.read(inst->predicateSwizzle);
+			stream.read(inst->coissue);
+			stream.read(inst->samplerType);
+			stream.read(inst->usage);
+			stream.read(inst->usageIndex);
+			stream.read(inst->dst);
+			stream.read(inst->src);
+			stream.read(inst->analysis);
+
+			append(inst);
+
+			if(!isValid(*inst))
+			{
+				stream.fail();
+			}
+		}
+
+		// Call sites index the return blocks of their label in order of appearance
+		std::map<unsigned int, unsigned int> callSites;
+
+		for(unsigned int i = 0; i < instruction.size() && !stream.failed(); i++)
+		{
+			const Instruction *inst = instruction[i];
+
+			if(inst->isCall() && inst->dst.callSite != callSites[inst->dst.label]++)
+			{
+				stream.fail();
+			}
+		}
+
+		stream.read(usedSamplers);
+		stream.read(dirtyConstantsF);
+		stream.read(dirtyConstantsI);
+		stream.read(dirtyConstantsB);
+		stream.read(dynamicallyIndexedTemporaries);
+		stream.read(dynamicallyIndexedInput);
+		stream.read(dynamicallyIndexedOutput);
+		stream.read(dynamicBranching);
+		stream.read(containsBreak);
+		stream.read(containsContinue);
+		stream.read(containsLeave);
+		stream.read(containsDefine);
+		stream.read(branchConstantCount);
+		stream.read(branchConstant);
+
+		if(branchConstantCount < 0 || branchConstantCount > MAX_BRANCH_CONSTANTS)
+		{
+			stream.fail();
+		}
+
+		for(int i = 0; i < branchConstantCount && !stream.failed(); i++)
+		{
+			if(!isValid(branchConstant[i]))
+			{
+				stream.fail();
+			}
+		}
+
+		return !stream.failed();
+	}
+
+	unsigned int Shader::registerCount(ParameterType type, int bufferIndex) const
+	{
+		bool vertex = (shaderType == SHADER_VERTEX);
+
+		switch(type)
+		{
+		case PARAMETER_TEMP:     return MAX_TEMPORARY_REGISTERS;
+		case PARAMETER_INPUT:    return vertex ? MAX_VERTEX_INPUTS : MAX_FRAGMENT_INPUTS;
+		case PARAMETER_CONST:
+			if(bufferIndex != -1)
+			{
+				return MAX_UNIFORM_BLOCK_SIZE;   // Uniform buffers are indexed in bytes
+			}
+
+			return vertex ? VERTEX_UNIFORM_VECTORS : FRAGMENT_UNIFORM_VECTORS;
+		case PARAMETER_OUTPUT:   return vertex ? MAX_VERTEX_OUTPUTS : 0;
+		case PARAMETER_COLOROUT: return vertex ? 0 : RENDERTARGETS;
+		case PARAMETER_DEPTHOUT: return vertex ? 0 : 1;
+		case PARAMETER_SAMPLER:  return vertex ? VERTEX_TEXTURE_IMAGE_UNITS : TEXTURE_IMAGE_UNITS;
+		default:                 return 0;   // Not produced by the GLSL compiler
+		}
+	}
+
+	// Checks that a register reference, and any relative addressing of it, stays within the register file
+	bool Shader::isValid(const Parameter &parameter, int bufferIndex, unsigned int extent) const
+	{
+		switch(parameter.type)
+		{
+		case PARAMETER_VOID:
+		case PARAMETER_FLOAT4LITERAL:
+			return true;
+		case PARAMETER_LABEL:
+			return parameter.label < MAX_LABELS;
+		case PARAMETER_MISCTYPE:
+			if(shaderType == SHADER_VERTEX)
+			{
+				return parameter.index == InstanceIDIndex || parameter.index == VertexIDIndex;
+			}
+
+			return parameter.index == VPosIndex || parameter.index == VFaceIndex;
+		default:
+			break;
+		}
+
+		unsigned int count = registerCount(parameter.type, bufferIndex);
+
+		if(parameter.index >= count || extent > count - parameter.index)
+		{
+			return false;
+		}
+
+		unsigned char deterministic;
+		memcpy(&deterministic, &parameter.rel.deterministic, sizeof(deterministic));
+
+		if(deterministic > 1)
+		{
+			return false;
+		}
+
+		switch(parameter.rel.type)
+		{
+		case PARAMETER_VOID:
+			return true;
+		case PARAMETER_TEMP:
+		case PARAMETER_INPUT:
+		case PARAMETER_CONST:
+		case PARAMETER_OUTPUT:
+			return parameter.rel.index < registerCount(parameter.rel.type, bufferIndex);
+		default:
+			return false;
+		}
+	}
+
+	bool Shader::isValid(const Instruction &instruction) const
+	{
+		Opcode opcode = instruction.opcode;
+
+		if(!(opcode <= OPCODE_DEFI || (opcode >= OPCODE_TEXCOORD && opcode <= OPCODE_TEXSIZE) || (opcode >= OPCODE_NULL && opcode <= OPCODE_UMAX)))
+		{
+			return false;
+		}
+
+		if(instruction.control > CONTROL_RESERVED1 || instruction.samplerType > SAMPLER_VOLUME || instruction.usage > USAGE_SAMPLE)
+		{
+			return false;
+		}
+
+		if(!isValid(instruction.dst, -1, 1))
+		{
+			return false;
+		}
+
+		for(int i = 0; i < 5; i++)
+		{
+			const SourceParameter &src = instruction.src[i];
+
+			int bufferBindings = (shaderType == SHADER_VERTEX) ? MAX_VERTEX_UNIFORM_BLOCKS : MAX_FRAGMENT_UNIFORM_BLOCKS;
+
+			if(src.modifier > MODIFIER_NOT || src.bufferIndex < -1 || src.bufferIndex >= bufferBindings)
+			{
+				return false;
+			}
+
+			// Matrix multiplications read consecutive rows starting at the second operand
+			unsigned int extent = 1;
+
+			if(i == 1)
+			{
+				switch(opcode)
+				{
+				case OPCODE_M3X2: extent = 2; break;
+				case OPCODE_M3X3: extent = 3; break;
+				case OPCODE_M3X4: extent = 4; break;
+				case OPCODE_M4X3: extent = 3; break;
+				case OPCODE_M4X4: extent = 4; break;
+				default:                      break;
+				}
+			}
+
+			if(!isValid(src, src.bufferIndex, extent))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Shader::isValid(const BranchConstant &constant) const
+	{
+		switch(constant.type)
+		{
+		case PARAMETER_CONST:
+		case PARAMETER_CONSTINT:
+			return constant.component < 4;
+		case PARAMETER_CONSTBOOL:
+			return constant.component == 0;
+		default:
+			return false;
+		}
+	}
+
 	void Shader::append(Instruction *instruction)
 	{
 		this->instruction.push_back(instruction);
@@ -1474,6 +1779,7 @@ namespace sw
 		optimizeLeave();
 		optimizeCall();
 		removeNull();
+		optimizeBranchConditions();
 	}
 
 	void Shader::optimizeLeave()
@@ -1554,6 +1860,45 @@ namespace sw
 		}
 	}
 
+	void Shader::optimizeBranchConditions()
+	{
+		// Branch directly on a constant copied into the condition register right before,
+		// so routines can be specialized on the constant's value
+		for(size_t i = 1; i < instruction.size(); i++)
+		{
+			SourceParameter &condition = instruction[i]->src[0];
+			const Instruction *copy = instruction[i - 1];
+
+			if(instruction[i]->opcode != OPCODE_IF || condition.type != PARAMETER_TEMP ||
+			   condition.rel.type != PARAMETER_VOID || condition.modifier != MODIFIER_NONE)
+			{
+				continue;
+			}
+
+			const DestinationParameter &dst = copy->dst;
+			const SourceParameter &src = copy->src[0];
+			int component = condition.swizzle & 0x3;
+
+			if((copy->opcode != OPCODE_MOV && copy->opcode != OPCODE_NOT) || copy->predicate ||
+			   dst.type != PARAMETER_TEMP || dst.index != condition.index || dst.rel.type != PARAMETER_VOID ||
+			   !(dst.mask & (1 << component)) || dst.integer || dst.saturate || dst.shift != 0)
+			{
+				continue;
+			}
+
+			if(src.type != PARAMETER_CONST || src.rel.type != PARAMETER_VOID || src.bufferIndex != -1 || src.modifier != MODIFIER_NONE)
+			{
+				continue;
+			}
+
+			int constantComponent = (src.swizzle >> (2 * component)) & 0x3;
+
+			condition = src;
+			condition.swizzle = constantComponent * 0x55;   // Replicate
+			condition.modifier = (copy->opcode == OPCODE_NOT) ? MODIFIER_NOT : MODIFIER_NONE;
+		}
+	}
+
 	void Shader::removeNull()
 	{
 		size_t size = 0;
@@ -1776,6 +2121,61 @@ namespace sw
 		}
 	}
 
+	void Shader::analyzeBranchConstants()
+	{
+		branchConstantCount = 0;
+
+		for(const Instruction *inst : instruction)
+		{
+			switch(inst->opcode)
+			{
+			case OPCODE_IF:
+			case OPCODE_CALLNZ:
+				addBranchConstant(inst->src[0], inst->src[0].swizzle & 0x3);
+				break;
+			case OPCODE_LOOP:   // Iteration count, initial loop counter and increment
+				addBranchConstant(inst->src[1], 0);
+				addBranchConstant(inst->src[1], 1);
+				addBranchConstant(inst->src[1], 2);
+				break;
+			case OPCODE_REP:
+				addBranchConstant(inst->src[0], 0);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	bool Shader::isBranchConstant(const SourceParameter &src)
+	{
+		switch(src.type)
+		{
+		case PARAMETER_CONST:
+			// Boolean masks in directly addressed default uniform block constants
+			return src.rel.type == PARAMETER_VOID && src.bufferIndex == -1 &&
+			       (src.modifier == MODIFIER_NONE || src.modifier == MODIFIER_NOT);
+		case PARAMETER_CONSTBOOL:
+		case PARAMETER_CONSTINT:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	void Shader::addBranchConstant(const SourceParameter &src, unsigned int component)
+	{
+		if(!isBranchConstant(src) || branchConstantCount == MAX_BRANCH_CONSTANTS || findBranchConstant(src, component) != -1)
+		{
+			return;
+		}
+
+		branchConstant[branchConstantCount].type = src.type;
+		branchConstant[branchConstantCount].index = src.index;
+		branchConstant[branchConstantCount].component = (src.type == PARAMETER_CONSTBOOL) ? 0 : component;
+		branchConstantCount++;
+	}
+
 	void Shader::markFunctionAnalysis(unsigned int functionLabel, Analysis flag)
 	{
 		bool marker = false;
@@ -22,6 +22,9 @@
 
 namespace sw
 {
+	class Serializer;
+	class Deserializer;
+
 	class Shader
 	{
 	public:
@@ -578,6 +581,26 @@ namespace sw
 		bool containsDefineInstruction() const;
 		bool usesSampler(int i) const;
 
+		// Uniforms which decide branches and loop counts, whose values routines can be specialized on
+		enum {MAX_BRANCH_CONSTANTS = 8};
+
+		enum
+		{
+			MAX_TEMPORARY_REGISTERS = 4096,
+			MAX_LABELS = 2048,
+		};
+
+		struct BranchConstant
+		{
+			ParameterType type;   // PARAMETER_CONST, PARAMETER_CONSTBOOL or PARAMETER_CONSTINT
+			unsigned int index;
+			unsigned int component;
+		};
+
+		int getBranchConstantCount() const;
+		const BranchConstant &getBranchConstant(int i) const;
+		int findBranchConstant(const SourceParameter &src, unsigned int component) const;   // Returns -1 if not a branch constant
+
 		struct Semantic
 		{
 			Semantic(unsigned char usage = 0xFF, unsigned char index = 0xFF, bool flat = false) : usage(usage), index(index), centroid(false), flat(flat)
@@ -602,6 +625,10 @@ namespace sw
 
 		void optimize();
 
+		// Binary form of the shader and its analysis, for program binaries
+		virtual void serialize(Serializer &stream) const;
+		virtual bool deserialize(Deserializer &stream);
+
 		// FIXME: Private
 		unsigned int dirtyConstantsF;
 		unsigned int dirtyConstantsI;
@@ -616,6 +643,7 @@ namespace sw
 
 		void optimizeLeave();
 		void optimizeCall();
+		void optimizeBranchConditions();
 		void removeNull();
 
 		void analyzeDirtyConstants();
@@ -623,6 +651,7 @@ namespace sw
 		void analyzeSamplers();
 		void analyzeCallSites();
 		void analyzeDynamicIndexing();
+		void analyzeBranchConstants();
 		void markFunctionAnalysis(unsigned int functionLabel, Analysis flag);
 
 		ShaderType shaderType;
@@ -651,6 +680,16 @@ namespace sw
 		bool containsContinue;
 		bool containsLeave;
 		bool containsDefine;
+
+		static bool isBranchConstant(const SourceParameter &src);
+		unsigned int registerCount(ParameterType type, int bufferIndex) const;
+		bool isValid(const Parameter &parameter, int bufferIndex, unsigned int extent) const;
+		bool isValid(const Instruction &instruction) const;
+		bool isValid(const BranchConstant &constant) const;
+		void addBranchConstant(const SourceParameter &src, unsigned int component);
+
+		int branchConstantCount;
+		BranchConstant branchConstant[MAX_BRANCH_CONSTANTS];
 	};
 }
 
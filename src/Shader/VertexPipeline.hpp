@@ -30,7 +30,7 @@ namespace sw
 		virtual ~VertexPipeline();
 
 	private:
-		void pipeline(UInt &index) override;
+		void pipeline(UInt4 &index) override;
 		void processTextureCoordinate(int stage, Vector4f &normal, Vector4f &position);
 		void processPointSize();
 
@@ -32,7 +32,7 @@ namespace sw
 		currentLabel = -1;
 		whileTest = false;
 
-		for(int i = 0; i < 2048; i++)
+		for(int i = 0; i < Shader::MAX_LABELS; i++)
 		{
 			labelBlock[i] = 0;
 		}
@@ -64,7 +64,7 @@ namespace sw
 		}
 	}
 
-	void VertexProgram::pipeline(UInt& index)
+	void VertexProgram::pipeline(UInt4 &index)
 	{
 		for(int i = 0; i < VERTEX_TEXTURE_IMAGE_UNITS; i++)
 		{
@@ -81,7 +81,7 @@ namespace sw
 		}
 	}
 
-	void VertexProgram::program(UInt& index)
+	void VertexProgram::program(UInt4 &index)
 	{
 	//	shader->print("VertexShader-%0.8X.txt", state.shaderID);
 
@@ -97,17 +97,7 @@ namespace sw
 
 		if(shader->isVertexIdDeclared())
 		{
-			if(state.textureSampling)
-			{
-				vertexID = Int4(index);
-			}
-			else
-			{
-				vertexID = Insert(vertexID, As<Int>(index), 0);
-				vertexID = Insert(vertexID, As<Int>(index + 1), 1);
-				vertexID = Insert(vertexID, As<Int>(index + 2), 2);
-				vertexID = Insert(vertexID, As<Int>(index + 3), 3);
-			}
+			vertexID = Int4(index);
 		}
 
 		// Create all call site return blocks up front
@@ -948,6 +938,42 @@ namespace sw
 		return 0;
 	}
 
+	bool VertexProgram::specializedConstant(const Src &src, unsigned int component, int &value) const
+	{
+		if(!state.specialized)
+		{
+			return false;
+		}
+
+		int index = shader->findBranchConstant(src, component);
+
+		if(index == -1)
+		{
+			return false;
+		}
+
+		value = state.branchConstant[index];
+
+		if(src.modifier == Shader::MODIFIER_NOT)
+		{
+			value = (src.type == Shader::PARAMETER_CONSTBOOL) ? !value : ~value;
+		}
+
+		return true;
+	}
+
+	Int VertexProgram::integerConstant(const Src &integerRegister, unsigned int component)
+	{
+		int value;
+
+		if(specializedConstant(integerRegister, component, value))
+		{
+			return Int(value);
+		}
+
+		return *Pointer<Int>(data + OFFSET(DrawData, vs.i[integerRegister.index][component]));
+	}
+
 	Int4 VertexProgram::enableMask(const Shader::Instruction *instruction)
 	{
 		Int4 enable = instruction->analysisBranch ? Int4(enableStack[enableIndex]) : Int4(0xFFFFFFFF);
@@ -1146,6 +1172,23 @@ namespace sw
 
 	void VertexProgram::CALLNZb(int labelIndex, int callSiteIndex, const Src &boolRegister)
 	{
+		int value;
+
+		if(specializedConstant(boolRegister, 0, value))
+		{
+			if(value != 0)
+			{
+				CALL(labelIndex, callSiteIndex);
+			}
+			else
+			{
+				Nucleus::createBr(callRetBlock[labelIndex][callSiteIndex]);
+				Nucleus::setInsertBlock(callRetBlock[labelIndex][callSiteIndex]);
+			}
+
+			return;
+		}
+
 		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData,vs.b[boolRegister.index])) != Byte(0));   // FIXME
 
 		if(boolRegister.modifier == Shader::MODIFIER_NOT)
@@ -1317,8 +1360,17 @@ namespace sw
 		}
 		else
 		{
-			Int4 condition = As<Int4>(fetchRegister(src).x);
-			IF(condition);
+			int value;
+
+			if(specializedConstant(src, src.swizzle & 0x3, value) && (value == 0 || value == -1))
+			{
+				IF(value != 0);
+			}
+			else
+			{
+				Int4 condition = As<Int4>(fetchRegister(src).x);
+				IF(condition);
+			}
 		}
 	}
 
@@ -1326,6 +1378,14 @@ namespace sw
 	{
 		ASSERT(ifDepth < 24 + 4);
 
+		int value;
+
+		if(specializedConstant(boolRegister, 0, value))
+		{
+			IF(value != 0);
+			return;
+		}
+
 		Bool condition = (*Pointer<Byte>(data + OFFSET(DrawData,vs.b[boolRegister.index])) != Byte(0));   // FIXME
 
 		if(boolRegister.modifier == Shader::MODIFIER_NOT)
@@ -1396,6 +1456,23 @@ namespace sw
 		breakDepth++;
 	}
 
+	void VertexProgram::IF(bool condition)
+	{
+		ASSERT(ifDepth < 24 + 4);
+
+		BasicBlock *trueBlock = Nucleus::createBasicBlock();
+		BasicBlock *falseBlock = Nucleus::createBasicBlock();
+
+		// The other block is unreachable, so no code gets generated for it
+		Nucleus::createBr(condition ? trueBlock : falseBlock);
+		Nucleus::setInsertBlock(trueBlock);
+
+		isConditionalIf[ifDepth] = false;
+		ifFalseBlock[ifDepth] = falseBlock;
+
+		ifDepth++;
+	}
+
 	void VertexProgram::LABEL(int labelIndex)
 	{
 		if(!labelBlock[labelIndex])
@@ -1411,9 +1488,9 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][0]));
-		aL[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][1]));
-		increment[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][2]));
+		iteration[loopDepth] = integerConstant(integerRegister, 0);
+		aL[loopDepth] = integerConstant(integerRegister, 1);
+		increment[loopDepth] = integerConstant(integerRegister, 2);
 
 		// FIXME: Compiles to two instructions?
 		If(increment[loopDepth] == 0)
@@ -1445,7 +1522,7 @@ namespace sw
 	{
 		loopDepth++;
 
-		iteration[loopDepth] = *Pointer<Int>(data + OFFSET(DrawData,vs.i[integerRegister.index][0]));
+		iteration[loopDepth] = integerConstant(integerRegister, 0);
 		aL[loopDepth] = aL[loopDepth - 1];
 
 		BasicBlock *loopBlock = Nucleus::createBasicBlock();
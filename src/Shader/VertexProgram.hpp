@@ -37,7 +37,7 @@ namespace sw
 	private:
 		const VertexShader *const shader;
 
-		RegisterArray<4096> r;   // Temporary registers
+		RegisterArray<Shader::MAX_TEMPORARY_REGISTERS> r;   // Temporary registers
 		Vector4f a0;
 		Array<Int, 4> aL;
 		Vector4f p0;
@@ -63,8 +63,8 @@ namespace sw
 		typedef Shader::Control Control;
 		typedef Shader::Usage Usage;
 
-		void pipeline(UInt &index) override;
-		void program(UInt &index);
+		void pipeline(UInt4 &index) override;
+		void program(UInt4 &index);
 		void passThrough();
 
 		Vector4f fetchRegister(const Src &src, unsigned int offset = 0);
@@ -72,6 +72,8 @@ namespace sw
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index);
 		RValue<Pointer<Byte>> uniformAddress(int bufferIndex, unsigned int index, Int& offset);
 		Int relativeAddress(const Shader::Parameter &var, int bufferIndex = -1);
+		bool specializedConstant(const Src &src, unsigned int component, int &value) const;
+		Int integerConstant(const Src &integerRegister, unsigned int component);
 		Int4 enableMask(const Shader::Instruction *instruction);
 
 		void M3X2(Vector4f &dst, Vector4f &src0, Src &src1);
@@ -100,6 +102,7 @@ namespace sw
 		void IFp(const Src &predicateRegister);
 		void IFC(Vector4f &src0, Vector4f &src1, Control);
 		void IF(Int4 &condition);
+		void IF(bool condition);   // Static branch on a specialized constant
 		void LABEL(int labelIndex);
 		void LOOP(const Src &integerRegister);
 		void REP(const Src &integerRegister);
@@ -130,8 +133,8 @@ namespace sw
 		BasicBlock *ifFalseBlock[24 + 24];
 		BasicBlock *loopRepTestBlock[4];
 		BasicBlock *loopRepEndBlock[4];
-		BasicBlock *labelBlock[2048];
-		std::vector<BasicBlock*> callRetBlock[2048];
+		BasicBlock *labelBlock[Shader::MAX_LABELS];
+		std::vector<BasicBlock*> callRetBlock[Shader::MAX_LABELS];
 		BasicBlock *returnBlock;
 		bool isConditionalIf[24 + 24];
 	};
@@ -26,6 +26,18 @@ namespace sw
 	extern bool halfIntegerCoordinates;     // Pixel centers are not at integer coordinates
 	extern bool symmetricNormalizedDepth;   // [-1, 1] instead of [0, 1]
 
+	// Loads a 32-bit element from each of the four vertices
+	static Int4 gather(Pointer<Byte> &source0, Pointer<Byte> &source1, Pointer<Byte> &source2, Pointer<Byte> &source3)
+	{
+		Int4 src;
+		src = Insert(src, *Pointer<Int>(source0), 0);
+		src = Insert(src, *Pointer<Int>(source1), 1);
+		src = Insert(src, *Pointer<Int>(source2), 2);
+		src = Insert(src, *Pointer<Int>(source3), 3);
+
+		return src;
+	}
+
 	VertexRoutine::VertexRoutine(const VertexProcessor::State &state, const VertexShader *shader)
 		: v(shader && shader->dynamicallyIndexedInput),
 		  o(shader && shader->dynamicallyIndexedOutput),
@@ -42,41 +54,72 @@ namespace sw
 		const bool textureSampling = state.textureSampling;
 
 		Pointer<Byte> cache = task + OFFSET(VertexTask,vertexCache);
-		Pointer<Byte> vertexCache = cache + OFFSET(VertexCache,vertex);
-		Pointer<Byte> tagCache = cache + OFFSET(VertexCache,tag);
+		Pointer<Byte> vertexCache = *Pointer<Pointer<Byte>>(cache + OFFSET(VertexCache,vertex));
+
+		UInt shadeCount = *Pointer<UInt>(task + OFFSET(VertexTask,shadeCount));
+		UInt copyCount = *Pointer<UInt>(task + OFFSET(VertexTask,copyCount));
+		UInt fillCount = *Pointer<UInt>(task + OFFSET(VertexTask,fillCount));
 
-		UInt vertexCount = *Pointer<UInt>(task + OFFSET(VertexTask,vertexCount));
-		UInt primitiveNumber = *Pointer<UInt>(task + OFFSET(VertexTask, primitiveStart));
-		UInt indexInPrimitive = 0;
+		#if PERF_PROFILE
+			UInt lanes = 0;
+		#endif
 
 		constants = *Pointer<Pointer<Byte>>(data + OFFSET(DrawData,constants));
 
-		Do
+		// Shade the vertices missing from the cache four at a time, each in its own lane
+		For(UInt i = 0, i < shadeCount, i += UInt(textureSampling ? 1 : 4))
 		{
-			UInt index = *Pointer<UInt>(batch);
-			UInt tagIndex = index & 0x0000003C;
-			UInt indexQ = !textureSampling ? UInt(index & 0xFFFFFFFC) : index;   // FIXME: TEXLDL hack to have independent LODs, hurts performance.
+			UInt4 index;
+			Pointer<Byte> slot = task + OFFSET(VertexTask,shadeSlot) + i * UInt((int)sizeof(unsigned int));
 
-			If(*Pointer<UInt>(tagCache + tagIndex) != indexQ)
+			if(!textureSampling)
 			{
-				*Pointer<UInt>(tagCache + tagIndex) = indexQ;
+				index = *Pointer<UInt4>(task + OFFSET(VertexTask,shadeIndex) + i * UInt((int)sizeof(unsigned int)));
+			}
+			else   // FIXME: TEXLDL hack to have independent LODs, hurts performance.
+			{
+				index = UInt4(Int4(*Pointer<Int>(task + OFFSET(VertexTask,shadeIndex) + i * UInt((int)sizeof(unsigned int)))));
+			}
 
-				readInput(indexQ);
-				pipeline(indexQ);
-				postTransform();
-				computeClipFlags();
+			readInput(index);
+			pipeline(index);
+			postTransform();
+			computeClipFlags();
+			writeVertices(slot, textureSampling);
 
-				Pointer<Byte> cacheLine0 = vertexCache + tagIndex * UInt((int)sizeof(Vertex));
-				writeCache(cacheLine0);
-			}
+			#if PERF_PROFILE
+				lanes += 4;
+			#endif
+		}
+
+		// Copy the vertices which hit before their cache entries get replaced with the shaded ones
+		For(UInt i = 0, i < copyCount, i++)
+		{
+			UInt slot = *Pointer<UInt>(task + OFFSET(VertexTask,copySlot) + i * UInt((int)sizeof(unsigned int)));
+			UInt entry = *Pointer<UInt>(task + OFFSET(VertexTask,copyEntry) + i * UInt((int)sizeof(unsigned int)));
+
+			copyVertex(vertex + slot * UInt((int)sizeof(Vertex)), vertexCache + entry * UInt((int)sizeof(Vertex)));
+		}
+
+		For(UInt i = 0, i < fillCount, i++)
+		{
+			UInt slot = *Pointer<UInt>(task + OFFSET(VertexTask,fillSlot) + i * UInt((int)sizeof(unsigned int)));
+			UInt entry = *Pointer<UInt>(task + OFFSET(VertexTask,fillEntry) + i * UInt((int)sizeof(unsigned int)));
+
+			copyVertex(vertexCache + entry * UInt((int)sizeof(Vertex)), vertex + slot * UInt((int)sizeof(Vertex)));
+		}
 
-			UInt cacheIndex = index & 0x0000003F;
-			Pointer<Byte> cacheLine = vertexCache + cacheIndex * UInt((int)sizeof(Vertex));
-			writeVertex(vertex, cacheLine);
+		if(state.transformFeedbackEnabled != 0)
+		{
+			UInt vertexCount = *Pointer<UInt>(task + OFFSET(VertexTask,vertexCount));
+			UInt primitiveNumber = *Pointer<UInt>(task + OFFSET(VertexTask,primitiveStart));
+			UInt indexInPrimitive = 0;
 
-			if(state.transformFeedbackEnabled != 0)
+			For(UInt i = 0, i < vertexCount, i++)
 			{
-				transformFeedback(vertex, primitiveNumber, indexInPrimitive);
+				UInt slot = *Pointer<UInt>(batch + i * UInt((int)sizeof(unsigned int)));
+
+				transformFeedback(vertex + slot * UInt((int)sizeof(Vertex)), primitiveNumber, indexInPrimitive);
 
 				indexInPrimitive++;
 				If(indexInPrimitive == 3)
@@ -85,17 +128,16 @@ namespace sw
 					indexInPrimitive = 0;
 				}
 			}
-
-			vertex += sizeof(Vertex);
-			batch += sizeof(unsigned int);
-			vertexCount--;
 		}
-		Until(vertexCount == 0)
+
+		#if PERF_PROFILE
+			*Pointer<UInt>(task + OFFSET(VertexTask,vertexLanes)) = lanes;
+		#endif
 
 		Return();
 	}
 
-	void VertexRoutine::readInput(UInt &index)
+	void VertexRoutine::readInput(UInt4 &index)
 	{
 		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
 		{
@@ -137,16 +179,15 @@ namespace sw
 		}
 	}
 
-	Vector4f VertexRoutine::readStream(Pointer<Byte> &buffer, UInt &stride, const Stream &stream, const UInt &index)
+	Vector4f VertexRoutine::readStream(Pointer<Byte> &buffer, UInt &stride, const Stream &stream, const UInt4 &index)
 	{
-		const bool textureSampling = state.textureSampling;
-
 		Vector4f v;
 
-		Pointer<Byte> source0 = buffer + index * stride;
-		Pointer<Byte> source1 = source0 + (!textureSampling ? stride : 0);
-		Pointer<Byte> source2 = source1 + (!textureSampling ? stride : 0);
-		Pointer<Byte> source3 = source2 + (!textureSampling ? stride : 0);
+		Int4 offset = Int4(index);
+		Pointer<Byte> source0 = buffer + UInt(Extract(offset, 0)) * stride;
+		Pointer<Byte> source1 = buffer + UInt(Extract(offset, 1)) * stride;
+		Pointer<Byte> source2 = buffer + UInt(Extract(offset, 2)) * stride;
+		Pointer<Byte> source3 = buffer + UInt(Extract(offset, 3)) * stride;
 
 		bool isNativeFloatAttrib = (stream.attribType == VertexShader::ATTRIBTYPE_FLOAT) || stream.normalized;
 
@@ -382,101 +423,20 @@ namespace sw
 			break;
 		case STREAMTYPE_UDEC3:
 			{
-				// FIXME: Vectorize
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source0);
-
-					v.x.x = Float(x & 0x000003FF);
-					v.x.y = Float(y & 0x000FFC00);
-					v.x.z = Float(z & 0x3FF00000);
-				}
-
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source1);
-
-					v.y.x = Float(x & 0x000003FF);
-					v.y.y = Float(y & 0x000FFC00);
-					v.y.z = Float(z & 0x3FF00000);
-				}
-
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source2);
+				Int4 src = gather(source0, source1, source2, source3);
 
-					v.z.x = Float(x & 0x000003FF);
-					v.z.y = Float(y & 0x000FFC00);
-					v.z.z = Float(z & 0x3FF00000);
-				}
-
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source3);
-
-					v.w.x = Float(x & 0x000003FF);
-					v.w.y = Float(y & 0x000FFC00);
-					v.w.z = Float(z & 0x3FF00000);
-				}
-
-				transpose4x3(v.x, v.y, v.z, v.w);
-
-				v.y *= Float4(1.0f / 0x00000400);
-				v.z *= Float4(1.0f / 0x00100000);
+				v.x = Float4(src & Int4(0x3FF));
+				v.y = Float4((src >> 10) & Int4(0x3FF));
+				v.z = Float4((src >> 20) & Int4(0x3FF));
 			}
 			break;
 		case STREAMTYPE_DEC3N:
 			{
-				// FIXME: Vectorize
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source0);
-
-					v.x.x = Float((x << 22) & 0xFFC00000);
-					v.x.y = Float((y << 12) & 0xFFC00000);
-					v.x.z = Float((z << 2)  & 0xFFC00000);
-				}
-
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source1);
+				Int4 src = gather(source0, source1, source2, source3);
 
-					v.y.x = Float((x << 22) & 0xFFC00000);
-					v.y.y = Float((y << 12) & 0xFFC00000);
-					v.y.z = Float((z << 2)  & 0xFFC00000);
-				}
-
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source2);
-
-					v.z.x = Float((x << 22) & 0xFFC00000);
-					v.z.y = Float((y << 12) & 0xFFC00000);
-					v.z.z = Float((z << 2)  & 0xFFC00000);
-				}
-
-				{
-					Int x, y, z;
-
-					x = y = z = *Pointer<Int>(source3);
-
-					v.w.x = Float((x << 22) & 0xFFC00000);
-					v.w.y = Float((y << 12) & 0xFFC00000);
-					v.w.z = Float((z << 2)  & 0xFFC00000);
-				}
-
-				transpose4x3(v.x, v.y, v.z, v.w);
-
-				v.x *= Float4(1.0f / 0x00400000 / 511.0f);
-				v.y *= Float4(1.0f / 0x00400000 / 511.0f);
-				v.z *= Float4(1.0f / 0x00400000 / 511.0f);
+				v.x = Float4((src << 22) >> 22) * Float4(1.0f / 511.0f);
+				v.y = Float4((src << 12) >> 22) * Float4(1.0f / 511.0f);
+				v.z = Float4((src << 2) >> 22) * Float4(1.0f / 511.0f);
 			}
 			break;
 		case STREAMTYPE_FIXED:
@@ -554,11 +514,7 @@ namespace sw
 			break;
 		case STREAMTYPE_2_10_10_10_INT:
 			{
-				Int4 src;
-				src = Insert(src, *Pointer<Int>(source0), 0);
-				src = Insert(src, *Pointer<Int>(source1), 1);
-				src = Insert(src, *Pointer<Int>(source2), 2);
-				src = Insert(src, *Pointer<Int>(source3), 3);
+				Int4 src = gather(source0, source1, source2, source3);
 
 				v.x = Float4((src << 22) >> 22);
 				v.y = Float4((src << 12) >> 22);
@@ -576,11 +532,7 @@ namespace sw
 			break;
 		case STREAMTYPE_2_10_10_10_UINT:
 			{
-				Int4 src;
-				src = Insert(src, *Pointer<Int>(source0), 0);
-				src = Insert(src, *Pointer<Int>(source1), 1);
-				src = Insert(src, *Pointer<Int>(source2), 2);
-				src = Insert(src, *Pointer<Int>(source3), 3);
+				Int4 src = gather(source0, source1, source2, source3);
 
 				v.x = Float4(src & Int4(0x3FF));
 				v.y = Float4((src >> 10) & Int4(0x3FF));
@@ -641,8 +593,21 @@ namespace sw
 		}
 	}
 
-	void VertexRoutine::writeCache(Pointer<Byte> &cacheLine)
+	void VertexRoutine::writeVertices(Pointer<Byte> &slot, bool uniform)
 	{
+		// The batch vertices of the four lanes, or a single one written four times
+		Pointer<Byte> vertex0 = vertex + *Pointer<UInt>(slot + 0 * sizeof(unsigned int)) * UInt((int)sizeof(Vertex));
+		Pointer<Byte> vertex1 = vertex0;
+		Pointer<Byte> vertex2 = vertex0;
+		Pointer<Byte> vertex3 = vertex0;
+
+		if(!uniform)
+		{
+			vertex1 = vertex + *Pointer<UInt>(slot + 1 * sizeof(unsigned int)) * UInt((int)sizeof(Vertex));
+			vertex2 = vertex + *Pointer<UInt>(slot + 2 * sizeof(unsigned int)) * UInt((int)sizeof(Vertex));
+			vertex3 = vertex + *Pointer<UInt>(slot + 3 * sizeof(unsigned int)) * UInt((int)sizeof(Vertex));
+		}
+
 		Vector4f v;
 
 		for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
@@ -680,10 +645,10 @@ namespace sw
 
 				if(state.output[i].write == 0x01)
 				{
-					*Pointer<Float>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 0) = v.x.x;
-					*Pointer<Float>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 1) = v.x.y;
-					*Pointer<Float>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 2) = v.x.z;
-					*Pointer<Float>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 3) = v.x.w;
+					*Pointer<Float>(vertex0 + OFFSET(Vertex,v[i])) = v.x.x;
+					*Pointer<Float>(vertex1 + OFFSET(Vertex,v[i])) = v.x.y;
+					*Pointer<Float>(vertex2 + OFFSET(Vertex,v[i])) = v.x.z;
+					*Pointer<Float>(vertex3 + OFFSET(Vertex,v[i])) = v.x.w;
 				}
 				else
 				{
@@ -696,18 +661,18 @@ namespace sw
 						transpose4x4(v.x, v.y, v.z, v.w);
 					}
 
-					*Pointer<Float4>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 0, 16) = v.x;
-					*Pointer<Float4>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 1, 16) = v.y;
-					*Pointer<Float4>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 2, 16) = v.z;
-					*Pointer<Float4>(cacheLine + OFFSET(Vertex,v[i]) + sizeof(Vertex) * 3, 16) = v.w;
+					*Pointer<Float4>(vertex0 + OFFSET(Vertex,v[i]), 16) = v.x;
+					*Pointer<Float4>(vertex1 + OFFSET(Vertex,v[i]), 16) = v.y;
+					*Pointer<Float4>(vertex2 + OFFSET(Vertex,v[i]), 16) = v.z;
+					*Pointer<Float4>(vertex3 + OFFSET(Vertex,v[i]), 16) = v.w;
 				}
 			}
 		}
 
-		*Pointer<Int>(cacheLine + OFFSET(Vertex,clipFlags) + sizeof(Vertex) * 0) = (clipFlags >> 0)  & 0x0000000FF;
-		*Pointer<Int>(cacheLine + OFFSET(Vertex,clipFlags) + sizeof(Vertex) * 1) = (clipFlags >> 8)  & 0x0000000FF;
-		*Pointer<Int>(cacheLine + OFFSET(Vertex,clipFlags) + sizeof(Vertex) * 2) = (clipFlags >> 16) & 0x0000000FF;
-		*Pointer<Int>(cacheLine + OFFSET(Vertex,clipFlags) + sizeof(Vertex) * 3) = (clipFlags >> 24) & 0x0000000FF;
+		*Pointer<Int>(vertex0 + OFFSET(Vertex,clipFlags)) = (clipFlags >> 0)  & 0x0000000FF;
+		*Pointer<Int>(vertex1 + OFFSET(Vertex,clipFlags)) = (clipFlags >> 8)  & 0x0000000FF;
+		*Pointer<Int>(vertex2 + OFFSET(Vertex,clipFlags)) = (clipFlags >> 16) & 0x0000000FF;
+		*Pointer<Int>(vertex3 + OFFSET(Vertex,clipFlags)) = (clipFlags >> 24) & 0x0000000FF;
 
 		// Viewport transform
 		int pos = state.positionRegister;
@@ -732,24 +697,24 @@ namespace sw
 
 		transpose4x4(v.x, v.y, v.z, v.w);
 
-		*Pointer<Float4>(cacheLine + OFFSET(Vertex,X) + sizeof(Vertex) * 0, 16) = v.x;
-		*Pointer<Float4>(cacheLine + OFFSET(Vertex,X) + sizeof(Vertex) * 1, 16) = v.y;
-		*Pointer<Float4>(cacheLine + OFFSET(Vertex,X) + sizeof(Vertex) * 2, 16) = v.z;
-		*Pointer<Float4>(cacheLine + OFFSET(Vertex,X) + sizeof(Vertex) * 3, 16) = v.w;
+		*Pointer<Float4>(vertex0 + OFFSET(Vertex,X), 16) = v.x;
+		*Pointer<Float4>(vertex1 + OFFSET(Vertex,X), 16) = v.y;
+		*Pointer<Float4>(vertex2 + OFFSET(Vertex,X), 16) = v.z;
+		*Pointer<Float4>(vertex3 + OFFSET(Vertex,X), 16) = v.w;
 	}
 
-	void VertexRoutine::writeVertex(const Pointer<Byte> &vertex, Pointer<Byte> &cache)
+	void VertexRoutine::copyVertex(const Pointer<Byte> &destination, const Pointer<Byte> &source)
 	{
 		for(int i = 0; i < MAX_VERTEX_OUTPUTS; i++)
 		{
 			if(state.output[i].write)
 			{
-				*Pointer<Int4>(vertex + OFFSET(Vertex,v[i]), 16) = *Pointer<Int4>(cache + OFFSET(Vertex,v[i]), 16);
+				*Pointer<Int4>(destination + OFFSET(Vertex,v[i]), 16) = *Pointer<Int4>(source + OFFSET(Vertex,v[i]), 16);
 			}
 		}
 
-		*Pointer<Int4>(vertex + OFFSET(Vertex,X)) = *Pointer<Int4>(cache + OFFSET(Vertex,X));
-		*Pointer<Int>(vertex + OFFSET(Vertex,clipFlags)) = *Pointer<Int>(cache + OFFSET(Vertex,clipFlags));
+		*Pointer<Int4>(destination + OFFSET(Vertex,X)) = *Pointer<Int4>(source + OFFSET(Vertex,X));
+		*Pointer<Int>(destination + OFFSET(Vertex,clipFlags)) = *Pointer<Int>(source + OFFSET(Vertex,clipFlags));
 	}
 
 	void VertexRoutine::transformFeedback(const Pointer<Byte> &vertex, const UInt &primitiveNumber, const UInt &indexInPrimitive)
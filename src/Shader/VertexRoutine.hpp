@@ -54,16 +54,16 @@ namespace sw
 		const VertexProcessor::State &state;
 
 	private:
-		virtual void pipeline(UInt &index) = 0;
+		virtual void pipeline(UInt4 &index) = 0;   // Vertex index of each lane
 
 		typedef VertexProcessor::State::Input Stream;
 
-		Vector4f readStream(Pointer<Byte> &buffer, UInt &stride, const Stream &stream, const UInt &index);
-		void readInput(UInt &index);
+		Vector4f readStream(Pointer<Byte> &buffer, UInt &stride, const Stream &stream, const UInt4 &index);
+		void readInput(UInt4 &index);
 		void computeClipFlags();
 		void postTransform();
-		void writeCache(Pointer<Byte> &cacheLine);
-		void writeVertex(const Pointer<Byte> &vertex, Pointer<Byte> &cacheLine);
+		void writeVertices(Pointer<Byte> &slot, bool uniform);   // To the batch vertices listed at slot
+		void copyVertex(const Pointer<Byte> &destination, const Pointer<Byte> &source);
 		void transformFeedback(const Pointer<Byte> &vertex, const UInt &primitiveNumber, const UInt &indexInPrimitive);
 	};
 }
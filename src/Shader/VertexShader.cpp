@@ -16,6 +16,7 @@
 
 #include "Vertex.hpp"
 #include "Debug.hpp"
+#include "Serialization.hpp"
 
 #include <string.h>
 
@@ -23,6 +24,7 @@ namespace sw
 {
 	VertexShader::VertexShader(const VertexShader *vs) : Shader()
 	{
+		shaderType = SHADER_VERTEX;
 		version = 0x0300;
 		positionRegister = Pos;
 		pointSizeRegister = Unused;
@@ -81,6 +83,52 @@ namespace sw
 	{
 	}
 
+	void VertexShader::serialize(Serializer &stream) const
+	{
+		Shader::serialize(stream);
+
+		stream.write(input);
+		stream.write(output);
+		stream.write(attribType);
+		stream.write(positionRegister);
+		stream.write(pointSizeRegister);
+		stream.write(instanceIdDeclared);
+		stream.write(vertexIdDeclared);
+		stream.write(textureSampling);
+	}
+
+	bool VertexShader::deserialize(Deserializer &stream)
+	{
+		if(!Shader::deserialize(stream))
+		{
+			return false;
+		}
+
+		stream.read(input);
+		stream.read(output);
+		stream.read(attribType);
+		stream.read(positionRegister);
+		stream.read(pointSizeRegister);
+		stream.read(instanceIdDeclared);
+		stream.read(vertexIdDeclared);
+		stream.read(textureSampling);
+
+		if(positionRegister < 0 || positionRegister >= MAX_VERTEX_OUTPUTS || pointSizeRegister < 0 || pointSizeRegister > Unused)
+		{
+			stream.fail();
+		}
+
+		for(int i = 0; i < MAX_VERTEX_INPUTS; i++)
+		{
+			if(attribType[i] > ATTRIBTYPE_LAST)
+			{
+				stream.fail();
+			}
+		}
+
+		return !stream.failed() && shaderType == SHADER_VERTEX;
+	}
+
 	int VertexShader::validate(const unsigned long *const token)
 	{
 		if(!token)
@@ -205,6 +253,7 @@ namespace sw
 		analyzeDirtyConstants();
 		analyzeTextureSampling();
 		analyzeDynamicBranching();
+		analyzeBranchConstants();
 		analyzeSamplers();
 		analyzeCallSites();
 		analyzeDynamicIndexing();
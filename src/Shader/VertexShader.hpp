@@ -37,6 +37,9 @@ namespace sw
 
 		virtual ~VertexShader();
 
+		void serialize(Serializer &stream) const override;
+		bool deserialize(Deserializer &stream) override;
+
 		static int validate(const unsigned long *const token);   // Returns number of instructions if valid
 		bool containsTextureSampling() const;
 
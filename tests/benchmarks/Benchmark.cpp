@@ -0,0 +1,82 @@
+// Copyright 2017 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Benchmark.hpp"
+
+#include "Common/Timer.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace benchmark
+{
+	struct Entry
+	{
+		const char *name;
+		BenchmarkFunction function;
+	};
+
+	static std::vector<Entry> &registry()
+	{
+		static std::vector<Entry> benchmarks;   // Constructed on first use, before any registration
+
+		return benchmarks;
+	}
+
+	Registration::Registration(const char *name, BenchmarkFunction function)
+	{
+		registry().push_back({name, function});
+	}
+
+	void report(const char *benchmark, const char *metric, double value, const char *unit)
+	{
+		printf("%s.%s: %.3f %s\n", benchmark, metric, value, unit);
+		fflush(stdout);
+	}
+
+	double throughput(void (*function)(void *data, int iterations), void *data, double minimumTime)
+	{
+		function(data, 1);   // Warm up caches and lazily initialized state
+
+		for(int iterations = 1; ; iterations *= 2)
+		{
+			double start = sw::Timer::seconds();
+			function(data, iterations);
+			double elapsed = sw::Timer::seconds() - start;
+
+			if(elapsed >= minimumTime)
+			{
+				return iterations / elapsed;
+			}
+		}
+	}
+}
+
+// Usage: SwiftShaderBenchmarks [filter]
+// Runs all benchmarks whose name contains the filter string.
+int main(int argc, char **argv)
+{
+	const char *filter = (argc > 1) ? argv[1] : "";
+
+	for(const benchmark::Entry &entry : benchmark::registry())
+	{
+		if(strstr(entry.name, filter))
+		{
+			entry.function();
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,42 @@
+// Copyright 2017 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_HPP_
+#define BENCHMARK_HPP_
+
+namespace benchmark
+{
+	typedef void (*BenchmarkFunction)();
+
+	// Adds a benchmark to the list run by main(). Use through the BENCHMARK macro.
+	struct Registration
+	{
+		Registration(const char *name, BenchmarkFunction function);
+	};
+
+	// Prints a single measurement as "<benchmark>.<metric>: <value> <unit>",
+	// so that runs against different builds or Reactor back-ends can be diffed.
+	void report(const char *benchmark, const char *metric, double value, const char *unit);
+
+	// Calls function(iterations) with a growing iteration count until it takes at
+	// least minimumTime seconds, and returns the number of iterations per second.
+	double throughput(void (*function)(void *data, int iterations), void *data, double minimumTime = 0.5);
+}
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static benchmark::Registration name##Registration(#name, name); \
+	static void name()
+
+#endif   // BENCHMARK_HPP_
@@ -0,0 +1,119 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the rate of texture and buffer binds in random order, which is
+// dominated by looking up objects by name, for small and large object counts.
+
+#include "Benchmark.hpp"
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+
+#include <string>
+#include <vector>
+
+using namespace benchmark;
+
+namespace
+{
+	const int streamLength = 4096;
+
+	struct Objects
+	{
+		std::vector<GLuint> textures;
+		std::vector<GLuint> buffers;
+		std::vector<int> stream;   // Indices of the objects to bind
+	};
+
+	void bindStream(void *data, int iterations)
+	{
+		const Objects *objects = static_cast<const Objects*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			for(int index : objects->stream)
+			{
+				glBindTexture(GL_TEXTURE_2D, objects->textures[index]);
+				glBindBuffer(GL_ARRAY_BUFFER, objects->buffers[index]);
+			}
+		}
+	}
+
+	void measure(int objectCount)
+	{
+		Objects objects;
+		objects.textures.resize(objectCount);
+		objects.buffers.resize(objectCount);
+
+		glGenTextures(objectCount, objects.textures.data());
+		glGenBuffers(objectCount, objects.buffers.data());
+
+		unsigned int random = 1;
+
+		for(int i = 0; i < streamLength; i++)
+		{
+			random = random * 1103515245 + 12345;
+			objects.stream.push_back((random >> 8) % objectCount);
+		}
+
+		// Binding creates the objects
+		for(int i = 0; i < objectCount; i++)
+		{
+			glBindTexture(GL_TEXTURE_2D, objects.textures[i]);
+			glBindBuffer(GL_ARRAY_BUFFER, objects.buffers[i]);
+		}
+
+		std::string name = "Bind." + std::to_string(objectCount);
+		report(name.c_str(), "rate", throughput(bindStream, &objects) * streamLength * 2, "binds/s");
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDeleteTextures(objectCount, objects.textures.data());
+		glDeleteBuffers(objectCount, objects.buffers.data());
+	}
+}
+
+BENCHMARK(Bind)
+{
+	EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	eglInitialize(display, nullptr, nullptr);
+	eglBindAPI(EGL_OPENGL_ES_API);
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+	const EGLint surfaceAttributes[] = {EGL_WIDTH, 64, EGL_HEIGHT, 64, EGL_NONE};
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+	const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	eglMakeCurrent(display, surface, surface, context);
+
+	measure(256);
+	measure(65536);
+
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(display, context);
+	eglDestroySurface(display, surface);
+	eglTerminate(display);
+}
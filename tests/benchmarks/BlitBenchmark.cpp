@@ -0,0 +1,97 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the bandwidth of unscaled blits between surfaces of the same format,
+// like framebuffer blits, texture copies and readbacks, for color, depth and
+// stencil, whole surfaces, sub-rectangles, small and vertically flipped copies.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Blitter.hpp"
+#include "Renderer/Surface.hpp"
+
+#include <stdlib.h>
+#include <string>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	const int width = 2048;
+	const int height = 2048;
+
+	struct Copy
+	{
+		Blitter *blitter;
+		Surface *source;
+		Surface *dest;
+		SliceRect sourceRect;
+		SliceRect destRect;
+		bool stencil;
+	};
+
+	void blit(void *data, int iterations)
+	{
+		Copy *copy = static_cast<Copy*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			copy->blitter->blit(copy->source, copy->sourceRect, copy->dest, copy->destRect, false, copy->stencil);
+		}
+	}
+
+	void measure(const char *name, Format format, bool stencil, const Rect &sourceRect, const Rect &destRect)
+	{
+		Copy copy;
+		copy.blitter = new Blitter();
+		copy.source = Surface::create(nullptr, width, height, 1, format, false, true);
+		copy.dest = Surface::create(nullptr, width, height, 1, format, false, true);
+		copy.sourceRect = SliceRect(sourceRect);
+		copy.destRect = SliceRect(destRect);
+		copy.stencil = stencil;
+
+		blit(&copy, 1);   // Initializes the surfaces and generates any routine
+
+		int bytes = stencil ? 1 : Surface::bytes(copy.source->getInternalFormat());
+		double size = (double)abs(destRect.x1 - destRect.x0) * abs(destRect.y1 - destRect.y0) * bytes;
+
+		std::string benchmark = std::string("Blit.") + name;
+		report(benchmark.c_str(), "bandwidth", throughput(blit, &copy) * size / 1.0e9, "GB/s");
+
+		copy.source->sync();
+		copy.dest->sync();
+		delete copy.source;
+		delete copy.dest;
+		delete copy.blitter;
+	}
+}
+
+BENCHMARK(Blit)
+{
+	const Rect whole(0, 0, width, height);
+	const Rect flipped(0, height, width, 0);
+	const Rect inner(16, 16, width - 16, height - 16);
+	const Rect offset(8, 24, width - 24, height - 8);
+	const Rect small(0, 0, 512, 512);   // Fits in the caches
+
+	measure("color", FORMAT_A8R8G8B8, false, whole, whole);
+	measure("color.flipped", FORMAT_A8R8G8B8, false, whole, flipped);
+	measure("color.subrect", FORMAT_A8R8G8B8, false, inner, offset);
+	measure("color.small", FORMAT_A8R8G8B8, false, small, small);
+	measure("float", FORMAT_A32B32G32R32F, false, whole, whole);
+	measure("depth", FORMAT_D32F, false, whole, whole);
+	measure("depth.subrect", FORMAT_D32F, false, inner, offset);
+	measure("stencil", FORMAT_D24S8, true, whole, whole);
+}
@@ -0,0 +1,106 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the bandwidth of color, depth and stencil clears and of lockable
+// surface fills, for surfaces much larger than the caches and ones which fit.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Blitter.hpp"
+#include "Renderer/Surface.hpp"
+
+#include <string>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	enum Buffer
+	{
+		COLOR,
+		DEPTH,
+		STENCIL,
+		FILL,
+	};
+
+	struct Target
+	{
+		Blitter *blitter;
+		Surface *surface;
+		Buffer buffer;
+		Rect rect;
+	};
+
+	void clearTarget(void *data, int iterations)
+	{
+		Target *clear = static_cast<Target*>(data);
+		const Rect &rect = clear->rect;
+
+		for(int i = 0; i < iterations; i++)
+		{
+			switch(clear->buffer)
+			{
+			case COLOR:
+				{
+					float color[4] = {0.25f, 0.5f, 0.75f, (i & 1) ? 1.0f : 0.0f};
+					clear->blitter->clear(color, FORMAT_A32B32G32R32F, clear->surface, SliceRect(rect), 0xF);
+				}
+				break;
+			case DEPTH:
+				clear->surface->clearDepth((i & 1) ? 1.0f : 0.5f, rect.x0, rect.y0, rect.width(), rect.height());
+				break;
+			case STENCIL:
+				clear->surface->clearStencil(i & 0xFF, 0xFF, rect.x0, rect.y0, rect.width(), rect.height());
+				break;
+			case FILL:
+				clear->surface->fill(Color<float>(0.25f, 0.5f, 0.75f, (i & 1) ? 1.0f : 0.0f), rect.x0, rect.y0, rect.width(), rect.height());
+				break;
+			}
+		}
+	}
+
+	void measure(const char *name, Format format, Buffer buffer, int width, int height)
+	{
+		Target clear;
+		clear.blitter = new Blitter();
+		clear.surface = Surface::create(nullptr, width, height, 1, format, buffer == FILL, buffer != FILL);
+		clear.buffer = buffer;
+		clear.rect = Rect(0, 0, width, height);
+
+		clearTarget(&clear, 1);   // Allocates the buffers
+
+		int bytes = (buffer == STENCIL) ? 1 : Surface::bytes(clear.surface->getInternalFormat());
+
+		std::string benchmark = std::string("Clear.") + name + "." + std::to_string(width) + "x" + std::to_string(height);
+		report(benchmark.c_str(), "bandwidth", throughput(clearTarget, &clear) * width * height * bytes / 1.0e9, "GB/s");
+
+		clear.surface->sync();
+		delete clear.surface;
+		delete clear.blitter;
+	}
+}
+
+BENCHMARK(Clear)
+{
+	const int sizes[][2] = {{256, 256}, {2048, 2048}};
+
+	for(const auto &size : sizes)
+	{
+		measure("color", FORMAT_A8R8G8B8, COLOR, size[0], size[1]);
+		measure("depth", FORMAT_D32F, DEPTH, size[0], size[1]);
+		measure("stencil", FORMAT_D24S8, STENCIL, size[0], size[1]);
+		measure("fill", FORMAT_A8R8G8B8, FILL, size[0], size[1]);
+	}
+}
@@ -0,0 +1,178 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the vertex rate of draw calls sourcing their attributes from client
+// memory, which get copied into vertex buffers on each draw. Both with the
+// attributes interleaved and with each one tightly packed in its own array.
+
+#include "Benchmark.hpp"
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+
+#include <vector>
+
+using namespace benchmark;
+
+namespace
+{
+	const int vertexCount = 65536;
+
+	struct Vertex
+	{
+		GLfloat position[3];
+		GLshort normal[4];
+		GLfloat texCoord[2];
+		GLubyte color[4];
+	};
+
+	void drawPoints(void *data, int iterations)
+	{
+		for(int i = 0; i < iterations; i++)
+		{
+			glDrawArrays(GL_POINTS, 0, vertexCount);
+			glFinish();
+		}
+	}
+
+	void measure(const char *name, bool interleaved)
+	{
+		EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		eglInitialize(display, nullptr, nullptr);
+		eglBindAPI(EGL_OPENGL_ES_API);
+
+		const EGLint configAttributes[] =
+		{
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+			EGL_NONE
+		};
+
+		EGLConfig config;
+		EGLint configCount = 0;
+		eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+		const EGLint surfaceAttributes[] = {EGL_WIDTH, 64, EGL_HEIGHT, 64, EGL_NONE};
+		EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+		const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+		EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+		eglMakeCurrent(display, surface, surface, context);
+
+		// All points end up right of the viewport, so rasterization doesn't factor in
+		const char *vertexSource =
+			"attribute vec3 position;\n"
+			"attribute vec4 normal;\n"
+			"attribute vec2 texCoord;\n"
+			"attribute vec4 color;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4(position + 0.1 * (normal.xyz + color.rgb) + vec3(texCoord, 0.0), 1.0);\n"
+			"	gl_PointSize = 1.0;\n"
+			"}\n";
+
+		const char *fragmentSource =
+			"precision mediump float;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_FragColor = vec4(1.0, 0.5, 0.0, 1.0);\n"
+			"}\n";
+
+		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertexShader, 1, &vertexSource, nullptr);
+		glCompileShader(vertexShader);
+
+		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
+		glCompileShader(fragmentShader);
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glBindAttribLocation(program, 0, "position");
+		glBindAttribLocation(program, 1, "normal");
+		glBindAttribLocation(program, 2, "texCoord");
+		glBindAttribLocation(program, 3, "color");
+		glLinkProgram(program);
+		glUseProgram(program);
+
+		std::vector<Vertex> vertices(vertexCount);
+
+		for(int i = 0; i < vertexCount; i++)
+		{
+			Vertex &vertex = vertices[i];
+			vertex.position[0] = 2.0f;
+			vertex.position[1] = (i % 256) / 128.0f - 1.0f;
+			vertex.position[2] = (i / 256) / 128.0f - 1.0f;
+			vertex.normal[0] = 0x7FFF;
+			vertex.normal[1] = vertex.normal[2] = vertex.normal[3] = 0;
+			vertex.texCoord[0] = vertex.texCoord[1] = 0.0f;
+			vertex.color[0] = vertex.color[1] = vertex.color[2] = vertex.color[3] = i & 0xFF;
+		}
+
+		// Tightly packed copies of each attribute
+		std::vector<GLfloat> positions(3 * vertexCount);
+		std::vector<GLshort> normals(4 * vertexCount);
+		std::vector<GLfloat> texCoords(2 * vertexCount);
+		std::vector<GLubyte> colors(4 * vertexCount);
+
+		for(int i = 0; i < vertexCount; i++)
+		{
+			for(int j = 0; j < 3; j++) positions[3 * i + j] = vertices[i].position[j];
+			for(int j = 0; j < 4; j++) normals[4 * i + j] = vertices[i].normal[j];
+			for(int j = 0; j < 2; j++) texCoords[2 * i + j] = vertices[i].texCoord[j];
+			for(int j = 0; j < 4; j++) colors[4 * i + j] = vertices[i].color[j];
+		}
+
+		if(interleaved)
+		{
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), vertices[0].position);
+			glVertexAttribPointer(1, 4, GL_SHORT, GL_TRUE, sizeof(Vertex), vertices[0].normal);
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), vertices[0].texCoord);
+			glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), vertices[0].color);
+		}
+		else
+		{
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, positions.data());
+			glVertexAttribPointer(1, 4, GL_SHORT, GL_TRUE, 0, normals.data());
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, texCoords.data());
+			glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, colors.data());
+		}
+
+		for(int i = 0; i < 4; i++)
+		{
+			glEnableVertexAttribArray(i);
+		}
+
+		drawPoints(nullptr, 1);   // Warm up routine caches
+
+		report(name, "vertexRate", throughput(drawPoints, nullptr) * vertexCount / 1.0e6, "Mvertices/s");
+
+		glDeleteProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(display, context);
+		eglDestroySurface(display, surface);
+		eglTerminate(display);
+	}
+}
+
+BENCHMARK(ClientArray)
+{
+	measure("ClientArray.interleaved", true);
+	measure("ClientArray.separate", false);
+}
@@ -0,0 +1,191 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the pixel rate of format conversions done on the CPU: surfaces in
+// packed and half precision float formats decoded to their internal format,
+// the internal format encoded back for readbacks, and the conversion kernels
+// used by texture uploads on their own.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Surface.hpp"
+#include "Common/Convert.hpp"
+#include "Common/Half.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	const int width = 1024;
+	const int height = 1024;
+
+	void decode(void *data, int iterations)
+	{
+		Surface *surface = static_cast<Surface*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			surface->lockExternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC);   // Makes the internal copy stale
+			surface->unlockExternal();
+			surface->lockInternal(0, 0, 0, LOCK_READONLY, PUBLIC);
+			surface->unlockInternal();
+		}
+	}
+
+	void measureDecode(const char *name, Format format)
+	{
+		Surface *surface = Surface::create(nullptr, width, height, 1, format, true, false);
+
+		unsigned char *external = static_cast<unsigned char*>(surface->lockExternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC));
+
+		for(int y = 0; y < height; y++)
+		{
+			for(int x = 0; x < surface->getExternalPitchB(); x++)
+			{
+				external[y * surface->getExternalPitchB() + x] = (unsigned char)(x * 37 + y * 11);
+			}
+		}
+
+		surface->unlockExternal();
+
+		std::string benchmark = std::string("Conversion.decode.") + name;
+		report(benchmark.c_str(), "pixelRate", throughput(decode, surface) * width * height / 1.0e6, "Mpixels/s");
+
+		delete surface;
+	}
+
+	void encode(void *data, int iterations)
+	{
+		Surface *surface = static_cast<Surface*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			surface->lockInternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC);   // Makes the external copy stale
+			surface->unlockInternal();
+			surface->lockExternal(0, 0, 0, LOCK_READONLY, PUBLIC);
+			surface->unlockExternal();
+		}
+	}
+
+	void measureEncode(const char *name, Format format)
+	{
+		Surface *surface = Surface::create(nullptr, width, height, 1, format, true, false);
+
+		float *internal = static_cast<float*>(surface->lockInternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC));
+
+		for(int i = 0; i < height * surface->getInternalPitchB() / 4; i++)
+		{
+			internal[i] = (float)(i % 1024) / 256.0f;
+		}
+
+		surface->unlockInternal();
+
+		std::string benchmark = std::string("Conversion.encode.") + name;
+		report(benchmark.c_str(), "pixelRate", throughput(encode, surface) * width * height / 1.0e6, "Mpixels/s");
+
+		delete surface;
+	}
+
+	struct Rows
+	{
+		void (*convert)(void *destination, const void *source, size_t count);
+		std::vector<unsigned char> source;
+		std::vector<unsigned char> dest;
+	};
+
+	void convertRows(void *data, int iterations)
+	{
+		Rows *rows = static_cast<Rows*>(data);
+		size_t sourcePitch = rows->source.size() / height;
+		size_t destPitch = rows->dest.size() / height;
+
+		for(int i = 0; i < iterations; i++)
+		{
+			for(int y = 0; y < height; y++)
+			{
+				rows->convert(&rows->dest[y * destPitch], &rows->source[y * sourcePitch], width);
+			}
+		}
+	}
+
+	void halfToFloat(void *destination, const void *source, size_t count)
+	{
+		sw::halfToFloat(static_cast<float*>(destination), static_cast<const unsigned short*>(source), 4 * count);
+	}
+
+	void floatToHalf(void *destination, const void *source, size_t count)
+	{
+		sw::floatToHalf(static_cast<unsigned short*>(destination), static_cast<const float*>(source), 4 * count);
+	}
+
+	void expandRGB16(void *destination, const void *source, size_t count)
+	{
+		sw::expandRGB16(destination, source, 0x3C00, count);
+	}
+
+	void measureRows(const char *name, void (*convert)(void*, const void*, size_t), int sourceBytes, int destBytes)
+	{
+		Rows rows;
+		rows.convert = convert;
+		rows.source.resize(width * height * sourceBytes);
+		rows.dest.resize(width * height * destBytes);
+
+		for(size_t i = 0; i < rows.source.size(); i++)
+		{
+			rows.source[i] = (unsigned char)(i * 37);
+		}
+
+		if(convert == floatToHalf)   // Keep the floats finite, and mostly in half range
+		{
+			for(size_t i = 3; i < rows.source.size(); i += 4)
+			{
+				rows.source[i] &= 0x47;
+			}
+		}
+
+		std::string benchmark = std::string("Conversion.") + name;
+		report(benchmark.c_str(), "pixelRate", throughput(convertRows, &rows) * width * height / 1.0e6, "Mpixels/s");
+	}
+}
+
+BENCHMARK(Conversion)
+{
+	static unsigned int palette[256];   // Stays referenced by Surface
+
+	for(int i = 0; i < 256; i++)
+	{
+		palette[i] = i * 0x01030507u;
+	}
+
+	Surface::setTexturePalette(palette);
+
+	measureDecode("R8G8B8", FORMAT_R8G8B8);
+	measureDecode("X1R5G5B5", FORMAT_X1R5G5B5);
+	measureDecode("A1R5G5B5", FORMAT_A1R5G5B5);
+	measureDecode("A4R4G4B4", FORMAT_A4R4G4B4);
+	measureDecode("P8", FORMAT_P8);
+
+	measureDecode("A16B16G16R16F", FORMAT_A16B16G16R16F);
+	measureEncode("A16B16G16R16F", FORMAT_A16B16G16R16F);
+
+	measureRows("halfToFloat", halfToFloat, 8, 16);
+	measureRows("floatToHalf", floatToHalf, 16, 8);
+	measureRows("R4G4B4A4", unpackR4G4B4A4, 2, 4);
+	measureRows("R5G5B5A1", unpackR5G5B5A1, 2, 4);
+	measureRows("RGB16", expandRGB16, 6, 8);
+}
@@ -0,0 +1,162 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the application thread's time per draw call for frames of many small
+// draws, with GL commands executed directly or recorded for a server thread.
+
+#include "Benchmark.hpp"
+
+#include "Common/Timer.hpp"
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+
+#include <stdlib.h>
+
+using namespace benchmark;
+
+namespace
+{
+	const int drawsPerFrame = 512;
+	const int frames = 32;
+
+	struct Scene
+	{
+		GLint offset;   // Uniform location
+	};
+
+	void issueDraws(const Scene *scene)
+	{
+		for(int i = 0; i < drawsPerFrame; i++)
+		{
+			glUniform4f(scene->offset, (i % 32) / 16.0f - 1.0f, (i / 32) / 8.0f - 1.0f, 0.0f, 0.0f);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		}
+	}
+
+	void drawFrames(void *data, int iterations)
+	{
+		for(int i = 0; i < iterations; i++)
+		{
+			issueDraws(static_cast<const Scene*>(data));
+			glFinish();
+		}
+	}
+
+	void measure(const char *name, bool threaded)
+	{
+		#if defined(_WIN32)
+			_putenv_s("SWIFTSHADER_THREADED_GL", threaded ? "1" : "0");
+		#else
+			setenv("SWIFTSHADER_THREADED_GL", threaded ? "1" : "0", 1);
+		#endif
+
+		EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		eglInitialize(display, nullptr, nullptr);
+		eglBindAPI(EGL_OPENGL_ES_API);
+
+		const EGLint configAttributes[] =
+		{
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+			EGL_NONE
+		};
+
+		EGLConfig config;
+		EGLint configCount = 0;
+		eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+		const EGLint surfaceAttributes[] = {EGL_WIDTH, 256, EGL_HEIGHT, 256, EGL_NONE};
+		EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+		const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+		EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+		eglMakeCurrent(display, surface, surface, context);
+
+		const char *vertexSource =
+			"attribute vec2 position;\n"
+			"uniform vec4 offset;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_Position = vec4(position * 0.05, 0.0, 1.0) + offset;\n"
+			"}\n";
+
+		const char *fragmentSource =
+			"precision mediump float;\n"
+			"void main()\n"
+			"{\n"
+			"	gl_FragColor = vec4(1.0, 0.5, 0.0, 1.0);\n"
+			"}\n";
+
+		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertexShader, 1, &vertexSource, nullptr);
+		glCompileShader(vertexShader);
+
+		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
+		glCompileShader(fragmentShader);
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glBindAttribLocation(program, 0, "position");
+		glLinkProgram(program);
+		glUseProgram(program);
+
+		const GLfloat triangle[] = {-1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 1.0f};
+
+		GLuint buffer;
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(triangle), triangle, GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glEnableVertexAttribArray(0);
+
+		Scene scene;
+		scene.offset = glGetUniformLocation(program, "offset");
+
+		drawFrames(&scene, 1);   // Warm up routine caches
+
+		double appTime = 0.0;
+
+		for(int frame = 0; frame < frames; frame++)
+		{
+			double start = sw::Timer::seconds();
+			issueDraws(&scene);
+			appTime += sw::Timer::seconds() - start;
+
+			glFinish();   // Not part of the application thread's issue time
+		}
+
+		report(name, "appTime", 1.0e6 * appTime / (frames * drawsPerFrame), "us/draw");
+		report(name, "rate", throughput(drawFrames, &scene) * drawsPerFrame, "draws/s");
+
+		glDeleteBuffers(1, &buffer);
+		glDeleteProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(display, context);
+		eglDestroySurface(display, surface);
+		eglTerminate(display);
+	}
+}
+
+BENCHMARK(Dispatch)
+{
+	measure("Dispatch.direct", false);
+	measure("Dispatch.threaded", true);
+}
@@ -0,0 +1,82 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the rate at which ETC1, ETC2 and EAC compressed textures get decoded
+// to their internal format, in megabytes of compressed data per second. Small
+// images are decoded on a single thread, large ones get split across threads.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Surface.hpp"
+
+#include <string>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	void decode(void *data, int iterations)
+	{
+		Surface *surface = static_cast<Surface*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			surface->lockExternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC);   // Makes the internal copy stale
+			surface->unlockExternal();
+			surface->lockInternal(0, 0, 0, LOCK_READONLY, PUBLIC);
+			surface->unlockInternal();
+		}
+	}
+
+	void measure(const char *name, Format format, int size)
+	{
+		Surface *surface = Surface::create(nullptr, size, size, 1, format, true, false);
+
+		// Pseudo-random blocks exercise all of the ETC2 modes
+		unsigned char *external = static_cast<unsigned char*>(surface->lockExternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC));
+		unsigned int bytes = Surface::size(size, size, 1, format);
+		unsigned int seed = 1;
+
+		for(unsigned int i = 0; i < bytes; i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			external[i] = (unsigned char)(seed >> 16);
+		}
+
+		surface->unlockExternal();
+
+		std::string benchmark = std::string("ETCDecode.") + name + "." + std::to_string(size) + "x" + std::to_string(size);
+		report(benchmark.c_str(), "bandwidth", throughput(decode, surface) * bytes / 1.0e6, "MB/s");
+
+		delete surface;
+	}
+}
+
+BENCHMARK(ETCDecode)
+{
+	const int sizes[] = {256, 2048};
+
+	for(int size : sizes)
+	{
+		measure("ETC1", FORMAT_ETC1, size);
+		measure("RGB8_ETC2", FORMAT_RGB8_ETC2, size);
+		measure("SRGB8_ETC2", FORMAT_SRGB8_ETC2, size);
+		measure("RGB8_PUNCHTHROUGH_ALPHA1_ETC2", FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, size);
+		measure("RGBA8_ETC2_EAC", FORMAT_RGBA8_ETC2_EAC, size);
+		measure("R11_EAC", FORMAT_R11_EAC, size);
+		measure("SIGNED_R11_EAC", FORMAT_SIGNED_R11_EAC, size);
+		measure("RG11_EAC", FORMAT_RG11_EAC, size);
+	}
+}
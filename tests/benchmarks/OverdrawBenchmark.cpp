@@ -0,0 +1,139 @@
+// Copyright 2017 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures depth-tested fill rate on a stack of full-screen quads, drawn either
+// front to back (mostly occluded) or back to front (every layer visible).
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Context.hpp"
+#include "Renderer/Surface.hpp"
+#include "Renderer/Matrix.hpp"
+#include "Common/Resource.hpp"
+
+using namespace sw;
+using namespace benchmark;
+
+namespace sw
+{
+	extern bool hierarchicalDepthCulling;
+}
+
+namespace
+{
+	const int width = 1024;
+	const int height = 1024;
+	const int layers = 16;
+
+	struct Overdraw
+	{
+		Context *context;
+		Renderer *renderer;
+		Surface *colorBuffer;
+		Surface *depthBuffer;
+		Resource *vertexBuffer;
+	};
+
+	void drawLayers(void *data, int iterations)
+	{
+		Overdraw *overdraw = static_cast<Overdraw*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			overdraw->depthBuffer->clearDepth(1.0f, 0, 0, width, height);
+			overdraw->renderer->draw(DRAW_TRIANGLELIST, 0, 2 * layers);
+			overdraw->renderer->synchronize();
+		}
+	}
+
+	void measure(const char *name, bool frontToBack)
+	{
+		Overdraw overdraw;
+
+		// A fresh renderer for each run, so no routines are shared between them
+		overdraw.context = new Context();
+		overdraw.renderer = new Renderer(overdraw.context, OpenGL, true);
+		overdraw.colorBuffer = Surface::create(nullptr, width, height, 1, FORMAT_A8R8G8B8, false, true);
+		overdraw.depthBuffer = Surface::create(nullptr, width, height, 1, FORMAT_D24S8, false, true);
+		overdraw.vertexBuffer = new Resource(layers * 6 * 4 * sizeof(float));
+
+		float *vertex = static_cast<float*>(overdraw.vertexBuffer->lock(PUBLIC));
+
+		for(int layer = 0; layer < layers; layer++)
+		{
+			float z = (frontToBack ? layer + 1 : layers - layer) / (layers + 1.0f);
+			const float corners[6][2] = {{-1, -1}, {1, -1}, {-1, 1}, {-1, 1}, {1, -1}, {1, 1}};
+
+			for(int i = 0; i < 6; i++)
+			{
+				*vertex++ = corners[i][0];
+				*vertex++ = corners[i][1];
+				*vertex++ = z;
+				*vertex++ = 1.0f;
+			}
+		}
+
+		overdraw.vertexBuffer->unlock();
+
+		Renderer *renderer = overdraw.renderer;
+
+		renderer->setRenderTarget(0, overdraw.colorBuffer);
+		renderer->setDepthBuffer(overdraw.depthBuffer);
+		renderer->setInputStream(Position, Stream(overdraw.vertexBuffer, overdraw.vertexBuffer->data(), 4 * sizeof(float)).define(STREAMTYPE_FLOAT, 4));
+		renderer->setIndexBuffer(nullptr);
+		renderer->setLightingEnable(false);
+		renderer->setStageOperation(0, TextureStage::STAGE_SELECTARG1);
+		renderer->setFirstArgument(0, TextureStage::SOURCE_DIFFUSE);
+		renderer->setProjectionMatrix(Matrix(1));
+		renderer->setCullMode(CULL_NONE);
+		renderer->setDepthBufferEnable(true);
+		renderer->setDepthCompare(DEPTH_LESS);
+		renderer->setDepthWriteEnable(true);
+
+		Viewport viewport = {0, 0, width, height, 0.0f, 1.0f};
+		renderer->setViewport(viewport);
+		renderer->setScissor(Rect(0, 0, width, height));
+
+		double framesPerSecond = throughput(drawLayers, &overdraw);
+		report(name, "fillRate", framesPerSecond * layers * width * height / 1.0e6, "Mpixels/s");
+
+		delete overdraw.renderer;
+		delete overdraw.context;
+
+		overdraw.colorBuffer->sync();
+		overdraw.depthBuffer->sync();
+		delete overdraw.colorBuffer;
+		delete overdraw.depthBuffer;
+		overdraw.vertexBuffer->destruct();
+	}
+}
+
+BENCHMARK(OverdrawFrontToBack)
+{
+	hierarchicalDepthCulling = false;
+	measure("OverdrawFrontToBack.perQuadDepth", true);
+
+	hierarchicalDepthCulling = true;
+	measure("OverdrawFrontToBack.hierarchicalDepth", true);
+}
+
+BENCHMARK(OverdrawBackToFront)
+{
+	hierarchicalDepthCulling = false;
+	measure("OverdrawBackToFront.perQuadDepth", false);
+
+	hierarchicalDepthCulling = true;
+	measure("OverdrawBackToFront.hierarchicalDepth", false);
+}
@@ -0,0 +1,114 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the bandwidth of presenting full frames, copying the render target
+// into a back buffer in memory, with and without a format conversion.
+
+#include "Benchmark.hpp"
+
+#include "Main/FrameBuffer.hpp"
+#include "Renderer/Surface.hpp"
+#include "Common/Memory.hpp"
+
+#include <string.h>
+#include <string>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	const int frameWidth = 1920;
+	const int frameHeight = 1080;
+
+	class MemoryFrameBuffer : public FrameBuffer
+	{
+	public:
+		MemoryFrameBuffer() : FrameBuffer(frameWidth, frameHeight, false, false)
+		{
+			stride = width * 4;
+			buffer = allocate(stride * height);
+		}
+
+		~MemoryFrameBuffer() override
+		{
+			deallocate(buffer);
+		}
+
+		void flip(void *source, Format sourceFormat, size_t sourceStride) override
+		{
+			copy(source, sourceFormat, sourceStride);
+		}
+
+		void blit(void *source, const Rect *sourceRect, const Rect *destRect, Format sourceFormat, size_t sourceStride) override
+		{
+			copy(source, sourceFormat, sourceStride);
+		}
+
+		void *lock() override
+		{
+			locked = buffer;
+
+			return locked;
+		}
+
+		void unlock() override
+		{
+			locked = nullptr;
+		}
+
+	private:
+		void *buffer;
+	};
+
+	struct Frame
+	{
+		FrameBuffer *frameBuffer;
+		void *source;
+		Format format;
+	};
+
+	void present(void *data, int iterations)
+	{
+		Frame *present = static_cast<Frame*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			present->frameBuffer->flip(present->source, present->format, frameWidth * 4);
+		}
+	}
+
+	void measure(const char *name, Format format)
+	{
+		Frame frame;
+		frame.frameBuffer = new MemoryFrameBuffer();
+		frame.source = allocate(frameWidth * frameHeight * 4);
+		frame.format = format;
+
+		memset(frame.source, 0x80, frameWidth * frameHeight * 4);
+		present(&frame, 1);   // Generates the copy routine
+
+		std::string benchmark = std::string("Present.") + name;
+		report(benchmark.c_str(), "bandwidth", throughput(present, &frame) * frameWidth * frameHeight * 4 / 1.0e9, "GB/s");
+
+		delete frame.frameBuffer;
+		deallocate(frame.source);
+	}
+}
+
+BENCHMARK(Present)
+{
+	measure("copy", FORMAT_X8R8G8B8);
+	measure("swizzle", FORMAT_A8B8G8R8);
+}
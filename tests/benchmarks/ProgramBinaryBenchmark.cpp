@@ -0,0 +1,158 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures application startup cost of creating programs, either compiled and
+// linked from GLSL source or restored with glProgramBinary.
+
+#include "Benchmark.hpp"
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+
+#include <vector>
+
+using namespace benchmark;
+
+namespace
+{
+	const char *vertexSource =
+		"#version 300 es\n"
+		"uniform mat4 modelViewProjection;\n"
+		"uniform mat3 normalMatrix;\n"
+		"in vec4 position;\n"
+		"in vec3 normal;\n"
+		"in vec2 texCoord;\n"
+		"out vec3 viewNormal;\n"
+		"out vec2 uv;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = modelViewProjection * position;\n"
+		"	viewNormal = normalMatrix * normal;\n"
+		"	uv = texCoord;\n"
+		"}\n";
+
+	const char *fragmentSource =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D diffuse;\n"
+		"uniform vec3 lightDirection[4];\n"
+		"uniform vec3 lightColor[4];\n"
+		"in vec3 viewNormal;\n"
+		"in vec2 uv;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	vec3 n = normalize(viewNormal);\n"
+		"	vec3 light = vec3(0.1);\n"
+		"	for(int i = 0; i < 4; i++)\n"
+		"	{\n"
+		"		light += lightColor[i] * max(dot(n, lightDirection[i]), 0.0);\n"
+		"	}\n"
+		"	fragColor = texture(diffuse, uv) * vec4(light, 1.0);\n"
+		"}\n";
+
+	GLuint compileShader(GLenum type, const char *source)
+	{
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		return shader;
+	}
+
+	GLuint linkFromSource()
+	{
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+		GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		return program;
+	}
+
+	struct Binary
+	{
+		GLenum format;
+		std::vector<unsigned char> data;
+	};
+
+	void createFromSource(void *data, int iterations)
+	{
+		for(int i = 0; i < iterations; i++)
+		{
+			glDeleteProgram(linkFromSource());
+		}
+	}
+
+	void createFromBinary(void *data, int iterations)
+	{
+		const Binary *binary = static_cast<const Binary*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			GLuint program = glCreateProgram();
+			glProgramBinary(program, binary->format, binary->data.data(), static_cast<GLsizei>(binary->data.size()));
+			glDeleteProgram(program);
+		}
+	}
+}
+
+BENCHMARK(ProgramBinary)
+{
+	EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	eglInitialize(display, nullptr, nullptr);
+	eglBindAPI(EGL_OPENGL_ES_API);
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+	const EGLint surfaceAttributes[] = {EGL_WIDTH, 64, EGL_HEIGHT, 64, EGL_NONE};
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+	const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	eglMakeCurrent(display, surface, surface, context);
+
+	Binary binary;
+	GLuint program = linkFromSource();
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	binary.data.resize(length);
+	glGetProgramBinary(program, length, nullptr, &binary.format, binary.data.data());
+	glDeleteProgram(program);
+
+	report("ProgramBinary", "binarySize", length, "bytes");
+	report("ProgramBinary.fromSource", "rate", throughput(createFromSource, nullptr), "programs/s");
+	report("ProgramBinary.fromBinary", "rate", throughput(createFromBinary, &binary), "programs/s");
+
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(display, context);
+	eglDestroySurface(display, surface);
+	eglTerminate(display);
+}
@@ -0,0 +1,247 @@
+// Copyright 2017 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the JIT itself: compile time and generated code size of Reactor
+// programs modeled after SwiftShader's hot routines, and the throughput of the
+// resulting code. Build with REACTOR_BACKEND set to LLVM or Subzero to compare.
+
+#include "Benchmark.hpp"
+
+#include "Reactor/Reactor.hpp"
+#include "Common/Timer.hpp"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	// All benchmarked routines share the signature (constants, input, output, count)
+	typedef void (*Callable)(const void *constants, const void *input, void *output, int count);
+	typedef Function<Void(Pointer<Byte>, Pointer<Byte>, Pointer<Byte>, Int)> ReactorFunction;
+
+	const int compileIterations = 10;
+	const int elementCount = 4096;   // Pixels or vertices processed per call
+
+	// Bilinear filtering of a 256x256 texture with 16-bit channels, like SamplerCore's
+	// integer filtering path. Coordinates are normalized (u, v, -, -) float quadruplets.
+	Routine *bilinearFilter()
+	{
+		ReactorFunction function;
+		{
+			Pointer<Byte> texture = function.Arg<0>();
+			Pointer<Byte> coordinates = function.Arg<1>();
+			Pointer<Byte> output = function.Arg<2>();
+			Int count = function.Arg<3>();
+
+			For(Int i = 0, i < count, i++)
+			{
+				Float4 uv = *Pointer<Float4>(coordinates + i * 16);
+				Int4 fixed = RoundInt(uv * Float4(255.0f * 0x10000));
+				Int u = Extract(fixed, 0);
+				Int v = Extract(fixed, 1);
+
+				Pointer<Byte> texel = texture + ((v >> 16) * 256 + (u >> 16)) * 8;
+				UShort4 fu = UShort4(Short4(u & 0xFFFF));
+				UShort4 fv = UShort4(Short4(v & 0xFFFF));
+
+				UShort4 c00 = *Pointer<UShort4>(texel + 0);
+				UShort4 c10 = *Pointer<UShort4>(texel + 8);
+				UShort4 c01 = *Pointer<UShort4>(texel + 256 * 8);
+				UShort4 c11 = *Pointer<UShort4>(texel + 257 * 8);
+
+				UShort4 c0 = MulHigh(c00, ~fu) + MulHigh(c10, fu);
+				UShort4 c1 = MulHigh(c01, ~fu) + MulHigh(c11, fu);
+				UShort4 c = MulHigh(c0, ~fv) + MulHigh(c1, fv);
+
+				*Pointer<UShort4>(output + i * 8) = c;
+			}
+
+			Return();
+		}
+
+		return function(L"BilinearFilter");
+	}
+
+	// Source-alpha blending of 16-bit colors onto an RGBA8 target, like PixelRoutine's
+	// alphaBlend for 8-bit render targets. Processes two pixels per iteration.
+	Routine *alphaBlend()
+	{
+		ReactorFunction function;
+		{
+			Pointer<Byte> source = function.Arg<1>();
+			Pointer<Byte> target = function.Arg<2>();
+			Int count = function.Arg<3>();
+
+			For(Int i = 0, i < count, i += 2)
+			{
+				UShort4 s0 = *Pointer<UShort4>(source + i * 8 + 0);
+				UShort4 s1 = *Pointer<UShort4>(source + i * 8 + 8);
+				Byte8 d = *Pointer<Byte8>(target + i * 4);
+
+				UShort4 d0 = UShort4(UnpackLow(d, d));
+				UShort4 d1 = UShort4(UnpackHigh(d, d));
+
+				UShort4 a0 = UShort4(Swizzle(Short4(s0), 0xFF));
+				UShort4 a1 = UShort4(Swizzle(Short4(s1), 0xFF));
+
+				UShort4 c0 = MulHigh(s0, a0) + MulHigh(d0, ~a0);
+				UShort4 c1 = MulHigh(s1, a1) + MulHigh(d1, ~a1);
+
+				*Pointer<Byte8>(target + i * 4) = Pack(c0 >> 8, c1 >> 8);
+			}
+
+			Return();
+		}
+
+		return function(L"AlphaBlend");
+	}
+
+	// Transformation of positions by a 4x4 matrix followed by the perspective divide,
+	// like VertexProgram's position output and VertexRoutine's postTransform.
+	Routine *vertexTransform()
+	{
+		ReactorFunction function;
+		{
+			Pointer<Byte> matrix = function.Arg<0>();
+			Pointer<Byte> input = function.Arg<1>();
+			Pointer<Byte> output = function.Arg<2>();
+			Int count = function.Arg<3>();
+
+			Float4 m0 = *Pointer<Float4>(matrix + 0);
+			Float4 m1 = *Pointer<Float4>(matrix + 16);
+			Float4 m2 = *Pointer<Float4>(matrix + 32);
+			Float4 m3 = *Pointer<Float4>(matrix + 48);
+
+			For(Int i = 0, i < count, i++)
+			{
+				Float4 v = *Pointer<Float4>(input + i * 16);
+				Float4 p = m0 * v.xxxx + m1 * v.yyyy + m2 * v.zzzz + m3 * v.wwww;
+				Float4 rhw = Float4(1.0f) / p.wwww;
+
+				*Pointer<Float4>(output + i * 16) = p * rhw;
+			}
+
+			Return();
+		}
+
+		return function(L"VertexTransform");
+	}
+
+	struct Workload
+	{
+		Callable callable;
+		const void *constants;
+		const void *input;
+		void *output;
+	};
+
+	void execute(void *data, int iterations)
+	{
+		Workload *workload = static_cast<Workload*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			workload->callable(workload->constants, workload->input, workload->output, elementCount);
+		}
+	}
+
+	// Reports compile time, code size and throughput of the routine produced by build().
+	void measure(const char *name, Routine *(*build)(), const void *constants, const void *input, void *output)
+	{
+		Routine *routine = nullptr;
+		double compileTime = 0.0;
+
+		for(int i = 0; i < compileIterations; i++)
+		{
+			delete routine;
+
+			double start = Timer::seconds();
+			routine = build();
+			routine->getEntry();   // Subzero loads the image lazily
+			compileTime += Timer::seconds() - start;
+		}
+
+		report(name, "compile", 1000.0 * compileTime / compileIterations, "ms");
+		report(name, "codeSize", routine->getCodeSize(), "bytes");
+
+		Workload workload = {(Callable)routine->getEntry(), constants, input, output};
+		double callsPerSecond = throughput(execute, &workload);
+		report(name, "throughput", callsPerSecond * elementCount / 1.0e6, "M/s");
+
+		delete routine;
+	}
+
+	float random(float range)
+	{
+		return range * (float)(rand() % 0x8000) / 0x8000;
+	}
+}
+
+BENCHMARK(ReactorBilinearFilter)
+{
+	std::vector<uint16_t> texture(257 * 257 * 4);   // Padded for the bottom-right neighbors
+	std::vector<float> coordinates(elementCount * 4);
+	std::vector<uint16_t> output(elementCount * 4);
+
+	for(size_t i = 0; i < texture.size(); i++)
+	{
+		texture[i] = (uint16_t)(i * 0x9E37);
+	}
+
+	for(int i = 0; i < elementCount; i++)
+	{
+		coordinates[i * 4 + 0] = random(1.0f);
+		coordinates[i * 4 + 1] = random(1.0f);
+	}
+
+	measure("ReactorBilinearFilter", bilinearFilter, texture.data(), coordinates.data(), output.data());
+}
+
+BENCHMARK(ReactorAlphaBlend)
+{
+	std::vector<uint16_t> source(elementCount * 4);
+	std::vector<uint8_t> target(elementCount * 4);
+
+	for(size_t i = 0; i < source.size(); i++)
+	{
+		source[i] = (uint16_t)(i * 0x9E37);
+	}
+
+	measure("ReactorAlphaBlend", alphaBlend, nullptr, source.data(), target.data());
+}
+
+BENCHMARK(ReactorVertexTransform)
+{
+	const float matrix[16] = {1.2f, 0.0f, 0.0f, 0.0f,
+	                          0.0f, 2.4f, 0.0f, 0.0f,
+	                          0.0f, 0.0f, -1.0f, -1.0f,
+	                          0.1f, 0.2f, -0.2f, 0.0f};
+
+	std::vector<float> input(elementCount * 4);
+	std::vector<float> output(elementCount * 4);
+
+	for(int i = 0; i < elementCount; i++)
+	{
+		input[i * 4 + 0] = random(2.0f) - 1.0f;
+		input[i * 4 + 1] = random(2.0f) - 1.0f;
+		input[i * 4 + 2] = random(2.0f) + 1.0f;
+		input[i * 4 + 3] = 1.0f;
+	}
+
+	measure("ReactorVertexTransform", vertexTransform, matrix, input.data(), output.data());
+}
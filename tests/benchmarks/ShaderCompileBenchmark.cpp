@@ -0,0 +1,200 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures GLSL compilation rate over a corpus of generated shaders, either
+// with sources never seen before or with sources which were compiled earlier.
+
+#include "Benchmark.hpp"
+
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+
+#include <string>
+#include <vector>
+
+using namespace benchmark;
+
+namespace
+{
+	const int corpusSize = 64;
+
+	struct Source
+	{
+		GLenum type;
+		std::string text;
+	};
+
+	std::string vertexSource(int variant)
+	{
+		int bones = 1 + variant % 4;
+
+		std::string source =
+			"#version 300 es\n"
+			"uniform mat4 viewProjection;\n"
+			"uniform mat4 bones[" + std::to_string(bones * 4) + "];\n"
+			"in vec4 position;\n"
+			"in vec3 normal;\n"
+			"in vec2 texCoord;\n"
+			"in vec4 weights;\n"
+			"out vec3 worldNormal;\n"
+			"out vec2 uv;\n"
+			"void main()\n"
+			"{\n"
+			"	mat4 skin = mat4(0.0);\n";
+
+		for(int i = 0; i < bones; i++)
+		{
+			std::string index = std::to_string(i);
+			source += "	skin += bones[" + index + "] * weights[" + std::to_string(i % 4) + "];\n";
+		}
+
+		source +=
+			"	gl_Position = viewProjection * skin * position;\n"
+			"	worldNormal = normalize(mat3(skin) * normal);\n"
+			"	uv = texCoord * " + std::to_string(variant + 1) + ".0;\n"
+			"}\n";
+
+		return source;
+	}
+
+	std::string fragmentSource(int variant)
+	{
+		int lights = 1 + variant % 8;
+
+		std::string source =
+			"#version 300 es\n"
+			"precision mediump float;\n"
+			"uniform sampler2D diffuse;\n"
+			"uniform sampler2D detail;\n"
+			"uniform vec3 lightDirection[" + std::to_string(lights) + "];\n"
+			"uniform vec3 lightColor[" + std::to_string(lights) + "];\n"
+			"in vec3 worldNormal;\n"
+			"in vec2 uv;\n"
+			"out vec4 fragColor;\n"
+			"float lambert(vec3 n, vec3 l)\n"
+			"{\n"
+			"	return max(dot(n, l), 0.0);\n"
+			"}\n"
+			"void main()\n"
+			"{\n"
+			"	vec3 n = normalize(worldNormal);\n"
+			"	vec3 light = vec3(0.1);\n"
+			"	for(int i = 0; i < " + std::to_string(lights) + "; i++)\n"
+			"	{\n"
+			"		light += lightColor[i] * lambert(n, lightDirection[i]);\n"
+			"	}\n"
+			"	vec4 color = texture(diffuse, uv);\n";
+
+		if(variant % 2)
+		{
+			source += "	color.rgb *= texture(detail, uv * 8.0).rgb * 2.0;\n";
+		}
+
+		if(variant % 3 == 0)
+		{
+			source += "	color.rgb = pow(color.rgb, vec3(1.0 / 2.2));\n";
+		}
+
+		source +=
+			"	fragColor = color * vec4(light, 1.0);\n"
+			"}\n";
+
+		return source;
+	}
+
+	void compile(const std::vector<Source> &corpus, const std::string &suffix)
+	{
+		std::vector<GLuint> shaders;
+
+		for(const Source &source : corpus)
+		{
+			std::string text = source.text + suffix;
+			const char *string = text.c_str();
+
+			GLuint shader = glCreateShader(source.type);
+			glShaderSource(shader, 1, &string, nullptr);
+			glCompileShader(shader);
+			shaders.push_back(shader);
+		}
+
+		// Like applications loading many shaders, only check the results after issuing all compiles
+		for(GLuint shader : shaders)
+		{
+			GLint compiled = GL_FALSE;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+			glDeleteShader(shader);
+		}
+	}
+
+	void compileUnique(void *data, int iterations)
+	{
+		static int variant = 0;
+
+		for(int i = 0; i < iterations; i++)
+		{
+			// A trailing comment makes the sources differ from all earlier ones
+			compile(*static_cast<const std::vector<Source>*>(data), "// " + std::to_string(variant++) + "\n");
+		}
+	}
+
+	void compileRepeated(void *data, int iterations)
+	{
+		for(int i = 0; i < iterations; i++)
+		{
+			compile(*static_cast<const std::vector<Source>*>(data), "");
+		}
+	}
+}
+
+BENCHMARK(ShaderCompile)
+{
+	EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	eglInitialize(display, nullptr, nullptr);
+	eglBindAPI(EGL_OPENGL_ES_API);
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+
+	const EGLint surfaceAttributes[] = {EGL_WIDTH, 64, EGL_HEIGHT, 64, EGL_NONE};
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+	const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	eglMakeCurrent(display, surface, surface, context);
+
+	std::vector<Source> corpus;
+
+	for(int i = 0; i < corpusSize / 2; i++)
+	{
+		corpus.push_back({GL_VERTEX_SHADER, vertexSource(i)});
+		corpus.push_back({GL_FRAGMENT_SHADER, fragmentSource(i)});
+	}
+
+	report("ShaderCompile.unique", "rate", throughput(compileUnique, &corpus) * corpusSize, "shaders/s");
+	report("ShaderCompile.repeated", "rate", throughput(compileRepeated, &corpus) * corpusSize, "shaders/s");
+
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext(display, context);
+	eglDestroySurface(display, surface);
+	eglTerminate(display);
+}
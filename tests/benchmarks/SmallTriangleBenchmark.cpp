@@ -0,0 +1,168 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the triangle rate of drawing a grid of small triangles covering the
+// render target, for several triangle sizes, where setup and rasterization
+// rather than pixel shading dominate. Also when they're all back-facing and
+// culled.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Context.hpp"
+#include "Renderer/Surface.hpp"
+#include "Shader/PixelShader.hpp"
+#include "Shader/VertexShader.hpp"
+#include "Common/Resource.hpp"
+
+#include <string>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	const int width = 1024;
+	const int height = 1024;
+
+	struct Scene
+	{
+		Renderer *renderer;
+		int triangles;
+	};
+
+	void append(Shader *shader, Shader::Opcode opcode, Shader::ParameterType dstType, unsigned int dstIndex, Shader::ParameterType srcType, unsigned int srcIndex)
+	{
+		Shader::Instruction *instruction = new Shader::Instruction(opcode);
+		instruction->dst.type = dstType;
+		instruction->dst.index = dstIndex;
+		instruction->src[0].type = srcType;
+		instruction->src[0].index = srcIndex;
+		instruction->src[0].swizzle = 0xE4;
+
+		shader->append(instruction);
+	}
+
+	PixelShader *createPixelShader()
+	{
+		PixelShader shader;
+
+		append(&shader, Shader::OPCODE_MOV, Shader::PARAMETER_COLOROUT, 0, Shader::PARAMETER_CONST, 0);
+
+		return new PixelShader(&shader);   // Optimized and analyzed copy
+	}
+
+	VertexShader *createVertexShader()
+	{
+		VertexShader shader;
+
+		append(&shader, Shader::OPCODE_MOV, Shader::PARAMETER_OUTPUT, 0, Shader::PARAMETER_INPUT, 0);
+		shader.setInput(0, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setOutput(0, 4, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setPositionRegister(0);
+
+		return new VertexShader(&shader);
+	}
+
+	void drawGrid(void *data, int iterations)
+	{
+		Scene *scene = static_cast<Scene*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			scene->renderer->draw(DRAW_TRIANGLELIST, 0, scene->triangles);
+			scene->renderer->synchronize();
+		}
+	}
+
+	void measure(int cellSize, bool culled)
+	{
+		Context *context = new Context();
+		Renderer *renderer = new Renderer(context, OpenGL, true);
+		Surface *colorBuffer = Surface::create(nullptr, width, height, 1, FORMAT_A8R8G8B8, false, true);
+
+		// Two triangles per square cell, slightly inset so they don't share edges
+		const int columns = width / cellSize;
+		const int rows = height / cellSize;
+		const int triangles = 2 * columns * rows;
+		Resource *vertexBuffer = new Resource(3 * triangles * 4 * sizeof(float));
+		float *vertex = static_cast<float*>(vertexBuffer->lock(PUBLIC));
+
+		for(int row = 0; row < rows; row++)
+		{
+			for(int column = 0; column < columns; column++)
+			{
+				float x0 = (column * cellSize + 0.3f) * 2.0f / width - 1.0f;
+				float y0 = (row * cellSize + 0.3f) * 2.0f / height - 1.0f;
+				float x1 = ((column + 1) * cellSize - 0.3f) * 2.0f / width - 1.0f;
+				float y1 = ((row + 1) * cellSize - 0.3f) * 2.0f / height - 1.0f;
+
+				const float corners[6][2] = {{x0, y0}, {x1, y0}, {x0, y1}, {x0, y1}, {x1, y0}, {x1, y1}};
+
+				for(int i = 0; i < 6; i++)
+				{
+					*vertex++ = corners[i][0];
+					*vertex++ = corners[i][1];
+					*vertex++ = 0.0f;
+					*vertex++ = 1.0f;
+				}
+			}
+		}
+
+		vertexBuffer->unlock();
+
+		PixelShader *pixelShader = createPixelShader();
+		VertexShader *vertexShader = createVertexShader();
+
+		renderer->setRenderTarget(0, colorBuffer);
+		renderer->setInputStream(0, Stream(vertexBuffer, vertexBuffer->data(), 4 * sizeof(float)).define(STREAMTYPE_FLOAT, 4));
+		renderer->setIndexBuffer(nullptr);
+		renderer->setPixelShader(pixelShader);
+		renderer->setVertexShader(vertexShader);
+		renderer->setCullMode(culled ? CULL_CLOCKWISE : CULL_NONE);
+		renderer->setDepthBufferEnable(false);
+
+		const float color[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+		renderer->setPixelShaderConstantF(0, color);
+
+		Viewport viewport = {0, 0, width, height, 0.0f, 1.0f};
+		renderer->setViewport(viewport);
+		renderer->setScissor(Rect(0, 0, width, height));
+
+		Scene scene = {renderer, triangles};
+		std::string name = "SmallTriangle." + std::to_string(cellSize) + "x" + std::to_string(cellSize) + (culled ? ".culled" : "");
+		report(name.c_str(), "triangleRate", throughput(drawGrid, &scene) * triangles / 1.0e6, "Mtriangles/s");
+
+		delete renderer;
+		delete context;
+		delete pixelShader;
+		delete vertexShader;
+
+		colorBuffer->sync();
+		delete colorBuffer;
+		vertexBuffer->destruct();
+	}
+}
+
+BENCHMARK(SmallTriangle)
+{
+	const int cellSizes[] = {2, 4, 16, 64};
+
+	for(int cellSize : cellSizes)
+	{
+		measure(cellSize, false);
+	}
+
+	measure(4, true);
+}
@@ -0,0 +1,217 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the fill rate of a pixel shader which branches on a uniform and
+// loops a uniform number of times, with generic routines, routines specialized
+// on the uniform values, and values which change on every draw.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Context.hpp"
+#include "Renderer/Surface.hpp"
+#include "Shader/PixelShader.hpp"
+#include "Shader/VertexShader.hpp"
+#include "Common/Resource.hpp"
+
+#include <string.h>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace sw
+{
+	extern bool uniformSpecialization;
+}
+
+namespace
+{
+	const int width = 1024;
+	const int height = 1024;
+	const int layers = 4;
+
+	struct Scene
+	{
+		Context *context;
+		Renderer *renderer;
+		Surface *colorBuffer;
+		Resource *vertexBuffer;
+		bool churn;   // Change the branch condition on every draw
+	};
+
+	Shader::DestinationParameter destination(Shader::ParameterType type, unsigned int index)
+	{
+		Shader::DestinationParameter dst;
+		dst.type = type;
+		dst.index = index;
+
+		return dst;
+	}
+
+	Shader::SourceParameter source(Shader::ParameterType type, unsigned int index, unsigned int swizzle = 0xE4)
+	{
+		Shader::SourceParameter src;
+		src.type = type;
+		src.index = index;
+		src.swizzle = swizzle;
+
+		return src;
+	}
+
+	void append(Shader *shader, Shader::Opcode opcode, const Shader::DestinationParameter &dst = Shader::DestinationParameter(),
+	            const Shader::SourceParameter &src0 = Shader::SourceParameter(), const Shader::SourceParameter &src1 = Shader::SourceParameter(),
+	            const Shader::SourceParameter &src2 = Shader::SourceParameter())
+	{
+		Shader::Instruction *instruction = new Shader::Instruction(opcode);
+		instruction->dst = dst;
+		instruction->src[0] = src0;
+		instruction->src[1] = src1;
+		instruction->src[2] = src2;
+
+		shader->append(instruction);
+	}
+
+	// Like compiled GLSL: a conditional on a boolean uniform, then a loop on an integer uniform
+	PixelShader *createPixelShader()
+	{
+		PixelShader shader;
+
+		Shader::DestinationParameter r0 = destination(Shader::PARAMETER_TEMP, 0);
+		Shader::SourceParameter s0 = source(Shader::PARAMETER_TEMP, 0);
+		Shader::SourceParameter c1 = source(Shader::PARAMETER_CONST, 1);
+		Shader::SourceParameter c2 = source(Shader::PARAMETER_CONST, 2);
+
+		append(&shader, Shader::OPCODE_MOV, r0, source(Shader::PARAMETER_CONST, 0));
+		append(&shader, Shader::OPCODE_IF, Shader::DestinationParameter(), source(Shader::PARAMETER_CONST, 3, 0x00));
+
+		for(int i = 0; i < 8; i++)
+		{
+			append(&shader, Shader::OPCODE_MAD, r0, s0, c1, c2);
+		}
+
+		append(&shader, Shader::OPCODE_ELSE);
+
+		for(int i = 0; i < 8; i++)
+		{
+			append(&shader, Shader::OPCODE_MAD, r0, s0, c2, c1);
+		}
+
+		append(&shader, Shader::OPCODE_ENDIF);
+		append(&shader, Shader::OPCODE_REP, Shader::DestinationParameter(), source(Shader::PARAMETER_CONSTINT, 0));
+		append(&shader, Shader::OPCODE_MAD, r0, s0, c1, c2);
+		append(&shader, Shader::OPCODE_ENDREP);
+		append(&shader, Shader::OPCODE_MOV, destination(Shader::PARAMETER_COLOROUT, 0), s0);
+
+		return new PixelShader(&shader);   // Optimized and analyzed copy
+	}
+
+	VertexShader *createVertexShader()
+	{
+		VertexShader shader;
+
+		append(&shader, Shader::OPCODE_MOV, destination(Shader::PARAMETER_OUTPUT, 0), source(Shader::PARAMETER_INPUT, 0));
+		shader.setInput(0, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setOutput(0, 4, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setPositionRegister(0);
+
+		return new VertexShader(&shader);
+	}
+
+	void drawLayers(void *data, int iterations)
+	{
+		Scene *scene = static_cast<Scene*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			for(int layer = 0; layer < layers; layer++)
+			{
+				unsigned int condition = (scene->churn && (layer & 1)) ? 0x00000000 : 0xFFFFFFFF;
+				float mask[4];
+				memcpy(&mask[0], &condition, sizeof(float));
+				mask[1] = mask[2] = mask[3] = mask[0];
+
+				scene->renderer->setPixelShaderConstantF(3, mask);
+				scene->renderer->draw(DRAW_TRIANGLELIST, 0, 2);
+			}
+
+			scene->renderer->synchronize();
+		}
+	}
+
+	void measure(const char *name, bool specialize, bool churn)
+	{
+		Scene scene;
+
+		// A fresh renderer for each run, so no routines are shared between them
+		scene.context = new Context();
+		scene.renderer = new Renderer(scene.context, OpenGL, true);
+		scene.colorBuffer = Surface::create(nullptr, width, height, 1, FORMAT_A8R8G8B8, false, true);
+		scene.vertexBuffer = new Resource(6 * 4 * sizeof(float));
+		scene.churn = churn;
+
+		uniformSpecialization = specialize;   // After the renderer applied the configuration
+
+		const float corners[6][4] = {{-1, -1, 0, 1}, {1, -1, 0, 1}, {-1, 1, 0, 1}, {-1, 1, 0, 1}, {1, -1, 0, 1}, {1, 1, 0, 1}};
+		memcpy(scene.vertexBuffer->lock(PUBLIC), corners, sizeof(corners));
+		scene.vertexBuffer->unlock();
+
+		PixelShader *pixelShader = createPixelShader();
+		VertexShader *vertexShader = createVertexShader();
+
+		Renderer *renderer = scene.renderer;
+
+		renderer->setRenderTarget(0, scene.colorBuffer);
+		renderer->setInputStream(0, Stream(scene.vertexBuffer, scene.vertexBuffer->data(), 4 * sizeof(float)).define(STREAMTYPE_FLOAT, 4));
+		renderer->setIndexBuffer(nullptr);
+		renderer->setPixelShader(pixelShader);
+		renderer->setVertexShader(vertexShader);
+		renderer->setCullMode(CULL_NONE);
+		renderer->setDepthBufferEnable(false);
+
+		const float color[4] = {0.1f, 0.2f, 0.3f, 1.0f};
+		const float scale[4] = {0.5f, 0.5f, 0.5f, 1.0f};
+		const float bias[4] = {0.25f, 0.25f, 0.25f, 0.0f};
+		const int loop[4] = {4, 0, 1, 0};
+
+		renderer->setPixelShaderConstantF(0, color);
+		renderer->setPixelShaderConstantF(1, scale);
+		renderer->setPixelShaderConstantF(2, bias);
+		renderer->setPixelShaderConstantI(0, loop);
+
+		Viewport viewport = {0, 0, width, height, 0.0f, 1.0f};
+		renderer->setViewport(viewport);
+		renderer->setScissor(Rect(0, 0, width, height));
+
+		double framesPerSecond = throughput(drawLayers, &scene);
+		report(name, "fillRate", framesPerSecond * layers * width * height / 1.0e6, "Mpixels/s");
+
+		delete scene.renderer;
+		delete scene.context;
+		delete pixelShader;
+		delete vertexShader;
+
+		uniformSpecialization = false;
+
+		scene.colorBuffer->sync();
+		delete scene.colorBuffer;
+		scene.vertexBuffer->destruct();
+	}
+}
+
+BENCHMARK(Specialization)
+{
+	measure("Specialization.generic", false, false);
+	measure("Specialization.specialized", true, false);
+	measure("Specialization.churn", true, true);
+}
@@ -0,0 +1,191 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the fill rate of bilinear sampling from a texture much larger than
+// the caches, mapped one texel per pixel at several rotations, with the linear
+// and the 4x4 tiled texture layouts.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Context.hpp"
+#include "Renderer/Surface.hpp"
+#include "Shader/PixelShader.hpp"
+#include "Shader/VertexShader.hpp"
+#include "Common/Resource.hpp"
+
+#include <math.h>
+#include <string.h>
+#include <string>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace sw
+{
+	extern bool textureTiling;
+}
+
+namespace
+{
+	const int width = 1024;
+	const int height = 1024;
+	const int textureSize = 2048;
+
+	struct Scene
+	{
+		Renderer *renderer;
+	};
+
+	void append(Shader *shader, Shader::Opcode opcode, Shader::ParameterType dstType, unsigned int dstIndex,
+	            Shader::ParameterType srcType, unsigned int srcIndex, Shader::ParameterType samplerType = Shader::PARAMETER_VOID)
+	{
+		Shader::Instruction *instruction = new Shader::Instruction(opcode);
+		instruction->dst.type = dstType;
+		instruction->dst.index = dstIndex;
+		instruction->src[0].type = srcType;
+		instruction->src[0].index = srcIndex;
+		instruction->src[0].swizzle = 0xE4;
+		instruction->src[1].type = samplerType;
+		instruction->src[1].index = 0;
+		instruction->src[1].swizzle = 0xE4;
+
+		shader->append(instruction);
+	}
+
+	PixelShader *createPixelShader()
+	{
+		PixelShader shader;
+
+		append(&shader, Shader::OPCODE_TEX, Shader::PARAMETER_TEMP, 0, Shader::PARAMETER_INPUT, 0, Shader::PARAMETER_SAMPLER);
+		append(&shader, Shader::OPCODE_MOV, Shader::PARAMETER_COLOROUT, 0, Shader::PARAMETER_TEMP, 0);
+		shader.setInput(0, 2, Shader::Semantic(Shader::USAGE_TEXCOORD, 0));
+
+		return new PixelShader(&shader);   // Optimized and analyzed copy
+	}
+
+	VertexShader *createVertexShader()
+	{
+		VertexShader shader;
+
+		append(&shader, Shader::OPCODE_MOV, Shader::PARAMETER_OUTPUT, 0, Shader::PARAMETER_INPUT, 0);
+		append(&shader, Shader::OPCODE_MOV, Shader::PARAMETER_OUTPUT, 1, Shader::PARAMETER_INPUT, 1);
+		shader.setInput(0, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setInput(1, Shader::Semantic(Shader::USAGE_TEXCOORD, 0));
+		shader.setOutput(0, 4, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setOutput(1, 2, Shader::Semantic(Shader::USAGE_TEXCOORD, 0));
+		shader.setPositionRegister(0);
+
+		return new VertexShader(&shader);
+	}
+
+	void drawQuad(void *data, int iterations)
+	{
+		Scene *scene = static_cast<Scene*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			scene->renderer->draw(DRAW_TRIANGLELIST, 0, 2);
+			scene->renderer->synchronize();
+		}
+	}
+
+	void measure(int degrees, bool tiled)
+	{
+		Context *context = new Context();
+		Renderer *renderer = new Renderer(context, OpenGL, true);
+		Surface *colorBuffer = Surface::create(nullptr, width, height, 1, FORMAT_A8R8G8B8, false, true);
+		Surface *texture = Surface::create(nullptr, textureSize, textureSize, 1, FORMAT_A8R8G8B8, true, false);
+		Resource *vertexBuffer = new Resource(6 * 8 * sizeof(float));
+
+		textureTiling = tiled;   // After the renderer applied the configuration
+
+		unsigned int *texels = static_cast<unsigned int*>(texture->lockInternal(0, 0, 0, LOCK_WRITEONLY, PUBLIC));
+
+		for(int y = 0; y < textureSize; y++)
+		{
+			for(int x = 0; x < textureSize; x++)
+			{
+				texels[y * texture->getInternalPitchP() + x] = 0xFF000000 | (x * 0x9E37 ^ y * 0x79B9);
+			}
+		}
+
+		texture->unlockInternal();
+
+		// Screen corners, and texture coordinates covering a rotated square of the
+		// texture half its size, so each pixel is one texel
+		const float corners[6][2] = {{-1, -1}, {1, -1}, {-1, 1}, {-1, 1}, {1, -1}, {1, 1}};
+		float angle = degrees * 3.14159265f / 180.0f;
+		float *vertices = static_cast<float*>(vertexBuffer->lock(PUBLIC));
+
+		for(int i = 0; i < 6; i++)
+		{
+			float x = corners[i][0] * 0.25f;
+			float y = corners[i][1] * 0.25f;
+
+			float vertex[8] = {corners[i][0], corners[i][1], 0.0f, 1.0f,
+			                   0.5f + x * cosf(angle) - y * sinf(angle), 0.5f + x * sinf(angle) + y * cosf(angle), 0.0f, 1.0f};
+			memcpy(&vertices[i * 8], vertex, sizeof(vertex));
+		}
+
+		vertexBuffer->unlock();
+
+		PixelShader *pixelShader = createPixelShader();
+		VertexShader *vertexShader = createVertexShader();
+
+		renderer->setRenderTarget(0, colorBuffer);
+		renderer->setInputStream(0, Stream(vertexBuffer, vertexBuffer->data(), 8 * sizeof(float)).define(STREAMTYPE_FLOAT, 4));
+		renderer->setInputStream(1, Stream(vertexBuffer, static_cast<const float*>(vertexBuffer->data()) + 4, 8 * sizeof(float)).define(STREAMTYPE_FLOAT, 4));
+		renderer->setIndexBuffer(nullptr);
+		renderer->setPixelShader(pixelShader);
+		renderer->setVertexShader(vertexShader);
+		renderer->setCullMode(CULL_NONE);
+		renderer->setDepthBufferEnable(false);
+		renderer->setTextureResource(0, texture->getResource());
+		renderer->setTextureLevel(0, 0, 0, texture, TEXTURE_2D);
+		renderer->setTextureFilter(SAMPLER_PIXEL, 0, FILTER_LINEAR);
+
+		Viewport viewport = {0, 0, width, height, 0.0f, 1.0f};
+		renderer->setViewport(viewport);
+		renderer->setScissor(Rect(0, 0, width, height));
+
+		Scene scene = {renderer};
+		std::string name = "TextureRotation." + std::to_string(degrees) + (tiled ? ".tiled" : ".linear");
+		report(name.c_str(), "fillRate", throughput(drawQuad, &scene) * width * height / 1.0e6, "Mpixels/s");
+
+		delete renderer;
+		delete context;
+		delete pixelShader;
+		delete vertexShader;
+
+		textureTiling = false;
+
+		colorBuffer->sync();
+		texture->sync();
+		delete colorBuffer;
+		delete texture;
+		vertexBuffer->destruct();
+	}
+}
+
+BENCHMARK(TextureRotation)
+{
+	const int rotations[] = {0, 45, 90};
+
+	for(int degrees : rotations)
+	{
+		measure(degrees, false);
+		measure(degrees, true);
+	}
+}
@@ -0,0 +1,289 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the vertex processing rate of an indexed grid mesh, in which each
+// vertex is shared by up to six triangles, with rasterization discarded. Both
+// with the vertices stored in grid order, and shuffled so that the triangles'
+// indices are scattered across the vertex buffer. Also with three interleaved
+// attributes of each common format, to measure their fetch and conversion.
+
+#include "Benchmark.hpp"
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Context.hpp"
+#include "Renderer/Surface.hpp"
+#include "Shader/PixelShader.hpp"
+#include "Shader/VertexShader.hpp"
+#include "Common/Resource.hpp"
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace sw;
+using namespace benchmark;
+
+namespace
+{
+	const int size = 256;   // Vertices per grid row and column
+
+	struct Mesh
+	{
+		Renderer *renderer;
+		int triangles;
+	};
+
+	struct Attribute
+	{
+		const char *name;
+		StreamType type;
+		unsigned int count;
+		bool normalized;
+		int size;   // Bytes per element
+	};
+
+	Shader::Instruction *instruction(Shader::Opcode opcode, Shader::ParameterType dstType, unsigned int dstIndex)
+	{
+		Shader::Instruction *instruction = new Shader::Instruction(opcode);
+		instruction->dst.type = dstType;
+		instruction->dst.index = dstIndex;
+
+		return instruction;
+	}
+
+	void source(Shader::Instruction *instruction, int i, Shader::ParameterType type, unsigned int index)
+	{
+		instruction->src[i].type = type;
+		instruction->src[i].index = index;
+		instruction->src[i].swizzle = 0xE4;
+	}
+
+	PixelShader *createPixelShader()
+	{
+		PixelShader shader;
+
+		Shader::Instruction *mov = instruction(Shader::OPCODE_MOV, Shader::PARAMETER_COLOROUT, 0);
+		source(mov, 0, Shader::PARAMETER_CONST, 0);
+		shader.append(mov);
+
+		return new PixelShader(&shader);
+	}
+
+	// Transforms the position by a matrix and computes a few extra outputs from it,
+	// or from three more inputs
+	VertexShader *createVertexShader(bool attributes)
+	{
+		VertexShader shader;
+
+		for(int i = 0; i < 4; i++)
+		{
+			Shader::Instruction *dp4 = instruction(Shader::OPCODE_DP4, Shader::PARAMETER_TEMP, 0);
+			dp4->dst.mask = 1 << i;
+			source(dp4, 0, Shader::PARAMETER_INPUT, 0);
+			source(dp4, 1, Shader::PARAMETER_CONST, i);
+			shader.append(dp4);
+		}
+
+		Shader::Instruction *mov = instruction(Shader::OPCODE_MOV, Shader::PARAMETER_OUTPUT, 0);
+		source(mov, 0, Shader::PARAMETER_TEMP, 0);
+		shader.append(mov);
+
+		for(int i = 1; i < 4; i++)
+		{
+			Shader::Instruction *mad = instruction(Shader::OPCODE_MAD, Shader::PARAMETER_OUTPUT, i);
+			source(mad, 0, Shader::PARAMETER_TEMP, 0);
+			source(mad, 1, Shader::PARAMETER_CONST, 4 + i);
+			source(mad, 2, Shader::PARAMETER_INPUT, attributes ? i : 0);
+			shader.append(mad);
+
+			if(attributes)
+			{
+				shader.setInput(i, Shader::Semantic(Shader::USAGE_TEXCOORD, i - 1));
+			}
+
+			shader.setOutput(i, 4, Shader::Semantic(Shader::USAGE_TEXCOORD, i - 1));
+		}
+
+		shader.setInput(0, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setOutput(0, 4, Shader::Semantic(Shader::USAGE_POSITION, 0));
+		shader.setPositionRegister(0);
+
+		return new VertexShader(&shader);
+	}
+
+	void drawMesh(void *data, int iterations)
+	{
+		Mesh *mesh = static_cast<Mesh*>(data);
+
+		for(int i = 0; i < iterations; i++)
+		{
+			mesh->renderer->draw(DRAW_INDEXEDTRIANGLELIST32, 0, mesh->triangles);
+			mesh->renderer->synchronize();
+		}
+	}
+
+	void measure(bool shuffled, const Attribute *attribute)
+	{
+		Context *context = new Context();
+		Renderer *renderer = new Renderer(context, OpenGL, true);
+		Surface *colorBuffer = Surface::create(nullptr, 64, 64, 1, FORMAT_A8R8G8B8, false, true);
+
+		// Location of each grid vertex in the vertex buffer
+		std::vector<int> location(size * size);
+
+		for(int i = 0; i < size * size; i++)
+		{
+			location[i] = i;
+		}
+
+		if(shuffled)
+		{
+			srand(0);
+
+			for(int i = size * size - 1; i > 0; i--)
+			{
+				int j = rand() % (i + 1);
+				int t = location[i];
+				location[i] = location[j];
+				location[j] = t;
+			}
+		}
+
+		Resource *vertexBuffer = new Resource(size * size * 4 * sizeof(float));
+		float *vertex = static_cast<float*>(vertexBuffer->lock(PUBLIC));
+
+		for(int y = 0; y < size; y++)
+		{
+			for(int x = 0; x < size; x++)
+			{
+				float *v = &vertex[location[y * size + x] * 4];
+				v[0] = x * 2.0f / (size - 1) - 1.0f;
+				v[1] = y * 2.0f / (size - 1) - 1.0f;
+				v[2] = 0.0f;
+				v[3] = 1.0f;
+			}
+		}
+
+		vertexBuffer->unlock();
+
+		const int triangles = 2 * (size - 1) * (size - 1);
+		Resource *indexBuffer = new Resource(3 * triangles * sizeof(unsigned int));
+		unsigned int *index = static_cast<unsigned int*>(indexBuffer->lock(PUBLIC));
+
+		for(int y = 0; y < size - 1; y++)
+		{
+			for(int x = 0; x < size - 1; x++)
+			{
+				const int corners[6] = {0, 1, size, size, 1, size + 1};
+
+				for(int i = 0; i < 6; i++)
+				{
+					*index++ = location[y * size + x + corners[i]];
+				}
+			}
+		}
+
+		indexBuffer->unlock();
+
+		Resource *attributeBuffer = nullptr;
+
+		if(attribute)
+		{
+			int stride = 3 * attribute->size;
+			attributeBuffer = new Resource(size * size * stride);
+			unsigned char *data = static_cast<unsigned char*>(attributeBuffer->lock(PUBLIC));
+
+			for(int i = 0; i < size * size * stride; i++)
+			{
+				data[i] = (i * 37) & 0x7B;   // Also finite as half floats
+			}
+
+			attributeBuffer->unlock();
+
+			for(int i = 0; i < 3; i++)
+			{
+				const unsigned char *element = static_cast<const unsigned char*>(attributeBuffer->data()) + i * attribute->size;
+				renderer->setInputStream(1 + i, Stream(attributeBuffer, element, stride).define(attribute->type, attribute->count, attribute->normalized));
+			}
+		}
+
+		PixelShader *pixelShader = createPixelShader();
+		VertexShader *vertexShader = createVertexShader(attribute != nullptr);
+
+		renderer->setRenderTarget(0, colorBuffer);
+		renderer->setInputStream(0, Stream(vertexBuffer, vertexBuffer->data(), 4 * sizeof(float)).define(STREAMTYPE_FLOAT, 4));
+		renderer->setIndexBuffer(indexBuffer);
+		renderer->setPixelShader(pixelShader);
+		renderer->setVertexShader(vertexShader);
+		renderer->setRasterizerDiscard(true);
+
+		const float identity[4][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}};
+		const float scale[4] = {0.5f, 0.25f, 0.125f, 1.0f};
+
+		for(int i = 0; i < 4; i++)
+		{
+			renderer->setVertexShaderConstantF(i, identity[i]);
+			renderer->setVertexShaderConstantF(4 + i, scale);
+		}
+
+		Viewport viewport = {0, 0, 64, 64, 0.0f, 1.0f};
+		renderer->setViewport(viewport);
+		renderer->setScissor(Rect(0, 0, 64, 64));
+
+		Mesh mesh = {renderer, triangles};
+		std::string name = std::string("VertexShading.grid") + (shuffled ? ".shuffled" : "");
+
+		if(attribute)
+		{
+			name += std::string(".") + attribute->name;
+		}
+
+		report(name.c_str(), "vertexRate", throughput(drawMesh, &mesh) * size * size / 1.0e6, "Mvertices/s");
+
+		delete renderer;
+		delete context;
+		delete pixelShader;
+		delete vertexShader;
+
+		colorBuffer->sync();
+		delete colorBuffer;
+		vertexBuffer->destruct();
+		indexBuffer->destruct();
+
+		if(attributeBuffer)
+		{
+			attributeBuffer->destruct();
+		}
+	}
+}
+
+BENCHMARK(VertexShading)
+{
+	const Attribute attributes[] =
+	{
+		{"float3", STREAMTYPE_FLOAT, 3, false, 12},
+		{"half4", STREAMTYPE_HALF, 4, false, 8},
+		{"short4n", STREAMTYPE_SHORT, 4, true, 8},
+		{"ubyte4n", STREAMTYPE_BYTE, 4, true, 4},
+		{"int2_10_10_10n", STREAMTYPE_2_10_10_10_INT, 4, true, 4},
+	};
+
+	measure(false, nullptr);
+	measure(true, nullptr);
+
+	for(const Attribute &attribute : attributes)
+	{
+		measure(false, &attribute);
+	}
+}
@@ -0,0 +1,191 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks that the scalar and SSE2 ETC2/EAC block decoding both match the output
+// of the original decoder bit for bit, and that splitting an image into bands
+// doesn't change the result.
+
+#include "ScopedCPUID.hpp"
+
+#include "Renderer/ETC_Decoder.hpp"
+#include "Renderer/Surface.hpp"
+#include "Common/CPUID.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+	// Pseudo-random blocks exercise all of the ETC2 modes
+	void fill(unsigned char *data, size_t size, unsigned int seed)
+	{
+		for(size_t i = 0; i < size; i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			data[i] = (unsigned char)(seed >> 16);
+		}
+	}
+
+	struct InputType
+	{
+		ETC_Decoder::InputType type;
+		int blockBytes;
+		int dstBpp;   // As used for the corresponding internal format
+	};
+
+	const InputType inputTypes[] =
+	{
+		{ETC_Decoder::ETC_R_SIGNED,               8, 4},
+		{ETC_Decoder::ETC_R_UNSIGNED,             8, 1},
+		{ETC_Decoder::ETC_RG_SIGNED,             16, 8},
+		{ETC_Decoder::ETC_RG_UNSIGNED,           16, 2},
+		{ETC_Decoder::ETC_RGB,                    8, 4},
+		{ETC_Decoder::ETC_RGB_PUNCHTHROUGH_ALPHA, 8, 4},
+		{ETC_Decoder::ETC_RGBA,                  16, 4},
+	};
+
+	// Sizes which aren't multiples of the 4x4 block size have partial blocks along the right and bottom edges
+	const int sizes[][2] = {{1, 1}, {4, 4}, {5, 3}, {13, 7}, {64, 9}, {30, 33}};
+
+	// FNV-1a hashes of the output of the decoder which preceded the vectorized one,
+	// for each input type and size, including the row padding
+	const unsigned long long expectedHashes[][6] =
+	{
+		{0xEF2E587487AF7EABull, 0x9C6119E1DCF6CA7Bull, 0x25107AFA80A43EBAull, 0xF7C3EDA10BB86CF0ull, 0x68ED82F7F7B0C1CBull, 0x943EA41A1BE63736ull},
+		{0x2E4E8876A6097AF6ull, 0xB41D4D96E6E2CFE1ull, 0x08C147D65F1F457Bull, 0x58F9792344B3BB1Bull, 0x9A31CB588935DD8Full, 0xDD8C98658CBE0021ull},
+		{0x09D78616582D22F9ull, 0x73ABE4DC4C1CC54Full, 0x6531643A930841ECull, 0xAD16312A8E1859F0ull, 0x9444F9B7FFEE663Dull, 0xFDC172203ABDF3FAull},
+		{0x2D0F23E7D27A0E65ull, 0x495962C1B7CBD041ull, 0x69D48A623D278852ull, 0xC170389246F24219ull, 0xCBCAEFB19DF3CB10ull, 0xC3328358AF9175DFull},
+		{0x3308F3775FDECA37ull, 0x0F46FB11E67FB424ull, 0xE5915ECA5E4C193Bull, 0x9A367F8233F36E95ull, 0xDC141972DBAC5D9Bull, 0x21F8381481A5D402ull},
+		{0x3308F3775FDECA37ull, 0x0F46FB11E67FB424ull, 0xE5915ECA5E4C193Bull, 0x764615701CF0A651ull, 0xEEE771A6ADF12E63ull, 0xFAF01881A5D3AB24ull},
+		{0x39EE5FBC2B8F808Cull, 0xAFF31299FC4EC383ull, 0x05BE629920B361F4ull, 0x3353044D2D2CD9C4ull, 0x0882180739A50052ull, 0xA3809B446514B15Full},
+	};
+
+	unsigned long long hash(const std::vector<unsigned char> &data)
+	{
+		unsigned long long hash = 14695981039346656037ull;
+
+		for(unsigned char byte : data)
+		{
+			hash = (hash ^ byte) * 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	std::vector<unsigned char> decode(const std::vector<unsigned char> &src, int w, int h, const InputType &input, bool sse2)
+	{
+		// Padding at the end of each row catches writes outside of the image
+		int pitch = w * input.dstBpp + 8;
+		std::vector<unsigned char> dst(pitch * h, 0xCD);
+
+		ScopedCPUID scopedCPUID;
+		sw::CPUID::setEnableSSE2(sse2);
+
+		EXPECT_TRUE(ETC_Decoder::Decode(src.data(), dst.data(), w, h, w, h, pitch, input.dstBpp, input.type));
+
+		return dst;
+	}
+}
+
+TEST(ETCDecoderTest, MatchesOriginalDecoder)
+{
+	for(size_t i = 0; i < sizeof(inputTypes) / sizeof(inputTypes[0]); i++)
+	{
+		const InputType &input = inputTypes[i];
+
+		for(size_t j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+		{
+			int w = sizes[j][0];
+			int h = sizes[j][1];
+
+			std::vector<unsigned char> src(((w + 3) / 4) * ((h + 3) / 4) * input.blockBytes);
+			fill(src.data(), src.size(), w * 256 + h);
+
+			EXPECT_EQ(expectedHashes[i][j], hash(decode(src, w, h, input, false))) << "scalar, input type " << input.type << ", " << w << "x" << h;
+			EXPECT_EQ(expectedHashes[i][j], hash(decode(src, w, h, input, true))) << "SSE2, input type " << input.type << ", " << w << "x" << h;
+		}
+	}
+}
+
+TEST(ETCDecoderTest, BandsMatchSingleBand)
+{
+	const sw::Format formats[] =
+	{
+		sw::FORMAT_ETC1,
+		sw::FORMAT_RGB8_ETC2,
+		sw::FORMAT_SRGB8_ETC2,
+		sw::FORMAT_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,
+		sw::FORMAT_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2,
+		sw::FORMAT_RGBA8_ETC2_EAC,
+		sw::FORMAT_SRGB8_ALPHA8_ETC2_EAC,
+		sw::FORMAT_R11_EAC,
+		sw::FORMAT_SIGNED_R11_EAC,
+		sw::FORMAT_RG11_EAC,
+		sw::FORMAT_SIGNED_RG11_EAC,
+	};
+
+	// More bands than block rows, or than the band limit, get clamped
+	const int bandCounts[] = {1, 2, 3, 7, 16, 100};
+	const int bandSizes[][2] = {{61, 45}, {9, 70}};
+
+	for(sw::Format format : formats)
+	{
+		for(const auto &size : bandSizes)
+		{
+			int w = size[0];
+			int h = size[1];
+
+			sw::Surface *surface = sw::Surface::create(nullptr, w, h, 1, format, true, false);
+
+			unsigned char *external = static_cast<unsigned char*>(surface->lockExternal(0, 0, 0, sw::LOCK_WRITEONLY, sw::PUBLIC));
+			fill(external, sw::Surface::size(w, h, 1, format), format);
+			surface->unlockExternal();
+
+			std::vector<unsigned char> reference;
+
+			for(int bandCount : bandCounts)
+			{
+				surface->lockExternal(0, 0, 0, sw::LOCK_WRITEONLY, sw::PUBLIC);   // Makes the internal copy stale
+				surface->unlockExternal();
+
+				sw::Surface::setDecodeBandCount(bandCount);
+				const unsigned char *internal = static_cast<const unsigned char*>(surface->lockInternal(0, 0, 0, sw::LOCK_READONLY, sw::PUBLIC));
+				sw::Surface::setDecodeBandCount(0);
+
+				int rowBytes = w * sw::Surface::bytes(surface->getInternalFormat());
+				std::vector<unsigned char> decoded;
+
+				for(int y = 0; y < h; y++)
+				{
+					const unsigned char *row = internal + y * surface->getInternalPitchB();
+					decoded.insert(decoded.end(), row, row + rowBytes);
+				}
+
+				surface->unlockInternal();
+
+				if(bandCount == 1)
+				{
+					reference = decoded;
+				}
+				else
+				{
+					EXPECT_TRUE(reference == decoded) << "format " << format << ", " << w << "x" << h << ", " << bandCount << " bands";
+				}
+			}
+
+			delete surface;
+		}
+	}
+}
@@ -0,0 +1,215 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks the F16C, SSE2 and scalar half-float conversions against a reference
+// which rounds to nearest even and keeps the upper mantissa bits of NaNs.
+
+#include "ScopedCPUID.hpp"
+
+#include "Common/Half.hpp"
+#include "Common/CPUID.hpp"
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+	enum Path
+	{
+		PATH_F16C,
+		PATH_SSE2,
+		PATH_SCALAR,
+	};
+
+	const char *pathName[] = {"F16C", "SSE2", "scalar"};
+
+	// Restricts the conversions to one implementation, until destroyed
+	class ScopedPath : public ScopedCPUID
+	{
+	public:
+		explicit ScopedPath(Path path)
+		{
+			sw::CPUID::setEnableF16C(path == PATH_F16C);
+			sw::CPUID::setEnableSSE2(path != PATH_SCALAR);
+		}
+	};
+
+	unsigned int bits(float f)
+	{
+		unsigned int i;
+		memcpy(&i, &f, sizeof(i));
+		return i;
+	}
+
+	float fromBits(unsigned int i)
+	{
+		float f;
+		memcpy(&f, &i, sizeof(f));
+		return f;
+	}
+
+	unsigned int referenceFloat(unsigned short h)
+	{
+		unsigned int sign = (h & 0x8000) << 16;
+		unsigned int exponent = (h >> 10) & 0x1F;
+		unsigned int mantissa = h & 0x03FF;
+
+		if(exponent == 0x1F)   // Infinity, or NaN which gets quieted
+		{
+			return sign | 0x7F800000 | (mantissa ? 0x00400000 | (mantissa << 13) : 0);
+		}
+
+		double value = (exponent == 0) ? ldexp(mantissa, -24) : ldexp(mantissa | 0x0400, (int)exponent - 25);
+
+		return sign | bits((float)value);
+	}
+
+	unsigned short referenceHalf(float f)
+	{
+		unsigned int sign = (bits(f) >> 16) & 0x8000;
+
+		if(isnan(f))
+		{
+			return sign | 0x7E00 | ((bits(f) >> 13) & 0x03FF);
+		}
+
+		double value = fabs((double)f);
+
+		if(value >= 65520.0)   // Rounds to infinity
+		{
+			return sign | 0x7C00;
+		}
+
+		if(value < ldexp(1.0, -14))   // Denormal, or the smallest normal after rounding
+		{
+			return sign | (unsigned short)nearbyint(ldexp(value, 24));
+		}
+
+		int exponent;
+		frexp(value, &exponent);
+		exponent -= 1;
+
+		// A mantissa rounded up to 2.0 carries into the exponent
+		unsigned int mantissa = (unsigned int)nearbyint(ldexp(value, 10 - exponent));
+
+		return sign | (((exponent + 15) << 10) + mantissa - 0x0400);
+	}
+
+	// Floats on and around every rounding boundary between halves, plus the special cases
+	std::vector<float> testFloats()
+	{
+		std::vector<float> floats;
+
+		for(unsigned int h = 0; h < 0x10000; h++)
+		{
+			unsigned int sign = (h & 0x8000) << 16;
+			unsigned int abs = ((h & 0x7FFF) << 13) + 0x38000000;   // Aligned with the half mantissa
+
+			if(abs >= 0x7F800000)
+			{
+				continue;
+			}
+
+			const unsigned int offsets[] = {0x0000, 0x0001, 0x0FFF, 0x1000, 0x1001, 0x1FFF};
+
+			for(unsigned int offset : offsets)
+			{
+				floats.push_back(fromBits(sign | (abs + offset)));
+			}
+		}
+
+		for(int k = 0; k < 0x0400; k++)   // Ties between half denormals, and their neighbors
+		{
+			float tie = (float)ldexp(2 * k + 1, -25);
+
+			floats.push_back(tie);
+			floats.push_back(-tie);
+			floats.push_back(nextafterf(tie, 0.0f));
+			floats.push_back(nextafterf(tie, 1.0f));
+		}
+
+		const unsigned int special[] =
+		{
+			0x00000000, 0x80000000,   // Zeros
+			0x00000001, 0x807FFFFF, 0x00400000,   // Float denormals
+			0x33000000, 0x33000001, 0x33400000, 0x33800000,   // 2^-25 ties to zero, just above rounds up
+			0x387FC000, 0x387FE000, 0x387FFFFF,   // Largest half denormal, rounding up to the smallest normal
+			0x477FE000, 0x477FEFFF, 0x477FF000, 0xC77FF000,   // 65504, 65519.99, 65520
+			0x47800000, 0x501502F9, 0x7F7FFFFF,   // Beyond the half range
+			0x7F800000, 0xFF800000,   // Infinities
+			0x7F800001, 0xFF800001, 0x7FBFFFFF, 0x7F802000,   // Signaling NaNs
+			0x7FC00000, 0xFFC00000, 0x7FFFFFFF, 0x7FC02000,   // Quiet NaNs
+		};
+
+		for(unsigned int s : special)
+		{
+			floats.push_back(fromBits(s));
+		}
+
+		while(floats.size() % 8 != 0)   // The vector paths only handle groups of eight
+		{
+			floats.push_back(0.0f);
+		}
+
+		return floats;
+	}
+}
+
+TEST(HalfTest, HalfToFloat)
+{
+	std::vector<unsigned short> halves(0x10000);
+
+	for(unsigned int h = 0; h < 0x10000; h++)
+	{
+		halves[h] = (unsigned short)h;
+	}
+
+	for(Path path : {PATH_F16C, PATH_SSE2, PATH_SCALAR})
+	{
+		std::vector<float> floats(halves.size());
+
+		{
+			ScopedPath scopedPath(path);
+			sw::halfToFloat(floats.data(), halves.data(), halves.size());
+		}
+
+		for(unsigned int h = 0; h < 0x10000; h++)
+		{
+			ASSERT_EQ(referenceFloat(halves[h]), bits(floats[h])) << pathName[path] << " half 0x" << std::hex << h;
+		}
+	}
+}
+
+TEST(HalfTest, FloatToHalf)
+{
+	std::vector<float> floats = testFloats();
+
+	for(Path path : {PATH_F16C, PATH_SSE2, PATH_SCALAR})
+	{
+		std::vector<unsigned short> halves(floats.size());
+
+		{
+			ScopedPath scopedPath(path);
+			sw::floatToHalf(halves.data(), floats.data(), floats.size());
+		}
+
+		for(size_t i = 0; i < floats.size(); i++)
+		{
+			ASSERT_EQ(referenceHalf(floats[i]), halves[i]) << pathName[path] << " float 0x" << std::hex << bits(floats[i]);
+		}
+	}
+}
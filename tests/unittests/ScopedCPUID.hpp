@@ -0,0 +1,62 @@
+// Copyright 2018 The SwiftShader Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ScopedCPUID_hpp
+#define ScopedCPUID_hpp
+
+#include "Common/CPUID.hpp"
+
+// Saves which instruction sets sw::CPUID reports as supported, and restores them
+// when destroyed, so tests which disable some don't affect the tests after them
+class ScopedCPUID
+{
+public:
+	ScopedCPUID() :
+		MMX(sw::CPUID::supportsMMX()),
+		CMOV(sw::CPUID::supportsCMOV()),
+		SSE(sw::CPUID::supportsSSE()),
+		SSE2(sw::CPUID::supportsSSE2()),
+		SSE3(sw::CPUID::supportsSSE3()),
+		SSSE3(sw::CPUID::supportsSSSE3()),
+		SSE4_1(sw::CPUID::supportsSSE4_1()),
+		F16C(sw::CPUID::supportsF16C())
+	{
+	}
+
+	~ScopedCPUID()
+	{
+		// Enabling an instruction set also enables the ones it builds on, while disabling
+		// one disables its extensions, so they get restored from the oldest to the newest
+		sw::CPUID::setEnableMMX(MMX);
+		sw::CPUID::setEnableCMOV(CMOV);
+		sw::CPUID::setEnableSSE(SSE);
+		sw::CPUID::setEnableSSE2(SSE2);
+		sw::CPUID::setEnableSSE3(SSE3);
+		sw::CPUID::setEnableSSSE3(SSSE3);
+		sw::CPUID::setEnableSSE4_1(SSE4_1);
+		sw::CPUID::setEnableF16C(F16C);
+	}
+
+private:
+	const bool MMX;
+	const bool CMOV;
+	const bool SSE;
+	const bool SSE2;
+	const bool SSE3;
+	const bool SSSE3;
+	const bool SSE4_1;
+	const bool F16C;
+};
+
+#endif   // ScopedCPUID_hpp
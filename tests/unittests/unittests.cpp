@@ -17,6 +17,12 @@
 
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
 
 #if defined(_WIN32)
 #include <Windows.h>
@@ -37,6 +43,97 @@ protected:
 			EXPECT_NE((HMODULE)NULL, libGLESv2);
 		#endif
 	}
+
+	// Makes a context of the given client version current, on a 64x64 RGBA8 pbuffer with depth
+	void initializeContext(EGLint clientVersion)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		EGLBoolean success = eglInitialize(display, nullptr, nullptr);
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
+
+		eglBindAPI(EGL_OPENGL_ES_API);
+
+		const EGLint configAttributes[] =
+		{
+			EGL_SURFACE_TYPE,		EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE,	(clientVersion == 3) ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_ES2_BIT,
+			EGL_RED_SIZE,			8,
+			EGL_ALPHA_SIZE,			8,
+			EGL_DEPTH_SIZE,			24,
+			EGL_NONE
+		};
+
+		EGLConfig config;
+		EGLint num_config = -1;
+		success = eglChooseConfig(display, configAttributes, &config, 1, &num_config);
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
+		EXPECT_EQ(num_config, 1);
+
+		EGLint surfaceAttributes[] =
+		{
+			EGL_WIDTH, 64,
+			EGL_HEIGHT, 64,
+			EGL_NONE
+		};
+
+		surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+		EXPECT_NE(EGL_NO_SURFACE, surface);
+
+		EGLint contextAttributes[] =
+		{
+			EGL_CONTEXT_CLIENT_VERSION, clientVersion,
+			EGL_NONE
+		};
+
+		context = eglCreateContext(display, config, NULL, contextAttributes);
+		EXPECT_NE(EGL_NO_CONTEXT, context);
+
+		success = eglMakeCurrent(display, surface, surface, context);
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
+	}
+
+	void uninitializeContext()
+	{
+		EGLBoolean success = eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
+
+		success = eglDestroyContext(display, context);
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
+
+		success = eglDestroySurface(display, surface);
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
+
+		success = eglTerminate(display);
+		EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
+	}
+
+	GLuint createProgram(const char *vertexSource, const char *fragmentSource)
+	{
+		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(vertexShader, 1, &vertexSource, nullptr);
+		glCompileShader(vertexShader);
+
+		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
+		glCompileShader(fragmentShader);
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		EXPECT_EQ(GL_TRUE, linked);
+
+		return program;
+	}
+
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLSurface surface = EGL_NO_SURFACE;
+	EGLContext context = EGL_NO_CONTEXT;
 };
 
 TEST_F(SwiftShaderTest, Initalization)
@@ -185,3 +282,644 @@ TEST_F(SwiftShaderTest, Initalization)
 	EXPECT_EQ(EGL_SUCCESS, eglGetError());
 	EXPECT_EQ((EGLBoolean)EGL_TRUE, success);
 }
+
+// Links a program from source, retrieves its binary, and checks that a program
+// loaded from that binary renders the same result
+TEST_F(SwiftShaderTest, ProgramBinary)
+{
+	initializeContext(3);
+
+	GLint binaryFormatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+	EXPECT_EQ(1, binaryFormatCount);
+
+	const char *vertexSource =
+		"#version 300 es\n"
+		"in vec4 position;\n"
+		"uniform vec4 offset;\n"
+		"out vec4 color;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = position + offset;\n"
+		"	color = vec4(0.25, 0.5, 0.75, 1.0);\n"
+		"}\n";
+
+	const char *fragmentSource =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"in vec4 color;\n"
+		"uniform float scale;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = color * scale;\n"
+		"}\n";
+
+	GLuint sourceProgram = createProgram(vertexSource, fragmentSource);
+
+	GLint binaryLength = 0;
+	glGetProgramiv(sourceProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	EXPECT_GT(binaryLength, 0);
+
+	std::vector<unsigned char> binary(binaryLength);
+	GLsizei length = 0;
+	GLenum binaryFormat = GL_NONE;
+	glGetProgramBinary(sourceProgram, binaryLength - 1, &length, &binaryFormat, binary.data());
+	EXPECT_EQ((GLenum)GL_INVALID_OPERATION, glGetError());
+
+	glGetProgramBinary(sourceProgram, binaryLength, &length, &binaryFormat, binary.data());
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+	EXPECT_EQ(binaryLength, length);
+
+	GLuint binaryProgram = glCreateProgram();
+	glProgramBinary(binaryProgram, binaryFormat, binary.data(), length);
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(binaryProgram, GL_LINK_STATUS, &linked);
+	EXPECT_EQ(GL_TRUE, linked);
+
+	GLint activeUniforms = 0;
+	glGetProgramiv(binaryProgram, GL_ACTIVE_UNIFORMS, &activeUniforms);
+	EXPECT_EQ(2, activeUniforms);
+
+	GLuint programs[] = {sourceProgram, binaryProgram};
+	unsigned char pixels[2][4] = {};
+
+	const GLfloat vertices[] =
+	{
+		-1.0f, -1.0f, 0.0f, 1.0f,
+		 3.0f, -1.0f, 0.0f, 1.0f,
+		-1.0f,  3.0f, 0.0f, 1.0f,
+	};
+
+	for(int i = 0; i < 2; i++)
+	{
+		glUseProgram(programs[i]);
+		glUniform4f(glGetUniformLocation(programs[i], "offset"), 0.0f, 0.0f, 0.0f, 0.0f);
+		glUniform1f(glGetUniformLocation(programs[i], "scale"), 0.5f);
+
+		GLint position = glGetAttribLocation(programs[i], "position");
+		EXPECT_GE(position, 0);
+		glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, vertices);
+		glEnableVertexAttribArray(position);
+
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glReadPixels(32, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels[i]);
+		EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+	}
+
+	EXPECT_EQ(0, memcmp(pixels[0], pixels[1], sizeof(pixels[0])));
+	EXPECT_NE(0, pixels[0][2]);
+
+	// A corrupted binary must fail to link rather than crash
+	binary[binary.size() / 2] ^= 0xFF;
+	glProgramBinary(binaryProgram, binaryFormat, binary.data(), length);
+	glGetProgramiv(binaryProgram, GL_LINK_STATUS, &linked);
+	EXPECT_EQ(GL_FALSE, linked);
+
+	glDeleteProgram(binaryProgram);
+	glDeleteProgram(sourceProgram);
+
+	uninitializeContext();
+}
+
+// Loading a truncated binary, or one whose payload holds values the compiler can't
+// produce, must fail to link instead of indexing outside of the shader register files
+TEST_F(SwiftShaderTest, ProgramBinaryValidation)
+{
+	initializeContext(3);
+
+	const char *vertexSource =
+		"#version 300 es\n"
+		"in vec4 position;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = position;\n"
+		"}\n";
+
+	const char *fragmentSource =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"uniform sampler2D image;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = texture(image, vec2(0.5));\n"
+		"}\n";
+
+	GLuint sourceProgram = createProgram(vertexSource, fragmentSource);
+
+	GLint binaryLength = 0;
+	glGetProgramiv(sourceProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	EXPECT_GT(binaryLength, 0);
+
+	std::vector<unsigned char> binary(binaryLength);
+	GLenum binaryFormat = GL_NONE;
+	glGetProgramBinary(sourceProgram, binaryLength, nullptr, &binaryFormat, binary.data());
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+
+	GLuint binaryProgram = glCreateProgram();
+
+	auto link = [&](const std::vector<unsigned char> &data, GLsizei length)
+	{
+		glProgramBinary(binaryProgram, binaryFormat, data.data(), length);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(binaryProgram, GL_LINK_STATUS, &linked);
+
+		return linked;
+	};
+
+	// The payload follows its size and FNV-1a checksum at the end of the header.
+	// Corrupted payloads get a matching checksum so they reach the field checks.
+	unsigned int payloadSize = 0;
+	size_t checksumOffset = 4 + 4 + 4 + binary[8] + 4 + 4;
+	memcpy(&payloadSize, &binary[checksumOffset - 4], sizeof(payloadSize));
+	ASSERT_EQ(binary.size(), checksumOffset + 4 + payloadSize);
+
+	auto corrupt = [&](size_t offset, unsigned char value)
+	{
+		std::vector<unsigned char> corrupted = binary;
+		size_t payload = checksumOffset + 4;
+		corrupted[payload + offset] = value;
+
+		unsigned int hash = 2166136261u;
+
+		for(size_t i = payload; i < corrupted.size(); i++)
+		{
+			hash = (hash ^ corrupted[i]) * 16777619u;
+		}
+
+		memcpy(&corrupted[checksumOffset], &hash, sizeof(hash));
+
+		return corrupted;
+	};
+
+	EXPECT_EQ(GL_TRUE, link(corrupt(0, binary[checksumOffset + 4]), binaryLength));
+
+	EXPECT_EQ(GL_FALSE, link(binary, binaryLength - 1));
+	EXPECT_EQ(GL_FALSE, link(binary, binaryLength / 2));
+	EXPECT_EQ(GL_FALSE, link(binary, static_cast<GLsizei>(checksumOffset)));
+
+	// Offsets into the vertex shader: shader type, version, instruction count, then
+	// the first instruction's opcode, control, predicate flags, sampler type and usage
+	EXPECT_EQ(GL_FALSE, link(corrupt(0, 0x00), binaryLength));    // Not a vertex or pixel shader
+	EXPECT_EQ(GL_FALSE, link(corrupt(13, 0x7F), binaryLength));   // Opcode
+	EXPECT_EQ(GL_FALSE, link(corrupt(14, 0x08), binaryLength));   // Control
+	EXPECT_EQ(GL_FALSE, link(corrupt(18, 0x02), binaryLength));   // Predicate bool
+	EXPECT_EQ(GL_FALSE, link(corrupt(22, 0x05), binaryLength));   // Sampler type
+	EXPECT_EQ(GL_FALSE, link(corrupt(26, 0x0E), binaryLength));   // Usage
+
+	glDeleteProgram(binaryProgram);
+	glDeleteProgram(sourceProgram);
+
+	uninitializeContext();
+}
+
+// Triangles within the guard band skip clipping, so they have to be scissored to the
+// viewport, while wide points straddling its edge must keep their visible part
+TEST_F(SwiftShaderTest, ViewportEdges)
+{
+	initializeContext(2);
+
+	const char *vertexSource =
+		"attribute vec4 position;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = position;\n"
+		"	gl_PointSize = 16.0;\n"
+		"}\n";
+
+	const char *fragmentSource =
+		"precision mediump float;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);\n"
+		"}\n";
+
+	GLuint program = createProgram(vertexSource, fragmentSource);
+	glUseProgram(program);
+
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glViewport(0, 0, 32, 32);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(0, 0, 64, 64);
+
+	const GLfloat point[] = {0.875f, 0.875f, 0.0f, 1.0f};   // Window coordinates (30, 30)
+	GLint position = glGetAttribLocation(program, "position");
+	glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, point);
+	glEnableVertexAttribArray(position);
+	glDrawArrays(GL_POINTS, 0, 1);
+
+	unsigned char pixel[4] = {};
+	glReadPixels(24, 24, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+	EXPECT_EQ(255, pixel[0]);
+	glReadPixels(31, 31, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+	EXPECT_EQ(255, pixel[0]);
+
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	const GLfloat triangle[] =
+	{
+		-1.0f, -1.0f, 0.0f, 1.0f,
+		 3.0f, -1.0f, 0.0f, 1.0f,
+		-1.0f,  3.0f, 0.0f, 1.0f,
+	};
+
+	glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, triangle);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	glReadPixels(31, 31, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+	EXPECT_EQ(255, pixel[0]);
+	glReadPixels(32, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+	EXPECT_EQ(0, pixel[0]);
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+
+	glDeleteProgram(program);
+
+	uninitializeContext();
+}
+
+// Static triangle lists get reordered for vertex cache locality, and the reordered copy
+// must be dropped when transform feedback overwrites the element array buffer
+TEST_F(SwiftShaderTest, TransformFeedbackIntoReorderedIndices)
+{
+	// Opaque triangles only get reordered on request, since equal depths resolve in draw order
+	#if defined(_WIN32)
+		_putenv_s("SWIFTSHADER_REORDER_OPAQUE_TRIANGLES", "1");
+	#else
+		setenv("SWIFTSHADER_REORDER_OPAQUE_TRIANGLES", "1", 1);
+	#endif
+
+	initializeContext(3);
+
+	#if defined(_WIN32)
+		_putenv_s("SWIFTSHADER_REORDER_OPAQUE_TRIANGLES", "");
+	#else
+		unsetenv("SWIFTSHADER_REORDER_OPAQUE_TRIANGLES");
+	#endif
+
+	const char *vertexSource =
+		"#version 300 es\n"
+		"in vec4 position;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = position;\n"
+		"}\n";
+
+	const char *fragmentSource =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = vec4(1.0, 0.0, 0.0, 1.0);\n"
+		"}\n";
+
+	// Writes the indices of the right triangle
+	const char *feedbackSource =
+		"#version 300 es\n"
+		"flat out uint index;\n"
+		"void main()\n"
+		"{\n"
+		"	index = uint(3 + gl_VertexID % 3);\n"
+		"	gl_Position = vec4(0.0);\n"
+		"}\n";
+
+	const char *feedbackFragmentSource =
+		"#version 300 es\n"
+		"precision mediump float;\n"
+		"flat in uint index;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragColor = vec4(float(index));\n"
+		"}\n";
+
+	GLuint program = createProgram(vertexSource, fragmentSource);
+
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &feedbackSource, nullptr);
+	glCompileShader(vertexShader);
+
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &feedbackFragmentSource, nullptr);
+	glCompileShader(fragmentShader);
+
+	GLuint feedbackProgram = glCreateProgram();
+	glAttachShader(feedbackProgram, vertexShader);
+	glAttachShader(feedbackProgram, fragmentShader);
+	const char *varying = "index";
+	glTransformFeedbackVaryings(feedbackProgram, 1, &varying, GL_INTERLEAVED_ATTRIBS);
+	glLinkProgram(feedbackProgram);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(feedbackProgram, GL_LINK_STATUS, &linked);
+	EXPECT_EQ(GL_TRUE, linked);
+
+	const GLfloat vertices[] =
+	{
+		-1.0f, -1.0f, 0.5f, 1.0f,   // Left half
+		 0.0f, -1.0f, 0.5f, 1.0f,
+		-1.0f,  1.0f, 0.5f, 1.0f,
+		 0.0f, -1.0f, 0.5f, 1.0f,   // Right half
+		 1.0f, -1.0f, 0.5f, 1.0f,
+		 0.0f,  1.0f, 0.5f, 1.0f,
+	};
+
+	const int count = 3 * 256;   // Large enough to get reordered
+	std::vector<GLuint> indices(count);
+
+	for(int i = 0; i < count; i++)
+	{
+		indices[i] = i % 3;
+	}
+
+	GLuint buffers[2];
+	glGenBuffers(2, buffers);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+	glUseProgram(program);
+	GLint position = glGetAttribLocation(program, "position");
+	glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+	glEnableVertexAttribArray(position);
+
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+	unsigned char left[4] = {};
+	unsigned char right[4] = {};
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+	glReadPixels(8, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, left);
+	glReadPixels(36, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, right);
+	EXPECT_EQ(255, left[0]);
+	EXPECT_EQ(0, right[0]);
+
+	glUseProgram(feedbackProgram);
+	glDisableVertexAttribArray(position);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[1]);
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, count);
+	glEndTransformFeedback();
+	glDisable(GL_RASTERIZER_DISCARD);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+
+	glUseProgram(program);
+	glEnableVertexAttribArray(position);
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+	glReadPixels(8, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, left);
+	glReadPixels(36, 32, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, right);
+	EXPECT_EQ(0, left[0]);
+	EXPECT_EQ(255, right[0]);
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+
+	glDeleteBuffers(2, buffers);
+	glDeleteProgram(feedbackProgram);
+	glDeleteProgram(program);
+
+	uninitializeContext();
+}
+
+// A sync object issued after a slow draw call starts out unsignaled, times out when
+// waited on briefly, and gets signaled once the draw call completes. Deleting one
+// with draw calls in flight mustn't wait for them.
+TEST_F(SwiftShaderTest, FenceSync)
+{
+	initializeContext(3);
+
+	const char *vertexSource =
+		"#version 300 es\n"
+		"in vec4 position;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = position;\n"
+		"}\n";
+
+	const char *fragmentSource =
+		"#version 300 es\n"
+		"precision highp float;\n"
+		"uniform int iterations;\n"
+		"out vec4 fragColor;\n"
+		"void main()\n"
+		"{\n"
+		"	float x = gl_FragCoord.x;\n"
+		"	for(int i = 0; i < iterations; i++)\n"
+		"	{\n"
+		"		x = fract(x * 1.5 + 0.25);\n"
+		"	}\n"
+		"	fragColor = vec4(x);\n"
+		"}\n";
+
+	GLuint program = createProgram(vertexSource, fragmentSource);
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "iterations"), 20000);
+
+	const GLfloat vertices[] =
+	{
+		-1.0f, -1.0f, 0.0f, 1.0f,
+		 3.0f, -1.0f, 0.0f, 1.0f,
+		-1.0f,  3.0f, 0.0f, 1.0f,
+	};
+
+	GLint position = glGetAttribLocation(program, "position");
+	glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, vertices);
+	glEnableVertexAttribArray(position);
+
+	auto status = [](GLsync sync)
+	{
+		GLint value = 0;
+		glGetSynciv(sync, GL_SYNC_STATUS, 1, nullptr, &value);
+
+		return value;
+	};
+
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	EXPECT_EQ(GL_UNSIGNALED, status(sync));
+
+	EXPECT_EQ((GLenum)GL_TIMEOUT_EXPIRED, glClientWaitSync(sync, 0, 0));
+	EXPECT_EQ((GLenum)GL_TIMEOUT_EXPIRED, glClientWaitSync(sync, 0, 1000000));   // 1 ms
+	EXPECT_EQ(GL_UNSIGNALED, status(sync));
+
+	EXPECT_EQ((GLenum)GL_CONDITION_SATISFIED, glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 60000000000ull));
+	EXPECT_EQ(GL_SIGNALED, status(sync));
+	EXPECT_EQ((GLenum)GL_ALREADY_SIGNALED, glClientWaitSync(sync, 0, 0));
+
+	glDeleteSync(sync);
+
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	GLsync deleted = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glDeleteSync(deleted);
+
+	sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	EXPECT_EQ(GL_UNSIGNALED, status(sync));   // The draw call is still in flight
+
+	glFinish();
+	EXPECT_EQ(GL_SIGNALED, status(sync));
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+
+	glDeleteSync(sync);
+	glDeleteProgram(program);
+
+	uninitializeContext();
+}
+
+// Timer query results are available once the draw calls they measure have completed,
+// and the extension's enums are rejected when a context doesn't expose it
+TEST_F(SwiftShaderTest, TimerQueries)
+{
+	initializeContext(2);
+
+	EXPECT_THAT((const char*)glGetString(GL_EXTENSIONS), testing::HasSubstr("GL_EXT_disjoint_timer_query"));
+
+	const char *vertexSource =
+		"attribute vec4 position;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = position;\n"
+		"}\n";
+
+	const char *fragmentSource =
+		"precision mediump float;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);\n"
+		"}\n";
+
+	GLuint program = createProgram(vertexSource, fragmentSource);
+	glUseProgram(program);
+
+	const GLfloat vertices[] =
+	{
+		-1.0f, -1.0f, 0.0f, 1.0f,
+		 3.0f, -1.0f, 0.0f, 1.0f,
+		-1.0f,  3.0f, 0.0f, 1.0f,
+	};
+
+	GLint position = glGetAttribLocation(program, "position");
+	glVertexAttribPointer(position, 4, GL_FLOAT, GL_FALSE, 0, vertices);
+	glEnableVertexAttribArray(position);
+
+	GLint bits = 0;
+	glGetQueryivEXT(GL_TIME_ELAPSED_EXT, GL_QUERY_COUNTER_BITS_EXT, &bits);
+	EXPECT_EQ(64, bits);
+	glGetQueryivEXT(GL_TIMESTAMP_EXT, GL_QUERY_COUNTER_BITS_EXT, &bits);
+	EXPECT_EQ(64, bits);
+
+	GLint disjoint = -1;
+	glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+	EXPECT_EQ(0, disjoint);
+
+	GLint64 before = 0;
+	glGetInteger64vEXT(GL_TIMESTAMP_EXT, &before);
+	EXPECT_GT(before, 0);
+
+	GLuint queries[3];   // Timestamp, time elapsed, timestamp
+	glGenQueriesEXT(3, queries);
+
+	glQueryCounterEXT(queries[0], GL_TIMESTAMP_EXT);
+	glBeginQueryEXT(GL_TIME_ELAPSED_EXT, queries[1]);
+
+	for(int i = 0; i < 16; i++)
+	{
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	glEndQueryEXT(GL_TIME_ELAPSED_EXT);
+	glQueryCounterEXT(queries[2], GL_TIMESTAMP_EXT);
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+
+	glFinish();
+
+	GLuint64 results[3] = {};
+
+	for(int i = 0; i < 3; i++)
+	{
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuivEXT(queries[i], GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+		EXPECT_EQ((GLuint)GL_TRUE, available);
+
+		glGetQueryObjectui64vEXT(queries[i], GL_QUERY_RESULT_EXT, &results[i]);
+		EXPECT_GT(results[i], 0u);
+	}
+
+	GLint64 after = 0;
+	glGetInteger64vEXT(GL_TIMESTAMP_EXT, &after);
+
+	EXPECT_LE((GLuint64)before, results[0]);
+	EXPECT_LT(results[0], results[2]);
+	EXPECT_LE(results[2], (GLuint64)after);
+	EXPECT_LE(results[1], results[2] - results[0]);   // The draw calls ran between the timestamps
+
+	glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+	EXPECT_EQ(0, disjoint);
+	EXPECT_EQ((GLenum)GL_NO_ERROR, glGetError());
+
+	glDeleteQueriesEXT(3, queries);
+	glDeleteProgram(program);
+
+	uninitializeContext();
+
+	#if defined(_WIN32)
+		_putenv_s("SWIFTSHADER_DISABLE_TIMER_QUERIES", "1");
+	#else
+		setenv("SWIFTSHADER_DISABLE_TIMER_QUERIES", "1", 1);
+	#endif
+
+	initializeContext(2);
+
+	#if defined(_WIN32)
+		_putenv_s("SWIFTSHADER_DISABLE_TIMER_QUERIES", "");
+	#else
+		unsetenv("SWIFTSHADER_DISABLE_TIMER_QUERIES");
+	#endif
+
+	EXPECT_THAT((const char*)glGetString(GL_EXTENSIONS), testing::Not(testing::HasSubstr("GL_EXT_disjoint_timer_query")));
+	EXPECT_THAT((const char*)glGetString(GL_EXTENSIONS), testing::HasSubstr("GL_EXT_occlusion_query_boolean"));
+
+	GLuint query = 0;
+	glGenQueriesEXT(1, &query);
+
+	glBeginQueryEXT(GL_TIME_ELAPSED_EXT, query);
+	EXPECT_EQ((GLenum)GL_INVALID_ENUM, glGetError());
+	glEndQueryEXT(GL_TIME_ELAPSED_EXT);
+	EXPECT_EQ((GLenum)GL_INVALID_ENUM, glGetError());
+	glQueryCounterEXT(query, GL_TIMESTAMP_EXT);
+	EXPECT_EQ((GLenum)GL_INVALID_ENUM, glGetError());
+
+	bits = -1;
+	glGetQueryivEXT(GL_TIMESTAMP_EXT, GL_QUERY_COUNTER_BITS_EXT, &bits);
+	EXPECT_EQ((GLenum)GL_INVALID_ENUM, glGetError());
+	EXPECT_EQ(-1, bits);
+
+	disjoint = -1;
+	glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+	EXPECT_EQ((GLenum)GL_INVALID_ENUM, glGetError());
+	EXPECT_EQ(-1, disjoint);
+
+	GLint64 timestamp = -1;
+	glGetInteger64vEXT(GL_TIMESTAMP_EXT, &timestamp);
+	EXPECT_EQ((GLenum)GL_INVALID_ENUM, glGetError());
+	EXPECT_EQ(-1, timestamp);
+
+	glDeleteQueriesEXT(1, &query);
+
+	uninitializeContext();
+}